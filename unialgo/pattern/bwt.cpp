@@ -1,22 +1,31 @@
 #include "unialgo/pattern/bwt.hpp"
 
+#include <algorithm>  // std::min
+#include <vector>     // std::vector
+
 #include "unialgo/pattern/suffixArray.hpp"
 #include "unialgo/pattern/wordVecMatching.hpp"  // unialgo::StringToBitVector
 
 namespace unialgo {
 namespace pattern {
 
-Bwt::Bwt(const unialgo::utils::WordVector& text,
-         unialgo::utils::WordVector sa) {
-  // turn sa into bwt vector in place
-  // first element is always the one preceding $ (or smallest in lex order -> 0)
-  sa[0] = text[text.size() - 2].getValue();
+template <typename Occ>
+BasicBwt<Occ>::BasicBwt(const unialgo::utils::WordVector& text,
+                        unialgo::utils::WordVector sa) {
+  // turn sa into bwt vector in place, a block of sa at a time
   // bwt[i] = text[sa[i] - 1]
-  for (std::size_t i = 1; i < text.size(); ++i) {
-    if (sa[i] > 0) sa[i] = text[sa[i] - 1].getValue();
+  std::vector<uint64_t> block(std::min<std::size_t>(text.size(), 4096));
+  for (std::size_t start = 0; start < text.size(); start += block.size()) {
+    std::size_t count = std::min(block.size(), text.size() - start);
+    sa.decode(start, count, block.data());
+    for (std::size_t i = 0; i < count; ++i)
+      if (block[i] > 0) block[i] = text[block[i] - 1].getValue();
+    sa.encode(start, block.data(), count);
   }
+  // first element is always the one preceding $ (or smallest in lex order -> 0)
+  sa[0] = text[text.size() - 2].getValue();
   // wavelet matrix of bwt
-  occ_ = unialgo::utils::WaveletMatrix(sa);
+  occ_ = Occ(sa);
 
   // store # values < c forall c (expressable over wordvec.wordsize)
   uint64_t value = 0;
@@ -28,34 +37,47 @@ Bwt::Bwt(const unialgo::utils::WordVector& text,
   }
 }
 
-Bwt::Bwt(const unialgo::utils::WordVector& text) {
+template <typename Occ>
+BasicBwt<Occ>::BasicBwt(const unialgo::utils::WordVector& text) {
   // return sa (sa[i] index where the i-th suffix start)
   unialgo::utils::WordVector sa = unialgo::pattern::makeSuffixArray(text);
-  *this = Bwt(text, sa);
+  *this = BasicBwt(text, sa);
 }
 
-Bwt::Bwt(const std::string& text) {
+template <typename Occ>
+BasicBwt<Occ>::BasicBwt(const std::string& text) {
   // return sa (sa[i] index where the i-th suffix start)
   // unialgo::utils::WordVector sa = unialgo::pattern::makeSuffixArray(text);
   auto text_wv = unialgo::pattern::StringToBitVector(text);
   unialgo::utils::WordVector sa =
       unialgo::pattern::suffix_array_from_string(text);
-  *this = Bwt(text_wv, sa);
+  *this = BasicBwt(text_wv, sa);
 }
 
-std::size_t Bwt::getWordSize() const { return occ_.getMatrixDepth() - 1; }
+template <typename Occ>
+std::size_t BasicBwt<Occ>::getWordSize() const {
+  return occ_.getMatrixDepth() - 1;
+}
 
-uint64_t Bwt::operator[](std::size_t pos) const { return occ_.acces(pos); }
+template <typename Occ>
+uint64_t BasicBwt<Occ>::operator[](std::size_t pos) const {
+  return occ_.acces(pos);
+}
 
-uint64_t Bwt::at(std::size_t pos) const {
+template <typename Occ>
+uint64_t BasicBwt<Occ>::at(std::size_t pos) const {
   assert(pos < occ_.getStringSize() && "Bwt access out of bound .at()");
   return occ_.acces(pos);
 }
 
-std::size_t Bwt::size() const { return occ_.getStringSize(); }
+template <typename Occ>
+std::size_t BasicBwt<Occ>::size() const {
+  return occ_.getStringSize();
+}
 
-std::pair<std::size_t, std::size_t> Bwt::backward_extend(uint64_t b, uint64_t e,
-                                                         uint64_t sigma) const {
+template <typename Occ>
+std::pair<std::size_t, std::size_t> BasicBwt<Occ>::backward_extend(
+    uint64_t b, uint64_t e, uint64_t sigma) const {
   std::size_t b1 = c_.at(sigma);
   if (b > 0) b1 += occ_.rank(sigma, b - 1);
   std::size_t e1 = c_.at(sigma);
@@ -63,27 +85,44 @@ std::pair<std::size_t, std::size_t> Bwt::backward_extend(uint64_t b, uint64_t e,
   return std::make_pair(b1, e1);
 }
 
-std::vector<std::size_t> Bwt::searchPattern(
+template <typename Occ>
+std::pair<std::size_t, std::size_t> BasicBwt<Occ>::interval(
     const unialgo::utils::WordVector& pattern) const {
-  std::size_t end = pattern.size();
-  if (end == 0) return std::vector<std::size_t>{};
+  if (pattern.size() == 0) return {0, 0};
+  // the empty pattern is a prefix of every suffix
   std::size_t start = 0;
+  std::size_t end = occ_.getStringSize();
   std::size_t j = 0;
   while (j < pattern.size()) {
     uint64_t sigma = pattern[pattern.size() - 1 - j];
-    auto interval = backward_extend(start, end, sigma);
-    start = interval.first;
-    end = interval.second;
+    auto extended = backward_extend(start, end, sigma);
+    start = extended.first;
+    end = extended.second;
     ++j;
     // interval not valid
-    if (start == end) return std::vector<std::size_t>{};
+    if (start == end) return {0, 0};
   }
+  return {start, end};
+}
+
+template <typename Occ>
+std::vector<std::size_t> BasicBwt<Occ>::searchPattern(
+    const unialgo::utils::WordVector& pattern) const {
+  auto [start, end] = interval(pattern);
   std::vector<std::size_t> res;
   for (std::size_t i = start; i < end; ++i) res.push_back(i);
   return res;
 }
 
-std::vector<std::size_t> Bwt::searchPattern(
+template <typename Occ>
+std::size_t BasicBwt<Occ>::count(
+    const unialgo::utils::WordVector& pattern) const {
+  auto [start, end] = interval(pattern);
+  return end - start;
+}
+
+template <typename Occ>
+std::vector<std::size_t> BasicBwt<Occ>::searchPattern(
     const unialgo::utils::WordVector& pattern,
     const unialgo::utils::WordVector& sa) const {
   std::vector<std::size_t> positions = (*this).searchPattern(pattern);
@@ -94,5 +133,10 @@ std::vector<std::size_t> Bwt::searchPattern(
   return res;
 }
 
+// instantiations for the available occurrence structures
+template class BasicBwt<unialgo::utils::WaveletMatrix>;
+template class BasicBwt<unialgo::utils::InterleavedWaveletMatrix>;
+template class BasicBwt<unialgo::utils::HuffmanWaveletMatrix>;
+
 }  // namespace pattern
 }  // namespace unialgo
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <unordered_map>  // std::unordered_map
 
 #include "unialgo/utils/bitvector/wordVector.hpp"
+#include "unialgo/utils/huffmanWaveletMatrix.hpp"
 #include "unialgo/utils/waveletMatrix.hpp"
 
 namespace unialgo {
@@ -16,8 +17,13 @@ namespace pattern {
  * @paragraph FM-index saves memory, the occ_ matrix is a waveletMatrix saves
  * space and query is consant (log_2 on size of alphabet)
  *
+ * @tparam Occ wavelet structure used for rank(value, position), the rank
+ * support is chosen through it (ex: utils::InterleavedWaveletMatrix,
+ * utils::HuffmanWaveletMatrix for skewed texts)
+ *
  */
-class Bwt {
+template <typename Occ>
+class BasicBwt {
  public:
   /**
    * @brief Construct a new Bwt object from a string text
@@ -28,7 +34,7 @@ class Bwt {
    *
    * @param text string of text to construct bwt from
    */
-  Bwt(const std::string& text);
+  BasicBwt(const std::string& text);
 
   /**
    * @brief Construct a new Bwt object
@@ -37,7 +43,7 @@ class Bwt {
    *
    * @param text WordVector to construct btw from
    */
-  Bwt(const unialgo::utils::WordVector& text);
+  BasicBwt(const unialgo::utils::WordVector& text);
 
   /**
    * @brief Construct a new Bwt object
@@ -47,7 +53,8 @@ class Bwt {
    * @param text WordVector to construct btw from
    * @param sa suffix array of text
    */
-  Bwt(const unialgo::utils::WordVector& text, unialgo::utils::WordVector sa);
+  BasicBwt(const unialgo::utils::WordVector& text,
+           unialgo::utils::WordVector sa);
 
   /**
    * @brief Returns Bwt[pos]
@@ -92,6 +99,16 @@ class Bwt {
       const unialgo::utils::WordVector& pattern,
       const unialgo::utils::WordVector& sa) const;
 
+  /**
+   * @brief Number of occurrences of pattern in the text
+   *
+   * @attention Time complexity: O(|pattern| * log(|alphabet|))
+   *
+   * @param pattern pattern to search
+   * @return std::size_t # of positions where pattern starts
+   */
+  std::size_t count(const unialgo::utils::WordVector& pattern) const;
+
   /**
    * @brief Get the Word Size of WordVector text
    *
@@ -120,11 +137,21 @@ class Bwt {
   std::pair<std::size_t, std::size_t> backward_extend(uint64_t b, uint64_t e,
                                                       uint64_t sigma) const;
 
+  /**
+   * @brief Suffix Array interval [b, e) of the suffixes starting with
+   * pattern (b == e if there is none)
+   */
+  std::pair<std::size_t, std::size_t> interval(
+      const unialgo::utils::WordVector& pattern) const;
+
   std::unordered_map<uint64_t, std::size_t> c_;  // stores #values < key
-  unialgo::utils::WaveletMatrix
-      occ_;  // data structure for rank(value, position)
+  Occ occ_;  // data structure for rank(value, position)
 };
 
+using Bwt = BasicBwt<unialgo::utils::WaveletMatrix>;
+// occurrences in a Huffman-shaped matrix, about H0 bits per symbol
+using HuffmanBwt = BasicBwt<unialgo::utils::HuffmanWaveletMatrix>;
+
 }  // namespace pattern
 }  // namespace unialgo
 
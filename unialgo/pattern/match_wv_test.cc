@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <cassert>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -35,6 +36,13 @@ TEST(AlphabetTesting, getUniqueChars) {
   EXPECT_TRUE(!uniques.contains('f'));
 }
 
+TEST(AlphabetTesting, charNotInAlphabet) {
+  auto alphabet = unialgo::pattern::GetAlphabet("abc");
+  EXPECT_THROW(unialgo::pattern::StringToBitVector("abd", alphabet),
+               std::out_of_range);
+  EXPECT_EQ(unialgo::pattern::StringToBitVector("cab", alphabet)[0], 2);
+}
+
 TEST(FinateStateAutomataTestWV, fsaOnWordVector) {
   // Test case 1: Pattern occurs multiple times in the text
   std::string text1 = "abababcabab";
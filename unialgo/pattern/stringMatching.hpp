@@ -227,21 +227,20 @@ std::vector<std::size_t> Byg(T& t, T& p) {
     table[p[i]][p.size() - i - 1] = 1;
   }
 
-  // search
+  // search, bv is updated in place (no temporaries per text character)
   std::vector<std::size_t> occ;
   unialgo::utils::Bitvector bv(p.size());
-  unialgo::utils::Bitvector zeros(p.size());
   for (std::size_t i = 0; i < t.size(); ++i) {
-    auto sigma = t[i];
-    if (table.contains(sigma)) {
+    auto entry = table.find(t[i]);
+    if (entry != table.end()) {
       // bv = RSHIFT1(bv) and table[sigma]:
-      bv >= 1;
-      bv[p.size() - 1] = 1;
-      bv &= table[sigma];
-      if (bv[0] == 1) occ.push_back(i - p.size() + 1);
+      bv >>= 1;
+      bv.SetBit(p.size() - 1);
+      bv &= entry->second;
+      if (bv.GetBit(0)) occ.push_back(i - p.size() + 1);
 
     } else {
-      bv &= zeros;
+      bv.Reset();
     }
   }
   return occ;
@@ -1,19 +1,211 @@
 #include "unialgo/pattern/suffixArray.hpp"
 
-#include <algorithm>  // std::sort
+#include <algorithm>  // std::fill, std::sort, std::lower_bound
 #include <cassert>    // assert
-#include <cmath>      // std::log, std::ceil
+#include <limits>     // std::numeric_limits
 #include <string>     // std::string
-
-#include "unialgo/pattern/wordVecMatching.hpp"  // unialgo::StringToBitVector
+#include <vector>     // std::vector
 
 namespace unialgo {
 namespace pattern {
+
+namespace {
+// ==== SA-IS ====
+
+/**
+ * @brief Sets bkt[c] to the first (or one past the last) position of the
+ * bucket of c in the suffix array
+ */
+template <typename Index>
+void bucket_bounds(const std::vector<Index>& counts, std::vector<Index>& bkt,
+                   bool ends) {
+  Index sum = 0;
+  for (std::size_t c = 0; c < counts.size(); ++c) {
+    sum += counts[c];
+    bkt[c] = ends ? sum : sum - counts[c];
+  }
+}
+
+/**
+ * @brief Induces the order of the L-type suffixes from the LMS suffixes at
+ * the end of their buckets, then the order of the S-type suffixes from the
+ * L-type ones
+ */
+template <typename Char, typename Index>
+void induce(const Char* text, Index* sa, Index n,
+            const std::vector<bool>& stype, const std::vector<Index>& counts,
+            std::vector<Index>& bkt) {
+  constexpr Index empty = std::numeric_limits<Index>::max();
+  bucket_bounds(counts, bkt, false);
+  // the virtual sentinel is the smallest suffix, the one before it is L
+  sa[bkt[text[n - 1]]++] = n - 1;
+  for (Index i = 0; i < n; ++i) {
+    Index j = sa[i];
+    if (j != empty && j > 0 && !stype[j - 1]) sa[bkt[text[j - 1]]++] = j - 1;
+  }
+  bucket_bounds(counts, bkt, true);
+  for (Index i = n; i-- > 0;) {
+    Index j = sa[i];
+    if (j != empty && j > 0 && stype[j - 1]) sa[--bkt[text[j - 1]]] = j - 1;
+  }
+}
+
+/**
+ * @brief Suffix array of text[0, n) with values in [0, k)
+ *
+ * Sorts the LMS substrings by induction, names them and sorts the reduced
+ * string of the names recursively (in the space of sa: the names are at
+ * most n / 2), then induces the whole suffix array from the sorted LMS
+ * suffixes
+ */
+template <typename Char, typename Index>
+void sais_rec(const Char* text, Index* sa, Index n, Index k) {
+  constexpr Index empty = std::numeric_limits<Index>::max();
+  if (n == 0) return;
+  if (n == 1) {
+    sa[0] = 0;
+    return;
+  }
+  // stype[i]: suffix i is smaller than suffix i + 1 (the last is L-type)
+  std::vector<bool> stype(n, false);
+  for (Index i = n - 1; i-- > 0;)
+    stype[i] = text[i] < text[i + 1] ||
+               (text[i] == text[i + 1] && stype[i + 1]);
+  auto is_lms = [&](Index i) {
+    return i == n || (i > 0 && stype[i] && !stype[i - 1]);
+  };
+  std::vector<Index> counts(k, 0);
+  std::vector<Index> bkt(k);
+  for (Index i = 0; i < n; ++i) ++counts[text[i]];
+
+  // sort the LMS substrings: LMS at the end of their buckets, then induce
+  std::fill(sa, sa + n, empty);
+  bucket_bounds(counts, bkt, true);
+  for (Index i = 1; i < n; ++i)
+    if (is_lms(i)) sa[--bkt[text[i]]] = i;
+  induce(text, sa, n, stype, counts, bkt);
+
+  // sorted LMS substrings to the front, their names in sa[n1 + pos / 2]
+  Index n1 = 0;
+  for (Index i = 0; i < n; ++i)
+    if (is_lms(sa[i])) sa[n1++] = sa[i];
+  std::fill(sa + n1, sa + n, empty);
+  auto same_substring = [&](Index a, Index b) {
+    for (Index d = 0;; ++d) {
+      // the virtual sentinel is unique
+      if (a + d == n || b + d == n) return false;
+      if (text[a + d] != text[b + d] || stype[a + d] != stype[b + d])
+        return false;
+      if (d > 0 && (is_lms(a + d) || is_lms(b + d)))
+        return is_lms(a + d) && is_lms(b + d);
+    }
+  };
+  Index names = 0;
+  for (Index i = 0; i < n1; ++i) {
+    if (i == 0 || !same_substring(sa[i - 1], sa[i])) ++names;
+    sa[n1 + sa[i] / 2] = names - 1;
+  }
+  // reduced string (names in text order) at the end of sa
+  for (Index i = n, j = n; i-- > n1;)
+    if (sa[i] != empty) sa[--j] = sa[i];
+  Index* reduced = sa + n - n1;
+
+  // suffix array of the reduced string in sa[0, n1)
+  if (names < n1)
+    sais_rec<Index, Index>(reduced, sa, n1, names);
+  else
+    for (Index i = 0; i < n1; ++i) sa[reduced[i]] = i;
+
+  // sorted LMS suffixes to the end of their buckets, then induce
+  for (Index i = 1, j = 0; i < n; ++i)
+    if (is_lms(i)) reduced[j++] = i;
+  for (Index i = 0; i < n1; ++i) sa[i] = reduced[sa[i]];
+  std::fill(sa + n1, sa + n, empty);
+  bucket_bounds(counts, bkt, true);
+  for (Index i = n1; i-- > 0;) {
+    Index j = sa[i];
+    sa[i] = empty;
+    sa[--bkt[text[j]]] = j;
+  }
+  induce(text, sa, n, stype, counts, bkt);
+}
+
+/**
+ * @brief Packs the positions of a suffix array in ceil(log(n)) bits each
+ */
+template <typename Index>
+utils::WordVector pack_positions(const std::vector<Index>& sa) {
+  const std::size_t n = sa.size();
+  utils::WordVector res(n, n > 1 ? utils::get_log_2(n) : 1);
+  res.encode(0, sa.data(), n);
+  return res;
+}
+
+/**
+ * @brief Suffix array of text with Index positions (packed at the end)
+ */
+template <typename Index>
+utils::WordVector sais_words(const utils::WordVector& text) {
+  const std::size_t n = text.size();
+  std::vector<Index> sa(n);
+  const std::size_t block = 4096;  // values decoded at a time
+  std::vector<uint64_t> values(std::min(n, block));
+  if (text.getWordSize() <= 8) {
+    // bytes: n bytes of working text
+    std::vector<uint8_t> bytes(n);
+    for (std::size_t start = 0; start < n; start += block) {
+      std::size_t count = std::min(block, n - start);
+      text.decode(start, count, values.data());
+      for (std::size_t i = 0; i < count; ++i) bytes[start + i] = values[i];
+    }
+    sais(bytes.data(), sa.data(), n);
+  } else {
+    // wider words: values remapped to their rank among the distinct ones
+    // when they do not fit buckets of n entries
+    values.resize(n);
+    text.decode(0, n, values.data());
+    uint64_t max = n ? *std::max_element(values.begin(), values.end()) : 0;
+    std::vector<Index> codes(n);
+    std::size_t k = max + 1;
+    if (max >= n) {
+      std::vector<uint64_t> alphabet = values;
+      std::sort(alphabet.begin(), alphabet.end());
+      alphabet.erase(std::unique(alphabet.begin(), alphabet.end()),
+                     alphabet.end());
+      for (std::size_t i = 0; i < n; ++i)
+        codes[i] = std::lower_bound(alphabet.begin(), alphabet.end(),
+                                    values[i]) -
+                   alphabet.begin();
+      k = alphabet.size();
+    } else {
+      for (std::size_t i = 0; i < n; ++i) codes[i] = values[i];
+    }
+    std::vector<uint64_t>().swap(values);
+    sais_rec<Index, Index>(codes.data(), sa.data(), n, k);
+  }
+  return pack_positions(sa);
+}
+}  // namespace
+
+template <typename Index>
+void sais(const uint8_t* text, Index* sa, std::size_t n) {
+  assert(n < std::numeric_limits<Index>::max() &&
+         "text too long for the index type");
+  sais_rec<uint8_t, Index>(text, sa, n, 256);
+}
+
+template void sais<uint32_t>(const uint8_t*, uint32_t*, std::size_t);
+template void sais<uint64_t>(const uint8_t*, uint64_t*, std::size_t);
+
+utils::WordVector sais(const utils::WordVector& text) {
+  if (text.size() < std::numeric_limits<uint32_t>::max())
+    return sais_words<uint32_t>(text);
+  return sais_words<uint64_t>(text);
+}
+
 // ==== SuffixArray implementation ====
 
 utils::WordVector makeSuffixArray(const utils::WordVector& vw) {
-  unialgo::utils::WordVector sa;
-
   auto last_el = vw[vw.size() - 1];
   for (std::size_t i = 0; i < vw.size() - 1; ++i) {
     if (vw[i] < last_el || vw[i] == last_el) {
@@ -23,44 +215,21 @@ utils::WordVector makeSuffixArray(const utils::WordVector& vw) {
              "SuffixArray construction WordVector is not $-terminated");
     }
   }
-  // initialize sa_ with min wordSize required to store indexes
-  const std::size_t wordSize = std::ceil(std::log(vw.size()) / std::log(2));
-  sa = unialgo::utils::WordVector(vw.size(), wordSize);
-
-  // fill sa_ with indexes first element is always the $-suffix
-  sa[0] = vw.size() - 1;
-  for (std::size_t i = 1; i < sa.size(); ++i) {
-    sa[i] = i - 1;
-  }
-
-  // create lambda to compare suffix a and b
-  auto cmp = [&vw](unialgo::utils::WordVectorReference::value_type a,
-                   unialgo::utils::WordVectorReference::value_type b) {
-    std::size_t a_pos = a;
-    std::size_t b_pos = b;
-    while (a_pos < vw.size() && b_pos < vw.size() && vw[a_pos] == vw[b_pos]) {
-      ++a_pos;
-      ++b_pos;
-    }
-    // this are not needed for the proprety of the $ terminated vw
-    // if (a_pos >= vw.size()) return true;
-    // if (b_pos >= vw.size()) return false;
-    return vw[a_pos] < vw[b_pos];
-  };
-  // order sa_ based on alph. order on suffixes
-  std::sort(sa.begin(), sa.end(), cmp);
-  return sa;
+  // the $ is the smallest suffix: same order of the virtual sentinel
+  return sais(vw);
 }
 
 utils::WordVector suffix_array_from_string(const std::string& s) {
-  std::string s1 = s + "$$$";
-  auto s1_word_wv = unialgo::pattern::StringToBitVector(s1);
-  unialgo::utils::WordVector sa(s.size(), unialgo::utils::get_log_2(s.size()));
-  std::size_t max_values_in_string = (1 << (s1_word_wv.getWordSize() + 1)) - 1;
-  unialgo::pattern::make_suffix_array(s1_word_wv, sa, s.size(),
-                                      max_values_in_string);
-  return sa;
+  const auto* bytes = reinterpret_cast<const uint8_t*>(s.data());
+  if (s.size() < std::numeric_limits<uint32_t>::max()) {
+    std::vector<uint32_t> sa(s.size());
+    sais(bytes, sa.data(), s.size());
+    return pack_positions(sa);
+  }
+  std::vector<uint64_t> sa(s.size());
+  sais(bytes, sa.data(), s.size());
+  return pack_positions(sa);
 }
 
 }  // namespace pattern
-}  // namespace unialgo
\ No newline at end of file
+}  // namespace unialgo
@@ -1,16 +1,22 @@
 #ifndef UNIALGO_PATTERN_SUFFIXARRAY_
 #define UNIALGO_PATTERN_SUFFIXARRAY_
 
+#include <stdint.h>  // uint64_t
+
 #include <string>  // std::string
+#include <vector>  // std::vector
 
+#include "unialgo/utils/bitvector/builders.hpp"
 #include "unialgo/utils/bitvector/wordVector.hpp"
+#include "unialgo/utils/bitvector/wordVectorSort.hpp"
 
 /**
  * @brief Function to create suffix array from WordVector
  * \file suffixArray.hpp
  *
- *  suffix array creation is not linear yet (not the best implementation beside
- *  the scope of the project)
+ *  makeSuffixArray and suffix_array_from_string build the suffix array in
+ *  linear time with SA-IS (induced sorting), make_suffix_array is the DC3
+ *  construction
  *
  */
 
@@ -42,6 +48,36 @@ utils::WordVector makeSuffixArray(const utils::WordVector& vw);
  */
 utils::WordVector suffix_array_from_string(const std::string& s);
 
+/**
+ * @brief Suffix array of text[0, n) with SA-IS (induced sorting)
+ *
+ * @details time complexity: O(n). From the paper: "Two Efficient Algorithms
+ * for Linear Time Suffix Array Construction" by Ge Nong, Sen Zhang and Wai
+ * Hong Chan. The end of the text is a virtual sentinel smaller than every
+ * byte, so text does not need a terminator. Working memory on top of sa is
+ * n bits of suffix types and the buckets: the reduced problem of the
+ * recursion is stored in sa itself.
+ *
+ * @tparam Index type of the positions: uint32_t (n < 2^32 - 1, half the
+ * memory) or uint64_t
+ * @param text bytes to sort the suffixes of
+ * @param sa n positions, sa[i] = start of the i-th smallest suffix
+ * @param n size of text
+ */
+template <typename Index>
+void sais(const uint8_t* text, Index* sa, std::size_t n);
+
+/**
+ * @brief Suffix array of a WordVector with SA-IS
+ *
+ * Positions are 32-bit while sorting when text.size() < 2^32 - 1, the result
+ * is packed in ceil(log(n)) bits per position
+ *
+ * @param text text to sort the suffixes of (no terminator needed)
+ * @return utils::WordVector sa (sa[i] index where the i-th suffix start)
+ */
+utils::WordVector sais(const utils::WordVector& text);
+
 /**
  * @brief Check lexicographic order for pairs
  *
@@ -68,29 +104,41 @@ inline bool lex_eq(wv_ref a1, wv_ref a2, wv_ref a3, wv_ref b1, wv_ref b2,
 }
 
 /**
- * @brief Stable sort of a[0...n-1] into b[0...n-1] with values in range 0...k
- * found inside r
- *
- * @param a positions to sort
- * @param b result of sorting
- * @param r keys inside here
- * @param n size of a and b arrays
- * @param offset is the offset for accessing r (i.e. if offset = 1 r[0] inside
- * the function will be r[0 + 1] from the caller)
+ * @brief Buffers shared by the radix passes of a make_suffix_array level
+ *
+ * The string is unpacked once per level, positions and keys are sized for
+ * the largest pass and the sorter keeps its own buffers between passes
  */
-inline void radix_pass(utils::WordVector& a, utils::WordVector& b,
-                       utils::WordVector& r, std::size_t n, std::size_t k,
-                       int offset = 0) {
-  utils::WordVector occ(k + 1, utils::get_log_2(n));
-  for (std::size_t i = 0; i < n; ++i)
-    occ[r[a[i] + offset]]++;                       // count occurrences
-  for (std::size_t i = 0, sum = 0; i <= k; ++i) {  // exclusive prefix sums
-    std::size_t t = occ[i];
-    occ[i] = sum;
-    sum += t;
+struct RadixPassBuffers {
+  RadixPassBuffers(const utils::WordVector& r, std::size_t n,
+                   std::size_t num_threads)
+      : text(r.size()), positions(n), keys(n), sorter(num_threads) {
+    r.decode(0, r.size(), text.data());
   }
+
+  std::vector<uint64_t> text;            // string unpacked
+  std::vector<uint64_t> positions;       // positions sorted by the passes
+  std::vector<uint64_t> keys;            // key of every position
+  utils::RadixSorter<uint64_t> sorter;  // sorter of all the passes
+};
+
+/**
+ * @brief Stable sort of buffers.positions[0...n-1] by their key in the
+ * string, with values in range 0...k
+ *
+ * @param buffers unpacked string and positions to sort
+ * @param n number of positions to sort
+ * @param k max value in the string
+ * @param offset is the offset for accessing the string (i.e. if offset = 1
+ * the key of position p is string[p + 1])
+ */
+inline void radix_pass(RadixPassBuffers& buffers, std::size_t n,
+                       std::size_t k, int offset = 0) {
+  if (n == 0) return;
   for (std::size_t i = 0; i < n; ++i)
-    b[occ[r[a[i] + offset]]++] = a[i];  // sort
+    buffers.keys[i] = buffers.text[buffers.positions[i] + offset];
+  buffers.sorter.sort(buffers.keys.data(), buffers.positions.data(), n,
+                      utils::get_log_2(k + 1));
 }
 
 /**
@@ -105,37 +153,37 @@ inline void radix_pass(utils::WordVector& a, utils::WordVector& b,
  * @param suffix_array reference to suffix array
  * @param n size of original string (not including s[n], s[n + 1] ...)
  * @param K range of values in string ((1 << (string.getWordSize() + 1)) - 1)
+ * @param num_threads max number of threads used by the radix sorts
  */
 inline void make_suffix_array(utils::WordVector& string,
                               utils::WordVector& suffix_array, std::size_t n,
-                              std::size_t K) {
+                              std::size_t K, std::size_t num_threads = 1) {
   std::size_t n0 = (n + 2) / 3;
   std::size_t n1 = (n + 1) / 3;
   std::size_t n2 = (n) / 3;
   std::size_t n02 = n0 + n2;  // size for array prefix of mod 1, 2
 
-  // vector for suffix mod 1, 2
-  utils::WordVector suffix12(n02 + 3, utils::get_log_2(n));
-  suffix12[n02] = 0;
-  suffix12[n02 + 1] = 0;
-  suffix12[n02 + 2] = 0;
-  // suffix array of suffixes mod 1, 2
-  utils::WordVector sa12(n02 + 3, utils::get_log_2(n));
-  sa12[n02] = 0;
-  sa12[n02 + 1] = 0;
-  sa12[n02 + 2] = 0;
-  // suffix mod 0
-  utils::WordVector suffix0(n0, utils::get_log_2(n));
+  // vector for suffix mod 1, 2: the mod 1, 2 positions followed by 3 zeros
+  // (with n % 3 == 1 the dummy position n is included)
+  utils::WordVectorBuilder builder(utils::get_log_2(n + 1));
+  builder.reserve(n02 + 3);
+  for (std::size_t i = 0; i < n + (n0 - n1); i++)
+    if (i % 3 != 0) builder.push_back(i);
+  for (int i = 0; i < 3; ++i) builder.push_back(0);
+  utils::WordVector suffix12 = builder.build();
+  // suffix array of suffixes mod 1, 2 (zero initialized)
+  utils::WordVector sa12(n02 + 3, utils::get_log_2(n + 1));
   // suffix array for suffixes mod 0
   utils::WordVector sa0(n0, utils::get_log_2(n));
-  // generates the suffix mod 1, 2 positions
-  for (std::size_t i = 0, j = 0; i < n + (n0 - n1); i++)
-    if (i % 3 != 0) suffix12[j++] = i;
 
-  // lsb radix sort the mod 1 and mod 2 triples
-  radix_pass(suffix12, sa12, string, n02, K, 2);
-  radix_pass(sa12, suffix12, string, n02, K, 1);
-  radix_pass(suffix12, sa12, string, n02, K, 0);
+  // lsb radix sort the mod 1 and mod 2 triples, the positions stay unpacked
+  // between the passes
+  RadixPassBuffers buffers(string, n02, num_threads);
+  suffix12.decode(0, n02, buffers.positions.data());
+  radix_pass(buffers, n02, K, 2);
+  radix_pass(buffers, n02, K, 1);
+  radix_pass(buffers, n02, K, 0);
+  sa12.encode(0, buffers.positions.data(), n02);
 
   // find lexicographic names of triples
   int name = 0, c0 = -1, c1 = -1, c2 = -1;
@@ -157,7 +205,7 @@ inline void make_suffix_array(utils::WordVector& string,
 
   // recurse if names are not yet unique
   if (name < n02) {
-    make_suffix_array(suffix12, sa12, n02, name);
+    make_suffix_array(suffix12, sa12, n02, name, num_threads);
     // store unique names in s12 using the suffix array
     for (int i = 0; i < n02; i++) suffix12[sa12[i]] = i + 1;
   } else  // generate the suffix array of s12 directly
@@ -165,9 +213,10 @@ inline void make_suffix_array(utils::WordVector& string,
 
   // stably sort the mod 0 suffixes from SA12 by their first character
   for (int i = 0, j = 0; i < n02; i++)
-    if (sa12[i] < n0) suffix0[j++] = 3 * sa12[i];
+    if (sa12[i] < n0) buffers.positions[j++] = 3 * sa12[i];
 
-  radix_pass(suffix0, sa0, string, n0, K, 0);
+  radix_pass(buffers, n0, K, 0);
+  sa0.encode(0, buffers.positions.data(), n0);
 
   // merge sorted SA0 suffixes and sorted SA12 suffixes
   for (int p = 0, t = n0 - n1, k = 0; k < n; k++) {
@@ -1,12 +1,15 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>  // std::sort
+#include <random>     // std::mt19937
 #include <string>
 #include <vector>
 
 #include "unialgo/pattern/bwt.hpp"
 #include "unialgo/pattern/matchingAlgo.hpp"
 #include "unialgo/pattern/suffixArray.hpp"
+#include "unialgo/utils/queryExecutor.hpp"
+#include "unialgo/utils/threadPool.hpp"
 
 namespace {
 
@@ -118,6 +121,69 @@ TEST(SuffixArray, sa_from_string) {
   EXPECT_EQ(sa[10], 2);
 }
 
+// suffixes of text sorted by plain comparisons (the end of text is smaller
+// than every value)
+template <typename Text>
+std::vector<uint64_t> naiveSuffixArray(const Text& text, std::size_t n) {
+  std::vector<uint64_t> sa(n);
+  for (std::size_t i = 0; i < n; ++i) sa[i] = i;
+  std::sort(sa.begin(), sa.end(), [&](uint64_t a, uint64_t b) {
+    while (a < n && b < n && text[a] == text[b]) {
+      ++a;
+      ++b;
+    }
+    return b < n && (a == n || text[a] < text[b]);
+  });
+  return sa;
+}
+
+TEST(SuffixArray, sais) {
+  std::mt19937 gen(25);
+  for (std::size_t test = 0; test < 200; ++test) {
+    // small alphabets give long repeats and deep recursions
+    std::size_t n = gen() % 300;
+    std::size_t sigma = test % 5 == 0 ? 256 : 1 + test % 4;
+    std::vector<uint8_t> bytes(n);
+    for (auto& b : bytes) b = gen() % sigma;
+    std::vector<uint64_t> expected = naiveSuffixArray(bytes, n);
+
+    std::vector<uint32_t> sa32(n);
+    unialgo::pattern::sais(bytes.data(), sa32.data(), n);
+    std::vector<uint64_t> sa64(n);
+    unialgo::pattern::sais(bytes.data(), sa64.data(), n);
+    EXPECT_EQ(std::vector<uint64_t>(sa32.begin(), sa32.end()), expected);
+    EXPECT_EQ(sa64, expected);
+  }
+
+  // WordVectors of bytes, of small values and of values to remap
+  for (std::size_t word_size : {3, 12, 40}) {
+    std::size_t n = 2000;
+    unialgo::utils::WordVector wv(n, word_size);
+    for (std::size_t i = 0; i < n; ++i)
+      wv[i] = word_size == 40 ? (gen() % 3) << 35 : gen() % 3;
+    std::vector<uint64_t> expected = naiveSuffixArray(wv, n);
+    unialgo::utils::WordVector sa = unialgo::pattern::sais(wv);
+    ASSERT_EQ(sa.size(), n);
+    for (std::size_t i = 0; i < n; ++i) EXPECT_EQ(sa[i], expected[i]);
+  }
+}
+
+TEST(SuffixArray, dc3) {
+  std::mt19937 gen(12);
+  for (std::size_t test = 0; test < 100; ++test) {
+    // values in [1, sigma], the string is followed by three 0s
+    std::size_t n = 2 + gen() % 300;
+    std::size_t sigma = 1 + test % 4;
+    unialgo::utils::WordVector wv(n + 3, 3);
+    for (std::size_t i = 0; i < n; ++i) wv[i] = 1 + gen() % sigma;
+    std::vector<uint64_t> expected = naiveSuffixArray(wv, n);
+
+    unialgo::utils::WordVector sa(n, unialgo::utils::get_log_2(n));
+    unialgo::pattern::make_suffix_array(wv, sa, n, sigma, 1 + test % 2);
+    for (std::size_t i = 0; i < n; ++i) ASSERT_EQ(sa[i], expected[i]);
+  }
+}
+
 // ========== BWT ==========
 
 TEST(BWT, Creation) {
@@ -267,4 +333,81 @@ TEST(BWT, searchPatternNoExisting) {
   EXPECT_EQ(res.size(), 0);
 }
 
+TEST(BWT, searchPatternInterleavedRank) {
+  std::string text = "ggtcagtc$";
+  auto alph = unialgo::pattern::GetAlphabet(text);
+  unialgo::utils::WordVector wv =
+      unialgo::pattern::StringToBitVector(text, alph);
+
+  unialgo::pattern::BasicBwt<unialgo::utils::InterleavedWaveletMatrix> bwt(wv);
+  unialgo::pattern::Bwt expected(wv);
+  for (std::size_t i = 0; i < wv.size(); ++i) EXPECT_EQ(bwt[i], expected[i]);
+
+  auto sa = unialgo::pattern::makeSuffixArray(wv);
+  unialgo::utils::WordVector p =
+      unialgo::pattern::StringToBitVector(std::string("gtc"), alph);
+
+  std::vector<std::size_t> res = bwt.searchPattern(p, sa);
+  EXPECT_EQ(res.size(), 2);
+  EXPECT_EQ(res[0], 5);
+  EXPECT_EQ(res[1], 1);
+}
+
+TEST(BWT, searchPatternHuffman) {
+  std::string text = "aaaabaaacaaaabaaaadaaaabaaac$";
+  auto alph = unialgo::pattern::GetAlphabet(text);
+  unialgo::utils::WordVector wv =
+      unialgo::pattern::StringToBitVector(text, alph);
+
+  unialgo::pattern::HuffmanBwt bwt(wv);
+  unialgo::pattern::Bwt expected(wv);
+  EXPECT_EQ(bwt.size(), expected.size());
+  EXPECT_EQ(bwt.getWordSize(), expected.getWordSize());
+  for (std::size_t i = 0; i < wv.size(); ++i) EXPECT_EQ(bwt[i], expected[i]);
+
+  auto sa = unialgo::pattern::makeSuffixArray(wv);
+  for (std::string pattern : {"aab", "aaa", "c", "baaac", "d", "dc"}) {
+    unialgo::utils::WordVector p =
+        unialgo::pattern::StringToBitVector(pattern, alph);
+    EXPECT_EQ(bwt.searchPattern(p, sa), expected.searchPattern(p, sa));
+  }
+}
+
+TEST(BWT, count) {
+  std::mt19937 gen(22);
+  std::string text;
+  for (std::size_t i = 0; i < 3000; ++i) text.push_back("acgt"[gen() % 4]);
+  text.push_back('$');
+  auto alph = unialgo::pattern::GetAlphabet(text);
+  unialgo::utils::WordVector wv =
+      unialgo::pattern::StringToBitVector(text, alph);
+  unialgo::pattern::Bwt bwt(wv);
+
+  // patterns of the text and (likely) missing ones
+  std::vector<unialgo::utils::WordVector> patterns;
+  std::vector<std::string> strings;
+  for (std::size_t i = 0; i < 100; ++i) {
+    std::size_t len = 1 + gen() % 8;
+    std::string pattern = text.substr(gen() % (text.size() - 9), len);
+    if (i % 3 == 0)
+      for (char& c : pattern) c = "acgt"[gen() % 4];
+    patterns.push_back(unialgo::pattern::StringToBitVector(pattern, alph));
+    strings.push_back(pattern);
+  }
+
+  unialgo::utils::ThreadPool pool(4);
+  unialgo::utils::QueryExecutor<unialgo::pattern::Bwt> executor(bwt, pool);
+  std::vector<std::size_t> counts = executor.count(patterns);
+  EXPECT_EQ(counts.size(), patterns.size());
+  for (std::size_t i = 0; i < patterns.size(); ++i) {
+    // naive count of the (overlapping) occurrences in text
+    std::size_t expected = 0;
+    for (std::size_t j = 0; j + strings[i].size() <= text.size(); ++j)
+      if (text.compare(j, strings[i].size(), strings[i]) == 0) ++expected;
+    EXPECT_EQ(bwt.count(patterns[i]), expected);
+    EXPECT_EQ(bwt.count(patterns[i]), bwt.searchPattern(patterns[i]).size());
+    EXPECT_EQ(counts[i], bwt.count(patterns[i]));
+  }
+}
+
 }  // namespace
@@ -1,6 +1,8 @@
 #include "unialgo/pattern/wordVecMatching.hpp"
 
-#include <cmath>  //std::log, std::ceil
+#include <array>      // std::array
+#include <cmath>      //std::log, std::ceil
+#include <stdexcept>  // std::out_of_range
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -38,17 +40,28 @@ Alphabet GetAlphabet(std::string s) {
 }
 
 utils::WordVector StringToBitVector(std::string s, Alphabet alphabet) {
-  // compute minimum size bit to represent alphabet
+  // compute minimum size bit to represent alphabet (0 for |Sigma| <= 1)
   const std::size_t wordSize =
-      std::ceil(std::log(alphabet.size()) / std::log(2));
-  // creates wordVector with wordSize = log_2(|Sigma|), size = |s|
-  utils::WordVector wv(s.size(), wordSize);
-
-  for (std::size_t i = 0; i < s.size(); ++i) {
-    wv[i] = alphabet.at(s[i]);
+      alphabet.size() > 1
+          ? std::ceil(std::log(alphabet.size()) / std::log(2))
+          : 0;
+  // value of every char, looked up once per char instead of hashing
+  std::array<uint8_t, 256> codes{};
+  std::array<bool, 256> known{};
+  for (auto pair : alphabet) {
+    codes[static_cast<unsigned char>(pair.first)] = pair.second;
+    known[static_cast<unsigned char>(pair.first)] = true;
   }
 
-  return wv;
+  // packs wordSize = log_2(|Sigma|) bits per char, size = |s|
+  utils::WordVectorBuilder builder(wordSize);
+  builder.reserve(s.size());
+  for (char c : s) {
+    if (!known[static_cast<unsigned char>(c)])
+      throw std::out_of_range("unialgo: char not in alphabet");
+    builder.push_back(codes[static_cast<unsigned char>(c)]);
+  }
+  return builder.build();
 }
 
 utils::WordVector StringToBitVector(std::string s) {
@@ -57,6 +57,7 @@ utils::WordVector StringToBitVector(std::string s);
  * @param s string to convert
  * @param std::unordered_map<char, uint8_t> alphabet to use on convertion
  * @return utils::WordVector string s rapresented as bitVector
+ * @throws std::out_of_range if a char of s is not in alphabet
  */
 utils::WordVector StringToBitVector(std::string s, Alphabet alphabet);
 
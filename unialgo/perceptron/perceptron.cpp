@@ -7,17 +7,19 @@
 
 namespace unialgo {
 
-Perceptron::Perceptron(std::size_t inputSize) {
+Perceptron::Perceptron(std::size_t inputSize,
+                       const utils::AllocOptions &options) {
   input_size_ = inputSize;
   weight_vec_size_ = inputSize + 1;
-  weights_ = static_cast<weightType *>(
-      utils::aligned_alloc(weightSize, weightSize * weight_vec_size_));
+  options_ = options;
+  weights_ = static_cast<weightType *>(utils::aligned_alloc(
+      weightSize, weightSize * weight_vec_size_, options_));
   (*this).InitializeRandomWeights();
 }
 
 Perceptron::~Perceptron() {
   if (weights_ != nullptr) {
-    utils::aligned_free(weights_);
+    utils::aligned_free(weights_, weightSize * weight_vec_size_, options_);
     weights_ = nullptr;
   }
 }
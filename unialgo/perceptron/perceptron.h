@@ -27,8 +27,11 @@ class Perceptron {
    * @brief Construct a new Perceptron object
    *
    * @param inputSize size of input vector of perceptron
+   * @param options pages and NUMA placement of the weights (e.g. huge pages
+   * for big input vectors)
    */
-  explicit Perceptron(std::size_t inputSize);
+  explicit Perceptron(std::size_t inputSize,
+                      const utils::AllocOptions &options = {});
 
   /**
    * @brief Destroy the Perceptron object
@@ -184,6 +187,7 @@ class Perceptron {
   std::size_t weight_vec_size_;  // size of weights vector
   weightType
       *weights_;  // weights pointer (need to be aligned allocated for avx)
+  utils::AllocOptions options_;  // options weights_ is allocated with
 
   /**
    * @brief This function initialized the weights_ vector to random 64-bit
@@ -2,6 +2,7 @@
 #include <cstddef>  //std::size_t
 #include <iostream>
 #include <random>
+#include <sstream>
 
 #include "unialgo/perceptron/perceptron.h"
 #include "unialgo/utils/alignedAlloc.h"
@@ -139,7 +140,44 @@ void TestPerceptron(std::size_t train_set_size,
   unialgo::utils::aligned_free(test);
 }
 
+void TestPerceptronOptions() {
+  using unialgo::utils::AllocOptions;
+  using unialgo::utils::NumaPolicy;
+  using unialgo::utils::PagePolicy;
+
+  // weights on every page policy, trained on two far apart classes
+  for (auto pages : {PagePolicy::standard, PagePolicy::transparent_huge,
+                     PagePolicy::huge_tlb}) {
+    AllocOptions options{pages, NumaPolicy::interleave, 0};
+    unialgo::Perceptron p(3, options);
+
+    std::ostringstream weights;
+    p.PrintWeights(weights);
+    assert(weights.str().rfind("Weights vector size: 4", 0) == 0);
+
+    const std::size_t train_set_size = 600;
+    double *train_set = static_cast<double *>(unialgo::utils::aligned_alloc(
+        sizeof(double), sizeof(double) * 4 * train_set_size));
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    for (std::size_t i = 0; i < train_set_size; ++i) {
+      double target = i % 2;
+      for (std::size_t j = 0; j < 3; ++j)
+        train_set[i * 4 + j] = dis(gen) + target * 10.0;
+      train_set[i * 4 + 3] = target;
+    }
+    p.Train<double>(train_set, train_set_size);
+    unialgo::utils::aligned_free(train_set);
+
+    double origin[3] = {0.0, 0.0, 0.0};
+    double far[3] = {20.0, 20.0, 20.0};
+    assert(!p.Test(origin));
+    assert(p.Test(far));
+  }
+}
+
 int main() {
+  TestPerceptronOptions();
   TestPerceptronReal<double>(600,
                              std::uniform_real_distribution<double>(0.0, 2.0),
                              std::uniform_real_distribution<double>(6.0, 9.0));
@@ -1,8 +1,30 @@
 #include "unialgo/utils/alignedAlloc.h"
 
+#include <algorithm>  // std::max
+#include <new>        // std::bad_alloc
+
+namespace {
+
+/// true if options ask for plain aligned_alloc
+bool isDefault(const unialgo::utils::AllocOptions &options) {
+  return options.pages == unialgo::utils::PagePolicy::standard &&
+         options.numa == unialgo::utils::NumaPolicy::local;
+}
+
+/// size rounded up to a multiple of block
+std::size_t roundUp(std::size_t size, std::size_t block) {
+  return (size + block - 1) / block * block;
+}
+
+}  // namespace
+
 #if defined(__linux__) || defined(__APPLE__)
 /// definition for linux and apple compilers
 
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <cstdlib>
 
 void *unialgo::utils::aligned_alloc(std::size_t alignment, std::size_t size) {
@@ -11,6 +33,105 @@ void *unialgo::utils::aligned_alloc(std::size_t alignment, std::size_t size) {
 
 void unialgo::utils::aligned_free(void *ptr) { std::free(ptr); }
 
+namespace {
+
+/// bytes mapped for an allocation of size bytes
+std::size_t mappedSize(std::size_t size,
+                       const unialgo::utils::AllocOptions &options) {
+  std::size_t page = options.pages == unialgo::utils::PagePolicy::standard
+                         ? static_cast<std::size_t>(sysconf(_SC_PAGESIZE))
+                         : unialgo::utils::huge_page_size;
+  return roundUp(std::max<std::size_t>(size, 1), page);
+}
+
+/// anonymous mapping of length bytes aligned to alignment, nullptr on failure
+void *mapAligned(std::size_t length, std::size_t alignment, int flags) {
+  std::size_t extra = alignment > 1 ? alignment : 0;
+  void *ptr = mmap(nullptr, length + extra, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+  if (ptr == MAP_FAILED) return nullptr;
+  if (!extra) return ptr;
+  // unmaps the bytes before and after the aligned range
+  char *begin = static_cast<char *>(ptr);
+  char *aligned = reinterpret_cast<char *>(
+      roundUp(reinterpret_cast<std::size_t>(begin), alignment));
+  if (aligned != begin) munmap(begin, aligned - begin);
+  std::size_t tail = extra - (aligned - begin);
+  if (tail) munmap(aligned + length, tail);
+  return aligned;
+}
+
+/// applies the NUMA policy of options to [ptr, ptr + length) (best effort)
+void applyNuma(void *ptr, std::size_t length,
+               const unialgo::utils::AllocOptions &options) {
+#if defined(SYS_mbind)
+  // values of MPOL_BIND, MPOL_INTERLEAVE in <numaif.h> (no libnuma needed)
+  const int mpol_bind = 2;
+  const int mpol_interleave = 3;
+  unsigned long mask = 0;
+  int mode = 0;
+  switch (options.numa) {
+    case unialgo::utils::NumaPolicy::local:
+      return;
+    case unialgo::utils::NumaPolicy::bind:
+      if (options.node < 0 || options.node >= 64) return;
+      mask = 1UL << options.node;
+      mode = mpol_bind;
+      break;
+    case unialgo::utils::NumaPolicy::interleave:
+      mask = ~0UL;  // the kernel keeps the nodes with memory
+      mode = mpol_interleave;
+      break;
+  }
+  // the kernel reads maxnode - 1 bits of the mask
+  syscall(SYS_mbind, ptr, length, mode, &mask, sizeof(mask) * 8 + 1, 0);
+#else
+  (void)ptr;
+  (void)length;
+  (void)options;
+#endif
+}
+
+}  // namespace
+
+void *unialgo::utils::aligned_alloc(std::size_t alignment, std::size_t size,
+                                    const AllocOptions &options) {
+  if (isDefault(options))
+    return std::aligned_alloc(alignment, roundUp(size, alignment));
+
+  std::size_t length = mappedSize(size, options);
+  bool huge = options.pages != PagePolicy::standard;
+  std::size_t page = huge ? huge_page_size
+                          : static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  // mappings are page aligned, only bigger alignments need trimming
+  std::size_t extra = alignment > page ? alignment : 0;
+  void *ptr = nullptr;
+#if defined(MAP_HUGETLB)
+  // fails when no hugetlb pages are reserved (vm.nr_hugepages)
+  if (options.pages == PagePolicy::huge_tlb)
+    ptr = mapAligned(length, extra, MAP_HUGETLB);
+#endif
+  if (!ptr) {
+    ptr = mapAligned(length, huge ? std::max(alignment, page) : extra, 0);
+    if (!ptr) return nullptr;
+#if defined(MADV_HUGEPAGE)
+    if (huge) madvise(ptr, length, MADV_HUGEPAGE);
+#endif
+  }
+  // pages are not touched yet, the policy applies to all of them
+  applyNuma(ptr, length, options);
+  return ptr;
+}
+
+void unialgo::utils::aligned_free(void *ptr, std::size_t size,
+                                  const AllocOptions &options) {
+  if (!ptr) return;
+  if (isDefault(options))
+    std::free(ptr);
+  else
+    munmap(ptr, mappedSize(size, options));
+}
+
 #elif defined(_WIN32)
 /// definition for windows compilers
 
@@ -22,9 +143,32 @@ void *unialgo::utils::aligned_alloc(std::size_t alignment, std::size_t size) {
 
 void unialgo::utils::aligned_free(void *memblock) { _aligned_free(memblock); }
 
+// large pages need SeLockMemoryPrivilege, options are ignored
+void *unialgo::utils::aligned_alloc(std::size_t alignment, std::size_t size,
+                                    const AllocOptions &) {
+  return _aligned_malloc(roundUp(size, alignment), alignment);
+}
+
+void unialgo::utils::aligned_free(void *memblock, std::size_t,
+                                  const AllocOptions &) {
+  _aligned_free(memblock);
+}
+
 #else
 /// fallout
 
 // to implement (?)
 
 #endif
+
+void *unialgo::utils::PageResource::do_allocate(std::size_t bytes,
+                                                std::size_t alignment) {
+  void *ptr = aligned_alloc(alignment, bytes, options_);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void unialgo::utils::PageResource::do_deallocate(void *ptr, std::size_t bytes,
+                                                 std::size_t) {
+  aligned_free(ptr, bytes, options_);
+}
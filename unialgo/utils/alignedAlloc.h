@@ -7,9 +7,23 @@
  *
  *  This allows aligned_alloc, aliged_free usage on all systems
  *
+ *  The overloads taking AllocOptions map the memory directly from the system
+ *  so that big tables (rank layers, wavelet levels, weights) can be backed
+ *  by 2MB pages, cutting the TLB misses of random probes, and placed on a
+ *  NUMA node or interleaved across nodes. PageResource gives the same
+ *  options to the std::pmr containers:
+ *
+ *    utils::PageResource huge({utils::PagePolicy::transparent_huge});
+ *    utils::WaveletMatrix wm(text, &huge);
+ *
+ *  Page and NUMA policies are hints: where they are not supported (no
+ *  reserved hugetlb pages, a single node, not linux) the memory is still
+ *  allocated with normal pages.
+ *
  */
 
-#include <cstddef>  //std::size_t
+#include <cstddef>          //std::size_t
+#include <memory_resource>  //std::pmr::memory_resource
 
 namespace unialgo {
 namespace utils {
@@ -18,7 +32,82 @@ void *aligned_alloc(std::size_t alignment, std::size_t size);
 
 void aligned_free(void *memblock);
 
+/// pages backing an allocation
+enum class PagePolicy {
+  standard,          // pages of the system allocator
+  transparent_huge,  // 2MB transparent huge pages (madvise(MADV_HUGEPAGE))
+  huge_tlb           // explicit hugetlb pages (transparent_huge if none)
+};
+
+/// NUMA placement of an allocation
+enum class NumaPolicy {
+  local,      // first touch (default of the system)
+  bind,       // only on node
+  interleave  // pages round-robin on every node
+};
+
+/// options of an allocation (default = plain aligned_alloc)
+struct AllocOptions {
+  PagePolicy pages = PagePolicy::standard;
+  NumaPolicy numa = NumaPolicy::local;
+  int node = 0;  // node of NumaPolicy::bind
+};
+
+static const std::size_t huge_page_size = 1 << 21;  // size of a huge page
+
+/**
+ * @brief Allocates size bytes aligned to alignment with options
+ *
+ * With default options this is aligned_alloc(alignment, size), otherwise the
+ * memory is mapped (rounded to whole pages, aligned to the larger of
+ * alignment and the page size, huge_page_size for huge pages) and the
+ * policies are applied
+ *
+ * @param alignment alignment of the memory (a power of two)
+ * @param size bytes to allocate
+ * @param options page and NUMA policies
+ * @return void* memory allocated, nullptr on failure
+ */
+void *aligned_alloc(std::size_t alignment, std::size_t size,
+                    const AllocOptions &options);
+
+/**
+ * @brief Frees memory of aligned_alloc(alignment, size, options)
+ *
+ * Important: size and options must be the ones of the allocation
+ */
+void aligned_free(void *memblock, std::size_t size,
+                  const AllocOptions &options);
+
+/**
+ * @brief Class PageResource
+ * memory resource allocating with aligned_alloc(alignment, bytes, options)
+ *
+ * Every allocation is mapped on its own, for indexes made of many small
+ * allocations use it as upstream of an Arena
+ */
+class PageResource : public std::pmr::memory_resource {
+ public:
+  explicit PageResource(const AllocOptions &options = {})
+      : options_(options) {}
+
+  const AllocOptions &options() const { return options_; }
+
+ private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  void do_deallocate(void *ptr, std::size_t bytes,
+                     std::size_t alignment) override;
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  AllocOptions options_;  // policies of every allocation
+};
+
 }  // end namespace utils
 }  // end namespace unialgo
 
-#endif  // UNIALGO_ALIGNED_ALLOC_
\ No newline at end of file
+#endif  // UNIALGO_ALIGNED_ALLOC_
@@ -0,0 +1,154 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_ARENA_
+#define UNIALGO_UTILS_BITVECTOR_ARENA_
+
+#include <algorithm>        // std::max
+#include <cstddef>          // std::byte, std::max_align_t
+#include <memory>           // std::align
+#include <memory_resource>  // std::pmr::memory_resource
+
+/**
+ * @file This file contains a monotonic arena for the succinct containers
+ *
+ * Bitvector, WordVector, RankHelper and WaveletMatrix take a
+ * std::pmr::memory_resource*, an Arena hands out memory from big chunks and
+ * never frees single allocations: every chunk is freed at once when the
+ * arena is released or destroyed. Reserving the size of an index up front
+ * makes its construction a single upstream allocation and its teardown a
+ * single free:
+ *
+ *   utils::Arena arena(1 << 20);
+ *   utils::WaveletMatrix wm(text, &arena);
+ *
+ * Important: the arena must outlive every container allocated from it
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+class Arena : public std::pmr::memory_resource {
+ public:
+  static const std::size_t chunk_alignment = 64;   // alignment of chunks
+  static const std::size_t min_chunk_size = 4096;  // smallest chunk allocated
+
+  /**
+   * @brief Construct a new Arena object
+   *
+   * @param bytes bytes to reserve in the first chunk (0 = allocate lazily)
+   * @param upstream resource the chunks are allocated from
+   */
+  explicit Arena(
+      std::size_t bytes = 0,
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : upstream_(upstream),
+        last_(nullptr),
+        current_(nullptr),
+        end_(nullptr),
+        used_(0),
+        capacity_(0),
+        num_chunks_(0) {
+    if (bytes) reserve(bytes);
+  }
+
+  ~Arena() override { release(); }
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * @brief Makes sure the next bytes bytes are allocated without going
+   * upstream (a new chunk is allocated if the current one is too small)
+   */
+  void reserve(std::size_t bytes) {
+    if (static_cast<std::size_t>(end_ - current_) < bytes) newChunk(bytes);
+  }
+
+  /**
+   * @brief Frees every chunk, every allocation from the arena is invalidated
+   */
+  void release() {
+    while (last_) {
+      Chunk* prev = last_->prev;
+      upstream_->deallocate(last_, last_->size, chunk_alignment);
+      last_ = prev;
+    }
+    current_ = end_ = nullptr;
+    used_ = capacity_ = num_chunks_ = 0;
+  }
+
+  /**
+   * @brief Bytes handed out (alignment padding included)
+   */
+  std::size_t used() const { return used_; }
+
+  /**
+   * @brief Bytes that can be handed out by the chunks allocated
+   */
+  std::size_t capacity() const { return capacity_; }
+
+  /**
+   * @brief Number of chunks allocated upstream
+   */
+  std::size_t numChunks() const { return num_chunks_; }
+
+ private:
+  // header at the start of every chunk, chunks are a list from the last
+  struct alignas(chunk_alignment) Chunk {
+    Chunk* prev;       // chunk allocated before this
+    std::size_t size;  // bytes of the chunk (header included)
+  };
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    void* ptr = current_;
+    std::size_t space = end_ - current_;
+    if (!current_ || !std::align(alignment, bytes, ptr, space)) {
+      newChunk(bytes + alignment);
+      ptr = current_;
+      space = end_ - current_;
+      std::align(alignment, bytes, ptr, space);
+    }
+    std::byte* next = static_cast<std::byte*>(ptr) + bytes;
+    used_ += next - current_;
+    current_ = next;
+    return ptr;
+  }
+
+  // single allocations are freed with the whole arena
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  /**
+   * @brief Allocates a chunk with at least bytes usable bytes, chunks grow
+   * geometrically so that many small allocations take few chunks
+   */
+  void newChunk(std::size_t bytes) {
+    std::size_t usable = std::max({bytes, min_chunk_size, capacity_});
+    std::size_t size = sizeof(Chunk) + usable;
+    Chunk* chunk =
+        static_cast<Chunk*>(upstream_->allocate(size, chunk_alignment));
+    chunk->prev = last_;
+    chunk->size = size;
+    last_ = chunk;
+    current_ = reinterpret_cast<std::byte*>(chunk + 1);
+    end_ = current_ + usable;
+    capacity_ += usable;
+    ++num_chunks_;
+  }
+
+  std::pmr::memory_resource* upstream_;  // resource of the chunks
+  Chunk* last_;                          // last chunk allocated
+  std::byte* current_;                   // first free byte of last chunk
+  std::byte* end_;                       // end of last chunk
+  std::size_t used_;                     // bytes handed out
+  std::size_t capacity_;                 // usable bytes of all chunks
+  std::size_t num_chunks_;               // chunks allocated upstream
+};
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_ARENA_
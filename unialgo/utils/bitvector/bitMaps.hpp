@@ -5,6 +5,10 @@
 
 #include <cmath>  // std::ceil
 
+#if defined(__BMI2__) || defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>  // _pdep_u64, _tzcnt_u64, popcount kernels
+#endif
+
 namespace unialgo {
 
 namespace utils {
@@ -200,6 +204,230 @@ inline uint64_t read_bits(const uint64_t* word, uint8_t offset,
   }
 }
 
+/**
+ * @brief Position of the rank-th set bit in word
+ *
+ * Uses pdep + tzcnt when BMI2 is available, otherwise narrows the search to
+ * a byte with popcount and finishes inside the byte.
+ *
+ * Important: word must contain more than rank bits set
+ *
+ * @param word word to search in
+ * @param rank number of set bits to skip (0 = first set bit)
+ * @return uint8_t position of the bit in word (from lsb)
+ */
+inline uint8_t select_in_word(uint64_t word, uint8_t rank) {
+#if defined(__BMI2__)
+  return _tzcnt_u64(_pdep_u64(1ULL << rank, word));
+#else
+  uint8_t offset = 0;
+  // skip whole bytes with less than rank + 1 bits set
+  for (uint8_t c = __builtin_popcountll(word & 0xFF); c <= rank;
+       c = __builtin_popcountll(word & 0xFF)) {
+    rank -= c;
+    word >>= 8;
+    offset += 8;
+  }
+  // clear the rank lowest set bits in the byte
+  for (; rank > 0; --rank) word &= word - 1;
+  return offset + __builtin_ctzll(word);
+#endif
+}
+
+#if defined(__AVX2__)
+/**
+ * @brief Popcount of every byte of v summed in the 4 64-bit lanes
+ */
+inline __m256i popcount_256(__m256i v) {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                       1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i lo = _mm256_and_si256(v, low_mask);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                   _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+/**
+ * @brief Carry-save adder on 256 bit registers (Harley-Seal popcount)
+ */
+inline void carry_save_add(__m256i& high, __m256i& low, __m256i a, __m256i b,
+                           __m256i c) {
+  __m256i u = _mm256_xor_si256(a, b);
+  high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+  low = _mm256_xor_si256(u, c);
+}
+#endif
+
+/**
+ * @brief Number of bits set in words[0, n)
+ *
+ * Uses AVX-512 VPOPCNTDQ or a Harley-Seal AVX2 kernel on big arrays when
+ * available, popcount on single words otherwise
+ *
+ * @param words pointer to first word
+ * @param n number of words
+ * @return std::size_t # of bits set
+ */
+inline std::size_t popcount_words(const uint64_t* words, std::size_t n) {
+  std::size_t i = 0;
+  uint64_t total = 0;
+#if defined(__AVX512VPOPCNTDQ__)
+  __m512i acc = _mm512_setzero_si512();
+  for (; i + 8 <= n; i += 8)
+    acc = _mm512_add_epi64(acc,
+                           _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+  total += _mm512_reduce_add_epi64(acc);
+#elif defined(__AVX2__)
+  // Harley-Seal: 16 registers are reduced with carry-save adders, a single
+  // byte popcount is done on the 16s every 16 registers
+  auto load = [words](std::size_t j) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + j));
+  };
+  __m256i acc = _mm256_setzero_si256();
+  __m256i ones = _mm256_setzero_si256();
+  __m256i twos = _mm256_setzero_si256();
+  __m256i fours = _mm256_setzero_si256();
+  __m256i eights = _mm256_setzero_si256();
+  __m256i sixteens, twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+  for (; i + 64 <= n; i += 64) {
+    carry_save_add(twos_a, ones, ones, load(i), load(i + 4));
+    carry_save_add(twos_b, ones, ones, load(i + 8), load(i + 12));
+    carry_save_add(fours_a, twos, twos, twos_a, twos_b);
+    carry_save_add(twos_a, ones, ones, load(i + 16), load(i + 20));
+    carry_save_add(twos_b, ones, ones, load(i + 24), load(i + 28));
+    carry_save_add(fours_b, twos, twos, twos_a, twos_b);
+    carry_save_add(eights_a, fours, fours, fours_a, fours_b);
+    carry_save_add(twos_a, ones, ones, load(i + 32), load(i + 36));
+    carry_save_add(twos_b, ones, ones, load(i + 40), load(i + 44));
+    carry_save_add(fours_a, twos, twos, twos_a, twos_b);
+    carry_save_add(twos_a, ones, ones, load(i + 48), load(i + 52));
+    carry_save_add(twos_b, ones, ones, load(i + 56), load(i + 60));
+    carry_save_add(fours_b, twos, twos, twos_a, twos_b);
+    carry_save_add(eights_b, fours, fours, fours_a, fours_b);
+    carry_save_add(sixteens, eights, eights, eights_a, eights_b);
+    acc = _mm256_add_epi64(acc, popcount_256(sixteens));
+  }
+  acc = _mm256_slli_epi64(acc, 4);
+  acc = _mm256_add_epi64(acc, _mm256_slli_epi64(popcount_256(eights), 3));
+  acc = _mm256_add_epi64(acc, _mm256_slli_epi64(popcount_256(fours), 2));
+  acc = _mm256_add_epi64(acc, _mm256_slli_epi64(popcount_256(twos), 1));
+  acc = _mm256_add_epi64(acc, popcount_256(ones));
+  for (; i + 4 <= n; i += 4) acc = _mm256_add_epi64(acc, popcount_256(load(i)));
+  total += _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+           _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+#endif
+  for (; i < n; ++i) total += __builtin_popcountll(words[i]);
+  return total;
+}
+
+// constants of the word hash (wyhash primes)
+static const uint64_t hash_secret[4] = {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL,
+    0x589965cc75374cc3ULL};
+static const uint64_t hash_prime = 0x9e3779b185ebca87ULL;
+
+/**
+ * @brief wyhash mix: 64x64 -> 128 bit product, high and low halves xored
+ */
+inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+  __uint128_t product = static_cast<__uint128_t>(a) * b;
+  return static_cast<uint64_t>(product) ^
+         static_cast<uint64_t>(product >> 64);
+}
+
+/**
+ * @brief 64-bit hash of a single word
+ */
+inline uint64_t hash_word(uint64_t word, uint64_t seed = 0) {
+  return hash_mix(word ^ hash_secret[0], seed ^ hash_secret[1]);
+}
+
+/**
+ * @brief 64-bit hash of words[0, n)
+ *
+ * Four accumulators take a stripe of 4 words at a time (xxh3 style: the word
+ * plus the product of its halves xored with a secret), they are scrambled
+ * every 32 words and folded with hash_mix at the end. Every stripe of a
+ * block has its own secret (the secret xored with stripe * hash_prime), so
+ * the same word in two stripes adds different values and moving words
+ * changes the hash. The AVX2 kernel runs the 4 accumulators in a register
+ * and gives the same hash as the scalar loop
+ *
+ * @param words pointer to first word
+ * @param n number of words
+ * @param seed seed of the hash
+ * @return uint64_t hash of the words
+ */
+inline uint64_t hash_words(const uint64_t* words, std::size_t n,
+                           uint64_t seed = 0) {
+  const std::size_t block = 32;  // words between scrambles
+  uint64_t acc[4] = {seed ^ hash_secret[0], seed + hash_secret[1],
+                     seed ^ hash_secret[2], seed - hash_secret[3]};
+  std::size_t i = 0;
+  // stripe = index of the stripe in its block
+  auto accumulate = [&acc](const uint64_t* words, std::size_t stripe) {
+    const uint64_t key = stripe * hash_prime;
+    for (std::size_t j = 0; j < 4; ++j) {
+      uint64_t x = words[j] ^ hash_secret[j] ^ key;
+      acc[j] += words[j] + (x & 0xffffffff) * (x >> 32);
+    }
+  };
+#if defined(__AVX2__)
+  const __m256i secret =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hash_secret));
+  const __m256i prime = _mm256_set1_epi64x(hash_prime & 0xffffffff);
+  __m256i vacc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc));
+  for (; i + block <= n; i += block) {
+    for (std::size_t s = 0; s < block; s += 4) {
+      __m256i data =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i + s));
+      __m256i key = _mm256_set1_epi64x((s / 4) * hash_prime);
+      __m256i x = _mm256_xor_si256(data, _mm256_xor_si256(secret, key));
+      __m256i product = _mm256_mul_epu32(x, _mm256_srli_epi64(x, 32));
+      vacc = _mm256_add_epi64(vacc, _mm256_add_epi64(data, product));
+    }
+    // scramble: acc = (acc ^ (acc >> 47) ^ secret) * low 32 bits of prime
+    vacc = _mm256_xor_si256(vacc, _mm256_srli_epi64(vacc, 47));
+    vacc = _mm256_xor_si256(vacc, secret);
+    __m256i lo = _mm256_mul_epu32(vacc, prime);
+    __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(vacc, 32), prime);
+    vacc = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc), vacc);
+#endif
+  for (; i + block <= n; i += block) {
+    for (std::size_t s = 0; s < block; s += 4) accumulate(words + i + s, s / 4);
+    for (std::size_t j = 0; j < 4; ++j) {
+      acc[j] ^= (acc[j] >> 47) ^ hash_secret[j];
+      acc[j] *= hash_prime & 0xffffffff;
+    }
+  }
+  for (; i + 4 <= n; i += 4) accumulate(words + i, (i % block) / 4);
+
+  uint64_t res = seed ^ (n * hash_prime);
+  for (std::size_t j = 0; j < 4; ++j)
+    res = hash_mix(acc[j] ^ hash_secret[j], res ^ hash_secret[(j + 1) % 4]);
+  for (; i < n; ++i)
+    res = hash_mix(words[i] ^ hash_secret[i % 4], res ^ hash_prime);
+  return hash_mix(res ^ hash_secret[0], n ^ hash_prime);
+}
+
+/**
+ * @brief 64-bit hash of the first num_bits bits of words (bits past num_bits
+ * in the last word are ignored)
+ */
+inline uint64_t hash_bits(const uint64_t* words, std::size_t num_bits,
+                          uint64_t seed = 0) {
+  std::size_t full = num_bits / 64;
+  uint64_t res = hash_words(words, full, seed ^ num_bits);
+  if (num_bits % 64)
+    res = hash_word(words[full] & lower_bits_set[num_bits % 64], res);
+  return res;
+}
+
 // turn this into a bit hack
 // inline uint64_t getLog2(const uint64_t value) {
 //   return std::ceil(std::log(value) / std::log(2));
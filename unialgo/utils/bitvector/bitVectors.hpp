@@ -6,8 +6,21 @@
  * @brief Group import for bitVectors
  */
 
+#include "unialgo/utils/bitvector/arena.hpp"
 #include "unialgo/utils/bitvector/bitvector.hpp"
+#include "unialgo/utils/bitvector/bitvectorView.hpp"
+#include "unialgo/utils/bitvector/builders.hpp"
+#include "unialgo/utils/bitvector/concurrentBitvector.hpp"
+#include "unialgo/utils/bitvector/dynamicBitvector.hpp"
+#include "unialgo/utils/bitvector/eliasFano.hpp"
+#include "unialgo/utils/bitvector/fixedWordVector.hpp"
+#include "unialgo/utils/bitvector/hybridBitvector.hpp"
 #include "unialgo/utils/bitvector/rankHelper.hpp"
+#include "unialgo/utils/bitvector/rankInterleaved.hpp"
+#include "unialgo/utils/bitvector/rrrBitvector.hpp"
+#include "unialgo/utils/bitvector/serialize.hpp"
 #include "unialgo/utils/bitvector/wordVector.hpp"
+#include "unialgo/utils/bitvector/wordVectorSort.hpp"
+#include "unialgo/utils/bitvector/wordVectorView.hpp"
 
 #endif  // UNIALGO_UTILS_BITVECTORS_
\ No newline at end of file
@@ -2,18 +2,136 @@
 
 #include <stddef.h>  // size_t
 
+#include <algorithm>  // std::fill
 #include <cassert>
 #include <cmath>
 #include <iostream>
 
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
 #include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/serialize.hpp"
 
 namespace unialgo {
 namespace utils {
 
-Bitvector::Bitvector(std::size_t num_bits)
+namespace {
+
+enum class WordOp { kAnd, kOr, kXor, kAndNot, kNot };
+
+/**
+ * @brief dst[i] = dst[i] op src[i] for i in [0, n), src unused for kNot
+ *
+ * Uses 512 / 256 bit registers when compiled with AVX-512 / AVX2
+ */
+template <WordOp op>
+inline void apply_words(uint64_t* dst, const uint64_t* src, std::size_t n) {
+  std::size_t i = 0;
+#if defined(__AVX512F__)
+  const __m512i ones512 = _mm512_set1_epi64(-1);
+  for (; i + 8 <= n; i += 8) {
+    __m512i a = _mm512_loadu_si512(dst + i);
+    __m512i b = op == WordOp::kNot ? ones512 : _mm512_loadu_si512(src + i);
+    if constexpr (op == WordOp::kAnd) a = _mm512_and_si512(a, b);
+    if constexpr (op == WordOp::kOr) a = _mm512_or_si512(a, b);
+    if constexpr (op == WordOp::kXor || op == WordOp::kNot)
+      a = _mm512_xor_si512(a, b);
+    if constexpr (op == WordOp::kAndNot) a = _mm512_andnot_si512(b, a);
+    _mm512_storeu_si512(dst + i, a);
+  }
+#endif
+#if defined(__AVX2__)
+  const __m256i ones256 = _mm256_set1_epi64x(-1);
+  for (; i + 4 <= n; i += 4) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    __m256i b = op == WordOp::kNot ? ones256
+                                   : _mm256_loadu_si256(
+                                         reinterpret_cast<const __m256i*>(
+                                             src + i));
+    if constexpr (op == WordOp::kAnd) a = _mm256_and_si256(a, b);
+    if constexpr (op == WordOp::kOr) a = _mm256_or_si256(a, b);
+    if constexpr (op == WordOp::kXor || op == WordOp::kNot)
+      a = _mm256_xor_si256(a, b);
+    if constexpr (op == WordOp::kAndNot) a = _mm256_andnot_si256(b, a);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), a);
+  }
+#endif
+  for (; i < n; ++i) {
+    if constexpr (op == WordOp::kAnd) dst[i] &= src[i];
+    if constexpr (op == WordOp::kOr) dst[i] |= src[i];
+    if constexpr (op == WordOp::kXor) dst[i] ^= src[i];
+    if constexpr (op == WordOp::kAndNot) dst[i] &= ~src[i];
+    if constexpr (op == WordOp::kNot) dst[i] = ~dst[i];
+  }
+}
+
+/**
+ * @brief dst[i] = src[i] >> shift | src[i + 1] << (64 - shift), i in [0, n)
+ *
+ * Ascending, so dst can alias src when dst <= src (in place right shift)
+ */
+inline void shift_words_right(uint64_t* dst, const uint64_t* src,
+                              std::size_t n, uint8_t shift) {
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  // vector shifts by >= 64 give 0, no special case for shift = 0
+  const __m128i right = _mm_cvtsi32_si128(shift);
+  const __m128i left = _mm_cvtsi32_si128(64 - shift);
+  for (; i + 4 <= n; i += 4) {
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i hi =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 1));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i),
+        _mm256_or_si256(_mm256_srl_epi64(lo, right),
+                        _mm256_sll_epi64(hi, left)));
+  }
+#endif
+  for (; i < n; ++i)
+    dst[i] = (src[i] >> shift) | (shift ? src[i + 1] << (64 - shift) : 0);
+}
+
+/**
+ * @brief dst[i] = src[i] << shift | src[i - 1] >> (64 - shift), i in [0, n)
+ *
+ * Descending, so dst can alias src when dst >= src (in place left shift)
+ */
+inline void shift_words_left(uint64_t* dst, const uint64_t* src,
+                             std::size_t n, uint8_t shift) {
+  std::size_t i = n;
+#if defined(__AVX2__)
+  const __m128i left = _mm_cvtsi32_si128(shift);
+  const __m128i right = _mm_cvtsi32_si128(64 - shift);
+  for (; i >= 4; i -= 4) {
+    __m256i hi =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i - 4));
+    __m256i lo =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i - 5));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i - 4),
+        _mm256_or_si256(_mm256_sll_epi64(hi, left),
+                        _mm256_srl_epi64(lo, right)));
+  }
+#endif
+  for (; i > 0; --i)
+    dst[i - 1] = (src[i - 1] << shift) |
+                 (shift ? src[i - 2] >> (64 - shift) : 0);
+}
+
+}  // namespace
+
+Bitvector::Bitvector(std::size_t num_bits,
+                     std::pmr::memory_resource* resource)
     : num_bits_(num_bits),
-      bits_(std::ceil(num_bits / static_cast<double>(type_size))) {}
+      bits_(std::ceil(num_bits / static_cast<double>(type_size)), resource) {}
+
+Bitvector::Bitvector(WordBuffer words, std::size_t num_bits)
+    : bits_(std::move(words)), num_bits_(num_bits) {
+  assert(bits_.size() == (num_bits + type_size - 1) / type_size &&
+         "number of words not matching num_bits");
+}
 
 void Bitvector::SetBit(std::size_t bit_pos) {
   bits_[std::floor(bit_pos / type_size)] |= bit_set[bit_pos % type_size];
@@ -83,7 +201,23 @@ std::size_t Bitvector::getNumBits() const { return num_bits_; }
 std::size_t Bitvector::size() const { return num_bits_; }
 
 std::vector<typename Bitvector::Type> Bitvector::getBitVec() const {
-  return bits_;
+  return std::vector<Type>(bits_.begin(), bits_.end());
+}
+
+void Bitvector::write(SerialWriter& out) const {
+  out.header(serial::Tag::kBitvector);
+  out.value(num_bits_);
+  out.words(bits_.data(), bits_.size());
+}
+
+Bitvector Bitvector::read(SerialReader& in) {
+  in.header(serial::Tag::kBitvector);
+  Bitvector bv;
+  bv.num_bits_ = in.value();
+  bv.bits_ = in.words();
+  if (bv.bits_.size() != (bv.num_bits_ + type_size - 1) / type_size)
+    throw std::runtime_error("unialgo: corrupted serialized Bitvector");
+  return bv;
 }
 
 bool Bitvector::operator==(const Bitvector& other) const {
@@ -97,25 +231,126 @@ bool Bitvector::operator!=(const Bitvector& other) const {
   return !(*this == other);
 }
 
-Bitvector Bitvector::operator&(const Bitvector& bv) {
-  // assert(bv.bits_.size() == bits_.size() && "bitvector size not matching");
-  assert(bv.getNumBits() == num_bits_ && "bitvector size not matching");
-  Bitvector res(bv.num_bits_);
-  for (std::size_t i = 0; i < res.bits_.size(); ++i) {
-    res.bits_[i] = bits_[i] & bv.bits_[i];
+void Bitvector::Reset() { std::fill(bits_.begin(), bits_.end(), 0); }
+
+std::size_t Bitvector::count() const {
+  return popcount_words(bits_.data(), bits_.size());
+}
+
+std::size_t Bitvector::find_first() const {
+  for (std::size_t w = 0; w < bits_.size(); ++w)
+    if (bits_[w]) return w * type_size + __builtin_ctzll(bits_[w]);
+  return npos;
+}
+
+std::size_t Bitvector::find_next(std::size_t pos) const {
+  if (pos == npos || ++pos >= num_bits_) return npos;
+  std::size_t w = pos / type_size;
+  Type word = bits_[w] & (all_set << (pos % type_size));
+  while (!word) {
+    if (++w == bits_.size()) return npos;
+    word = bits_[w];
   }
-  return res;
+  return w * type_size + __builtin_ctzll(word);
+}
+
+void Bitvector::ClearUnusedBits() {
+  if (num_bits_ % type_size)
+    bits_.back() &= lower_bits_set[num_bits_ % type_size];
+}
+
+Bitvector Bitvector::operator&(const Bitvector& bv) const {
+  Bitvector res(*this);
+  return res &= bv;
 }
 
 Bitvector& Bitvector::operator&=(const Bitvector& bv) {
-  // assert(bv.bits_.size() == bits_.size() && "bitvector size not matching");
   assert(bv.getNumBits() == num_bits_ && "bitvector size not matching");
-  for (std::size_t i = 0; i < bits_.size(); ++i) {
-    bits_[i] = bits_[i] & bv.bits_[i];
+  apply_words<WordOp::kAnd>(bits_.data(), bv.bits_.data(), bits_.size());
+  return *this;
+}
+
+Bitvector Bitvector::operator|(const Bitvector& bv) const {
+  Bitvector res(*this);
+  return res |= bv;
+}
+
+Bitvector& Bitvector::operator|=(const Bitvector& bv) {
+  assert(bv.getNumBits() == num_bits_ && "bitvector size not matching");
+  apply_words<WordOp::kOr>(bits_.data(), bv.bits_.data(), bits_.size());
+  return *this;
+}
+
+Bitvector Bitvector::operator^(const Bitvector& bv) const {
+  Bitvector res(*this);
+  return res ^= bv;
+}
+
+Bitvector& Bitvector::operator^=(const Bitvector& bv) {
+  assert(bv.getNumBits() == num_bits_ && "bitvector size not matching");
+  apply_words<WordOp::kXor>(bits_.data(), bv.bits_.data(), bits_.size());
+  return *this;
+}
+
+Bitvector Bitvector::AndNot(const Bitvector& bv) const {
+  Bitvector res(*this);
+  return res.AndNotAssign(bv);
+}
+
+Bitvector& Bitvector::AndNotAssign(const Bitvector& bv) {
+  assert(bv.getNumBits() == num_bits_ && "bitvector size not matching");
+  apply_words<WordOp::kAndNot>(bits_.data(), bv.bits_.data(), bits_.size());
+  return *this;
+}
+
+Bitvector Bitvector::operator~() const {
+  Bitvector res(*this);
+  apply_words<WordOp::kNot>(res.bits_.data(), nullptr, res.bits_.size());
+  res.ClearUnusedBits();
+  return res;
+}
+
+Bitvector& Bitvector::operator>>=(std::size_t value) {
+  if (value >= num_bits_) {
+    Reset();
+    return *this;
   }
+  std::size_t words = value / type_size;
+  std::size_t n = bits_.size() - words;  // words left after shift
+  Type* bits = bits_.data();
+  // bits[i] = bits[i + words] >> shift | bits[i + words + 1] << (64 - shift)
+  shift_words_right(bits, bits + words, n - 1, value % type_size);
+  bits[n - 1] = bits[n - 1 + words] >> (value % type_size);
+  std::fill(bits_.begin() + n, bits_.end(), 0);
   return *this;
 }
 
+Bitvector& Bitvector::operator<<=(std::size_t value) {
+  if (value >= num_bits_) {
+    Reset();
+    return *this;
+  }
+  std::size_t words = value / type_size;
+  std::size_t n = bits_.size() - words;  // words kept after shift
+  Type* bits = bits_.data();
+  // bits[i + words] = bits[i] << shift | bits[i - 1] >> (64 - shift)
+  shift_words_left(bits + words + 1, bits + 1, n - 1, value % type_size);
+  bits[words] = bits[0] << (value % type_size);
+  std::fill(bits_.begin(), bits_.begin() + words, 0);
+  ClearUnusedBits();
+  return *this;
+}
+
+Bitvector Bitvector::operator>>(std::size_t value) const {
+  Bitvector res(*this);
+  return res >>= value;
+}
+
+Bitvector Bitvector::operator<<(std::size_t value) const {
+  Bitvector res(*this);
+  return res <<= value;
+}
+
 std::ostream& operator<<(std::ostream& os, const Bitvector& bv) {
   for (std::size_t i = bv.size() - 1; i > 0; --i) os << bv[i];
   os << bv[0];
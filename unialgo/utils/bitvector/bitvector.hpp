@@ -3,13 +3,15 @@
 
 #include <stdint.h>  // uint64_t
 
-#include <iostream>     // std::cout
-#include <iterator>     // std::forward_iterator_tag;
-#include <ostream>      // std::ostream
-#include <type_traits>  // std::enable_if, std::is_arithmetic
+#include <iostream>         // std::cout
+#include <iterator>         // std::forward_iterator_tag;
+#include <memory_resource>  // std::pmr::memory_resource
+#include <ostream>          // std::ostream
+#include <type_traits>      // std::enable_if, std::is_arithmetic
 #include <vector>
 
 #include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/wordBuffer.hpp"
 
 namespace unialgo {
 
@@ -17,6 +19,8 @@ namespace utils {
 
 // forward decleration
 class BitvectorReference;
+class SerialWriter;
+class SerialReader;
 
 /**
  * @brief Class Bitvector
@@ -28,19 +32,34 @@ class Bitvector {
   using Reference = BitvectorReference;                   // reference to bit
   using ConstReference = const BitvectorReference;        // const ref to bit
   static const std::size_t type_size = sizeof(Type) * 8;  // size of Type in bit
+  static constexpr std::size_t npos = -1;  // find_* result when no bit set
 
   /**
    * @brief Construct a new Bitvector object
    *
    * @param num_bits number of bits to store
+   * @param resource memory resource the words are allocated from
    */
-  Bitvector(std::size_t num_bits);
+  Bitvector(
+      std::size_t num_bits,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
   /**
    * @brief Construct a new Bitvector object
    */
   Bitvector() : num_bits_(0), bits_(0) {}
 
+  /**
+   * @brief Construct a new Bitvector object on already packed words
+   *
+   * Important: words must have ceil(num_bits / 64) words with the bits past
+   * num_bits set to 0
+   *
+   * @param words words containing the bits
+   * @param num_bits number of bits stored
+   */
+  Bitvector(WordBuffer words, std::size_t num_bits);
+
   ~Bitvector() = default;
 
   Bitvector(const Bitvector&) = default;
@@ -100,6 +119,7 @@ class Bitvector {
    * @brief Access range of bits
    *
    * Important: must satisfy: start < end
+   * This copies the bits, BitvectorView::slice gives the range without a copy
    *
    * @param start starting position to access
    * @param end end position to access (included)
@@ -158,13 +178,61 @@ class Bitvector {
    */
   const Type* data() const { return bits_.data(); }
 
+  /**
+   * @brief Memory resource the words are allocated from
+   */
+  std::pmr::memory_resource* getResource() const { return bits_.resource(); }
+
+  /**
+   * @brief Writes the bitvector in the binary format (see serialize.hpp)
+   *
+   * @param out writer to the destination
+   */
+  void write(SerialWriter& out) const;
+
+  /**
+   * @brief Reads a bitvector written by write, on a mapped file the words
+   * are viewed in place
+   *
+   * @param in reader on the source
+   * @return Bitvector read
+   */
+  static Bitvector read(SerialReader& in);
+
+  /**
+   * @brief Set all bits in Bitvector to 0
+   */
+  void Reset();
+
+  /**
+   * @brief Number of bits set to 1 in Bitvector
+   *
+   * @return std::size_t # of 1s
+   */
+  std::size_t count() const;
+
+  /**
+   * @brief Position of the first bit set to 1
+   *
+   * @return std::size_t lowest position set, npos if no bit is set
+   */
+  std::size_t find_first() const;
+
+  /**
+   * @brief Position of the first bit set to 1 after pos
+   *
+   * @param pos position to start after (excluded)
+   * @return std::size_t lowest position > pos set, npos if there is none
+   */
+  std::size_t find_next(std::size_t pos) const;
+
   /**
    * @brief Bitwise and on bitvector
    *
    * @param bv Bitvector
    * @return Bitvector bitvector with result of bitwise and between this and bv
    */
-  Bitvector operator&(const Bitvector& bv);
+  Bitvector operator&(const Bitvector& bv) const;
 
   /**
    * @brief Bitwise and on this bitvector with argument
@@ -174,9 +242,99 @@ class Bitvector {
    */
   Bitvector& operator&=(const Bitvector& bv);
 
+  /**
+   * @brief Bitwise or on bitvector
+   *
+   * @param bv Bitvector
+   * @return Bitvector bitvector with result of bitwise or between this and bv
+   */
+  Bitvector operator|(const Bitvector& bv) const;
+
+  /**
+   * @brief Bitwise or on this bitvector with argument
+   *
+   * @param bv Bitvector to or with
+   * @return this bitvector with bitwise or between this and bv
+   */
+  Bitvector& operator|=(const Bitvector& bv);
+
+  /**
+   * @brief Bitwise xor on bitvector
+   *
+   * @param bv Bitvector
+   * @return Bitvector bitvector with result of bitwise xor between this and bv
+   */
+  Bitvector operator^(const Bitvector& bv) const;
+
+  /**
+   * @brief Bitwise xor on this bitvector with argument
+   *
+   * @param bv Bitvector to xor with
+   * @return this bitvector with bitwise xor between this and bv
+   */
+  Bitvector& operator^=(const Bitvector& bv);
+
+  /**
+   * @brief Bitwise not on bitvector (bits past size() stay 0)
+   *
+   * @return Bitvector bitvector with every bit of this flipped
+   */
+  Bitvector operator~() const;
+
+  /**
+   * @brief Bitwise and not on bitvector (this & ~bv)
+   *
+   * @param bv Bitvector with the bits to clear
+   * @return Bitvector this with the bits set in bv cleared
+   */
+  Bitvector AndNot(const Bitvector& bv) const;
+
+  /**
+   * @brief Bitwise and not on this bitvector with argument (this &= ~bv)
+   *
+   * @param bv Bitvector with the bits to clear
+   * @return this bitvector with the bits set in bv cleared
+   */
+  Bitvector& AndNotAssign(const Bitvector& bv);
+
+  /**
+   * @brief Right-shift of bitvector bits: bit i + value moves to i
+   *
+   * @param value amount to shift (can be >= size(), gives all 0s)
+   * @return this bitvector right-shifted by value
+   */
+  Bitvector& operator>>=(std::size_t value);
+
+  /**
+   * @brief Left-shift of bitvector bits: bit i moves to i + value, bits moved
+   * past size() are dropped
+   *
+   * @param value amount to shift (can be >= size(), gives all 0s)
+   * @return this bitvector left-shifted by value
+   */
+  Bitvector& operator<<=(std::size_t value);
+
+  /**
+   * @brief Right-shift of bitvector bits
+   *
+   * @param value amount to shift
+   * @return Bitvector copy of this right-shifted by value
+   */
+  Bitvector operator>>(std::size_t value) const;
+
+  /**
+   * @brief Left-shift of bitvector bits
+   *
+   * @param value amount to shift
+   * @return Bitvector copy of this left-shifted by value
+   */
+  Bitvector operator<<(std::size_t value) const;
+
   /**
    * @brief rightl-shift of bitvectors bits
    *
+   * @deprecated kept for compatibility, same as operator>>=
+   *
    * @param value amount to shift
    * @return this bitvector right-shifted by value
    */
@@ -264,9 +422,92 @@ class Bitvector {
   ConstIterator cbegin() const { return ConstIterator(0, this); }
   ConstIterator cend() const { return ConstIterator(num_bits_, this); }
 
+  /**
+   * @brief Iterator on the positions of the bits set to 1
+   *
+   * Keeps the not yet visited bits of the current word, each step is a
+   * tzcnt and empty words are skipped whole
+   */
+  class OnesIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = long;
+    using value_type = std::size_t;
+    using pointer = const std::size_t*;
+    using reference = std::size_t;
+
+    OnesIterator(const Type* words, std::size_t num_words, std::size_t word)
+        : words_(words),
+          num_words_(num_words),
+          word_(word),
+          bits_(word < num_words ? words[word] : 0) {
+      skipEmpty();
+    }
+
+    reference operator*() const {
+      return word_ * type_size + __builtin_ctzll(bits_);
+    }
+
+    OnesIterator& operator++() {
+      bits_ &= bits_ - 1;  // clear lowest bit set
+      skipEmpty();
+      return *this;
+    }
+
+    OnesIterator operator++(int) {
+      OnesIterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const OnesIterator& a, const OnesIterator& b) {
+      return a.words_ == b.words_ && a.word_ == b.word_ && a.bits_ == b.bits_;
+    }
+
+    friend bool operator!=(const OnesIterator& a, const OnesIterator& b) {
+      return !(a == b);
+    }
+
+   private:
+    void skipEmpty() {
+      while (bits_ == 0 && ++word_ < num_words_) bits_ = words_[word_];
+      if (word_ > num_words_) word_ = num_words_;
+    }
+
+    const Type* words_;      // words of the bitvector
+    std::size_t num_words_;  // # of words in words_
+    std::size_t word_;       // index of current word
+    Type bits_;              // bits of current word not visited yet
+  };
+
+  /**
+   * @brief Range of the positions set to 1, usable in range-for
+   */
+  struct OnesRange {
+    OnesIterator begin() const { return first; }
+    OnesIterator end() const { return last; }
+    OnesIterator first;
+    OnesIterator last;
+  };
+
+  /**
+   * @brief Positions of the bits set to 1 in increasing order
+   *
+   * @return OnesRange range over the positions set
+   */
+  OnesRange ones() const {
+    return {OnesIterator(bits_.data(), bits_.size(), 0),
+            OnesIterator(bits_.data(), bits_.size(), bits_.size())};
+  }
+
  private:
-  std::vector<Type> bits_;  // vector containing bits
-  std::size_t num_bits_;    // number of bits in bits_
+  /**
+   * @brief Set to 0 the bits of the last word past num_bits_
+   */
+  void ClearUnusedBits();
+
+  WordBuffer bits_;       // words containing bits
+  std::size_t num_bits_;  // number of bits in bits_
 };
 
 /**
@@ -338,8 +579,7 @@ class BitvectorReference {
     if (static_cast<bool>(value)) {
       *value_ |= bit_set[position_];
     } else {
-      *value_ &= ((all_set << (position_ + 1)) |
-                  lower_bits_set[position_]);  // mask 1..10..01..1
+      *value_ &= ~bit_set[position_];  // mask 1..10..01..1
     }
     return *this;
   }
@@ -362,19 +602,7 @@ class BitvectorReference {
 // =============== Implementation  ===============
 template <typename T, typename>
 Bitvector& Bitvector::operator>=(const T value) {
-  Bitvector::Type lsbs = 0;
-  Bitvector::Type msbs = 0;
-
-  for (std::size_t i = bits_.size() - 1; i > 0; --i) {
-    lsbs = bits_[i] & lower_bits_set[value];
-    bits_[i] = bits_[i] >> value;
-    bits_[i] = bits_[i] | msbs;
-    msbs = lsbs << (Bitvector::type_size - value);
-  }
-
-  bits_[0] = bits_[0] >> value;
-  bits_[0] = bits_[0] | msbs;
-  return *this;
+  return *this >>= static_cast<std::size_t>(value);
 }
 
 }  // namespace utils
@@ -382,18 +610,16 @@ Bitvector& Bitvector::operator>=(const T value) {
 
 // hashing
 namespace std {
+/**
+ * @brief Hash of the bits of the bitvector, read in place (see
+ * utils::hash_bits)
+ */
 template <>
 struct hash<unialgo::utils::Bitvector> {
   std::size_t operator()(const unialgo::utils::Bitvector& bv) const {
-    size_t seed = 0;
-    for (int value : bv.getBitVec()) {
-      seed ^= std::hash<int>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-    }
-    seed ^= std::hash<size_t>()(bv.getNumBits()) + 0x9e3779b9 + (seed << 6) +
-            (seed >> 2);
-    return seed;
+    return unialgo::utils::hash_bits(bv.data(), bv.size());
   }
-};  // namespace std
+};
 }  // namespace std
 
 #endif  // UNIALGO_UTILS_BITVECTOR_
\ No newline at end of file
@@ -0,0 +1,367 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_BITVECTORVIEW_
+#define UNIALGO_UTILS_BITVECTOR_BITVECTORVIEW_
+
+#include <stdint.h>  // uint64_t
+
+#include <cassert>   // assert
+#include <iterator>  // std::forward_iterator_tag
+
+#include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/bitvector.hpp"
+
+/**
+ * @file This file contains a read-only view on bits owned by someone else
+ *
+ * A view is a pointer, a bit offset and a length: slicing is O(1) and views
+ * can wrap Bitvector, mapped or arena memory. The viewed words must outlive
+ * the view. Since views never write, they can be shared between threads.
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+/**
+ * @brief Class BitvectorView
+ * non-owning read-only view on num_bits bits starting at a bit offset
+ */
+class BitvectorView {
+ public:
+  using Type = uint64_t;                                  // type of words
+  static const std::size_t type_size = sizeof(Type) * 8;  // size of Type in bit
+  static constexpr std::size_t npos = Bitvector::npos;    // no bit found
+
+  /**
+   * @brief Construct an empty view
+   */
+  BitvectorView() : words_(nullptr), offset_(0), num_bits_(0) {}
+
+  /**
+   * @brief Construct a view on bits [offset, offset + num_bits) of words
+   *
+   * @param words first word of the memory viewed
+   * @param num_bits number of bits in the view
+   * @param offset position of the first bit of the view in words
+   */
+  BitvectorView(const Type* words, std::size_t num_bits,
+                std::size_t offset = 0)
+      : words_(words + offset / type_size),
+        offset_(offset % type_size),
+        num_bits_(num_bits) {}
+
+  /**
+   * @brief Construct a view on all the bits of bv
+   */
+  BitvectorView(const Bitvector& bv) : BitvectorView(bv.data(), bv.size()) {}
+
+  /**
+   * @brief Access single bit in the view
+   *
+   * @param bit_pos position of bit to access
+   * @return bool value of bit at bit_pos
+   */
+  bool GetBit(std::size_t bit_pos) const {
+    std::size_t pos = offset_ + bit_pos;
+    return words_[pos / type_size] & bit_set[pos % type_size];
+  }
+
+  bool operator[](std::size_t bit_pos) const { return GetBit(bit_pos); }
+
+  /**
+   * @brief Access single bit in the view
+   *
+   * This checks bounds for access
+   */
+  bool at(std::size_t bit_pos) const {
+    assert(bit_pos < num_bits_ && "BitvectorView access out of bounds");
+    return GetBit(bit_pos);
+  }
+
+  /**
+   * @brief Read len bits starting at bit_pos (bit_pos is the lowest bit)
+   *
+   * @param bit_pos position of first bit to read
+   * @param len number of bits to read (<= 64)
+   * @return uint64_t value of the bits
+   */
+  uint64_t ReadBits(std::size_t bit_pos, uint8_t len) const {
+    std::size_t pos = offset_ + bit_pos;
+    return read_bits(words_ + pos / type_size, pos % type_size, len);
+  }
+
+  /**
+   * @brief Bits [w * 64, w * 64 + 64) of the view, bits past size() are 0
+   *
+   * @param w index of word in the view
+   * @return Type word of the view
+   */
+  Type GetWord(std::size_t w) const {
+    std::size_t begin = w * type_size;
+    Type word = words_[w] >> offset_;
+    if (offset_ && begin + type_size - offset_ < num_bits_)
+      word |= words_[w + 1] << (type_size - offset_);
+    if (begin + type_size > num_bits_)
+      word &= lower_bits_set[num_bits_ - begin];
+    return word;
+  }
+
+  /**
+   * @brief Number of words covering the view
+   */
+  std::size_t numWords() const {
+    return (num_bits_ + type_size - 1) / type_size;
+  }
+
+  /**
+   * @brief View on bits [start, end] of this view (no copy)
+   *
+   * Important: must satisfy: start <= end < size()
+   */
+  BitvectorView slice(std::size_t start, std::size_t end) const {
+    return BitvectorView(words_, end - start + 1, offset_ + start);
+  }
+
+  std::size_t size() const { return num_bits_; }
+  std::size_t getNumBits() const { return num_bits_; }
+
+  /**
+   * @brief Number of bits set to 1 in the view
+   */
+  std::size_t count() const { return countPrefix(num_bits_); }
+
+  /**
+   * @brief Rank on the view, scans the words before indx so it is
+   * O(indx / 64): build a RankHelper for constant time queries
+   *
+   * @param indx index (must be valid)
+   * @param value what to count 0, 1
+   * @return std::size_t # of bits set to value in [0, indx]
+   */
+  std::size_t rank(std::size_t indx, bool value = true) const {
+    std::size_t ones = countPrefix(indx + 1);
+    return value ? ones : indx + 1 - ones;
+  }
+
+  /**
+   * @brief Position of the first bit set to 1, npos if no bit is set
+   */
+  std::size_t find_first() const { return findFrom(0); }
+
+  /**
+   * @brief Position of the first bit set to 1 after pos, npos if there is
+   * none
+   */
+  std::size_t find_next(std::size_t pos) const {
+    if (pos == npos || pos + 1 >= num_bits_) return npos;
+    return findFrom(pos + 1);
+  }
+
+  // iterators and ranges keep a copy of the view (a pointer and two sizes):
+  // they stay valid after a temporary view, as v.slice(a, b).ones(), is gone
+  class ConstIterator;
+  class OnesIterator;
+  struct OnesRange;
+
+  ConstIterator begin() const;
+  ConstIterator end() const;
+  ConstIterator cbegin() const;
+  ConstIterator cend() const;
+
+  /**
+   * @brief Positions of the bits set to 1 in increasing order
+   *
+   * Important: the range refers to the viewed words, they must outlive it
+   */
+  OnesRange ones() const;
+
+  /**
+   * @brief Compare views bit by bit
+   */
+  friend bool operator==(const BitvectorView& a, const BitvectorView& b) {
+    if (a.num_bits_ != b.num_bits_) return false;
+    for (std::size_t w = 0; w < a.numWords(); ++w)
+      if (a.GetWord(w) != b.GetWord(w)) return false;
+    return true;
+  }
+
+  friend bool operator!=(const BitvectorView& a, const BitvectorView& b) {
+    return !(a == b);
+  }
+
+ private:
+  /**
+   * @brief # of bits set to 1 in [0, num_bits)
+   */
+  std::size_t countPrefix(std::size_t num_bits) const {
+    std::size_t full = num_bits / type_size;
+    std::size_t res = 0;
+    if (offset_ == 0) {
+      res = popcount_words(words_, full);
+    } else {
+      for (std::size_t w = 0; w < full; ++w)
+        res += __builtin_popcountll(GetWord(w));
+    }
+    if (num_bits % type_size)
+      res += __builtin_popcountll(GetWord(full) &
+                                  lower_bits_set[num_bits % type_size]);
+    return res;
+  }
+
+  /**
+   * @brief Position of first bit set to 1 at or after pos (pos < size())
+   */
+  std::size_t findFrom(std::size_t pos) const {
+    std::size_t w = pos / type_size;
+    std::size_t num_words = numWords();
+    if (w >= num_words) return npos;
+    Type word = GetWord(w) & (all_set << (pos % type_size));
+    while (!word) {
+      if (++w == num_words) return npos;
+      word = GetWord(w);
+    }
+    return w * type_size + __builtin_ctzll(word);
+  }
+
+  const Type* words_;     // word containing the first bit of the view
+  std::size_t offset_;    // position of the first bit in words_[0]
+  std::size_t num_bits_;  // number of bits in the view
+};
+
+/**
+ * @brief Iterator on the bits of the view
+ */
+class BitvectorView::ConstIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using difference_type = long;
+  using value_type = bool;
+  using pointer = const bool*;
+  using reference = bool;
+
+  ConstIterator(std::size_t bit_pos, const BitvectorView& view)
+      : bit_pos_(bit_pos), view_(view) {}
+
+  reference operator*() const { return view_.GetBit(bit_pos_); }
+
+  ConstIterator& operator++() {
+    bit_pos_++;
+    return *this;
+  }
+
+  ConstIterator operator++(int) {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  friend bool operator==(const ConstIterator& a, const ConstIterator& b) {
+    return a.sameView(b) && a.bit_pos_ == b.bit_pos_;
+  }
+
+  friend bool operator!=(const ConstIterator& a, const ConstIterator& b) {
+    return !(a == b);
+  }
+
+ private:
+  bool sameView(const ConstIterator& other) const {
+    return view_.words_ == other.view_.words_ &&
+           view_.offset_ == other.view_.offset_;
+  }
+
+  std::size_t bit_pos_;  // position of bit in view
+  BitvectorView view_;   // view iterated
+};
+
+/**
+ * @brief Iterator on the positions of the bits set to 1 in the view
+ */
+class BitvectorView::OnesIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using difference_type = long;
+  using value_type = std::size_t;
+  using pointer = const std::size_t*;
+  using reference = std::size_t;
+
+  OnesIterator(const BitvectorView& view, std::size_t word)
+      : view_(view),
+        word_(word),
+        bits_(word < view.numWords() ? view.GetWord(word) : 0) {
+    skipEmpty();
+  }
+
+  reference operator*() const {
+    return word_ * type_size + __builtin_ctzll(bits_);
+  }
+
+  OnesIterator& operator++() {
+    bits_ &= bits_ - 1;  // clear lowest bit set
+    skipEmpty();
+    return *this;
+  }
+
+  OnesIterator operator++(int) {
+    OnesIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  friend bool operator==(const OnesIterator& a, const OnesIterator& b) {
+    return a.sameView(b) && a.word_ == b.word_ && a.bits_ == b.bits_;
+  }
+
+  friend bool operator!=(const OnesIterator& a, const OnesIterator& b) {
+    return !(a == b);
+  }
+
+ private:
+  bool sameView(const OnesIterator& other) const {
+    return view_.words_ == other.view_.words_ &&
+           view_.offset_ == other.view_.offset_;
+  }
+
+  void skipEmpty() {
+    std::size_t num_words = view_.numWords();
+    while (bits_ == 0 && ++word_ < num_words) bits_ = view_.GetWord(word_);
+    if (word_ > num_words) word_ = num_words;
+  }
+
+  BitvectorView view_;  // view iterated
+  std::size_t word_;    // index of current word of the view
+  Type bits_;           // bits of current word not visited yet
+};
+
+/**
+ * @brief Range of the positions set to 1, usable in range-for
+ */
+struct BitvectorView::OnesRange {
+  OnesIterator begin() const { return first; }
+  OnesIterator end() const { return last; }
+  OnesIterator first;
+  OnesIterator last;
+};
+
+inline BitvectorView::ConstIterator BitvectorView::begin() const {
+  return ConstIterator(0, *this);
+}
+
+inline BitvectorView::ConstIterator BitvectorView::end() const {
+  return ConstIterator(num_bits_, *this);
+}
+
+inline BitvectorView::ConstIterator BitvectorView::cbegin() const {
+  return begin();
+}
+
+inline BitvectorView::ConstIterator BitvectorView::cend() const {
+  return end();
+}
+
+inline BitvectorView::OnesRange BitvectorView::ones() const {
+  return {OnesIterator(*this, 0), OnesIterator(*this, numWords())};
+}
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_BITVECTORVIEW_
@@ -0,0 +1,178 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_BUILDERS_
+#define UNIALGO_UTILS_BITVECTOR_BUILDERS_
+
+#include <stdint.h>  // uint64_t
+
+#include <cassert>          // assert
+#include <memory_resource>  // std::pmr::memory_resource
+#include <utility>          // std::move
+
+#include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/bitvector.hpp"
+#include "unialgo/utils/bitvector/wordBuffer.hpp"
+#include "unialgo/utils/bitvector/wordVector.hpp"
+
+/**
+ * @file This file contains append-only builders for Bitvector and WordVector
+ *
+ * Values are packed in a register word that is flushed to the output every
+ * 64 bits, so appending never reads back or masks memory:
+ *
+ *   utils::WordVectorBuilder builder(5);
+ *   for (auto c : text) builder.push_back(code(c));
+ *   utils::WordVector wv = builder.build();
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+/**
+ * @brief Class BitvectorBuilder
+ * builds a Bitvector appending bits at the end
+ */
+class BitvectorBuilder {
+ public:
+  using Type = uint64_t;                                  // type of words
+  static const std::size_t type_size = sizeof(Type) * 8;  // size of Type in bit
+
+  /**
+   * @brief Construct a new builder
+   *
+   * @param resource memory resource the words are allocated from
+   */
+  explicit BitvectorBuilder(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : words_(resource), current_(0), num_bits_(0) {}
+
+  /**
+   * @brief Reserve memory for num_bits bits
+   */
+  void reserve(std::size_t num_bits) {
+    words_.reserve((num_bits + type_size - 1) / type_size);
+  }
+
+  /**
+   * @brief Append a single bit
+   */
+  void push_back(bool bit) {
+    current_ |= static_cast<Type>(bit) << (num_bits_ % type_size);
+    if (++num_bits_ % type_size == 0) flush();
+  }
+
+  /**
+   * @brief Append the len lower bits of word, lowest bit first
+   *
+   * @param word bits to append (bits from len up are ignored)
+   * @param len number of bits to append (<= 64)
+   */
+  void append_bits(Type word, uint8_t len) {
+    word &= lower_bits_set[len];
+    std::size_t offset = num_bits_ % type_size;
+    current_ |= word << offset;
+    num_bits_ += len;
+    if (offset + len >= type_size) {
+      words_.push_back(current_);
+      // bits of word that did not fit in the flushed word
+      current_ = offset ? word >> (type_size - offset) : 0;
+    }
+  }
+
+  /**
+   * @brief Number of bits appended
+   */
+  std::size_t size() const { return num_bits_; }
+
+  /**
+   * @brief Gives the packed words and resets the builder
+   *
+   * @return WordBuffer words with bits appended (bits past size() are 0)
+   */
+  WordBuffer releaseWords() {
+    if (num_bits_ % type_size) words_.push_back(current_);
+    WordBuffer res(std::move(words_));
+    words_.clear();
+    current_ = 0;
+    num_bits_ = 0;
+    return res;
+  }
+
+  /**
+   * @brief Bitvector of the bits appended, the builder is reset
+   */
+  Bitvector build() {
+    std::size_t num_bits = num_bits_;
+    return Bitvector(releaseWords(), num_bits);
+  }
+
+ private:
+  void flush() {
+    words_.push_back(current_);
+    current_ = 0;
+  }
+
+  WordBuffer::Storage words_;  // full words appended
+  Type current_;               // word being filled
+  std::size_t num_bits_;       // number of bits appended
+};
+
+/**
+ * @brief Class WordVectorBuilder
+ * builds a WordVector appending values at the end
+ */
+class WordVectorBuilder {
+ public:
+  using value_type = std::size_t;
+
+  /**
+   * @brief Construct a new builder
+   *
+   * @param word_size size of a single word of the vector built
+   * @param resource memory resource the words are allocated from
+   */
+  explicit WordVectorBuilder(
+      uint8_t word_size = 2,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : bits_(resource), word_size_(word_size), num_words_(0) {}
+
+  /**
+   * @brief Reserve memory for num_words values
+   */
+  void reserve(std::size_t num_words) {
+    bits_.reserve(num_words * word_size_);
+  }
+
+  /**
+   * @brief Append value (bits past word_size are ignored)
+   */
+  void push_back(value_type value) {
+    bits_.append_bits(value, word_size_);
+    ++num_words_;
+  }
+
+  /**
+   * @brief Number of values appended
+   */
+  std::size_t size() const { return num_words_; }
+
+  uint8_t getWordSize() const { return word_size_; }
+
+  /**
+   * @brief WordVector of the values appended, the builder is reset
+   */
+  WordVector build() {
+    std::size_t num_words = num_words_;
+    num_words_ = 0;
+    return WordVector(bits_.releaseWords(), num_words, word_size_);
+  }
+
+ private:
+  BitvectorBuilder bits_;  // packed values
+  uint8_t word_size_;      // size of a single word
+  std::size_t num_words_;  // number of values appended
+};
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_BUILDERS_
@@ -0,0 +1,154 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_CONCURRENTBITVECTOR_
+#define UNIALGO_UTILS_BITVECTOR_CONCURRENTBITVECTOR_
+
+#include <stdint.h>  // uint64_t
+
+#include <atomic>           // std::atomic_ref, std::memory_order
+#include <cassert>          // assert
+#include <memory_resource>  // std::pmr::memory_resource
+#include <utility>          // std::move
+
+#include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/bitvector.hpp"
+#include "unialgo/utils/bitvector/wordBuffer.hpp"
+
+/**
+ * @file This file contains a bitvector that many threads can write at once
+ *
+ * Bitvector::SetBit and BitvectorReference::operator= read, modify and write
+ * a whole word, so two threads setting bits of the same word lose updates.
+ * ConcurrentBitvector sets and clears bits with atomic fetch_or / fetch_and
+ * on the word. When the writers are done (threads joined) freeze() hands the
+ * words to a normal Bitvector without copying them:
+ *
+ *   utils::ConcurrentBitvector marks(n);
+ *   // threads: marks.SetBit(pos);
+ *   utils::Bitvector bv = std::move(marks).freeze();
+ *   utils::RankHelper rank(std::make_shared<utils::Bitvector>(std::move(bv)));
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+class ConcurrentBitvector {
+ public:
+  using Type = uint64_t;                                  // type of words
+  static const std::size_t type_size = sizeof(Type) * 8;  // size of Type in bit
+
+  /**
+   * @brief Construct a new Concurrent Bitvector object
+   *
+   * @param num_bits number of bits to store (all set to 0)
+   * @param resource memory resource the words are allocated from
+   */
+  explicit ConcurrentBitvector(
+      std::size_t num_bits = 0,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : words_((num_bits + type_size - 1) / type_size, 0, resource),
+        num_bits_(num_bits) {}
+
+  /**
+   * @brief Construct a new Concurrent Bitvector object with the bits of bv
+   */
+  explicit ConcurrentBitvector(const Bitvector& bv)
+      : words_(bv.data(), bv.data() + (bv.size() + type_size - 1) / type_size),
+        num_bits_(bv.size()) {}
+
+  ConcurrentBitvector(ConcurrentBitvector&&) = default;
+  ConcurrentBitvector& operator=(ConcurrentBitvector&&) = default;
+
+  // copies of a vector being written are never consistent
+  ConcurrentBitvector(const ConcurrentBitvector&) = delete;
+  ConcurrentBitvector& operator=(const ConcurrentBitvector&) = delete;
+
+  /**
+   * @brief Set bit at bit_pos to 1 (safe with concurrent writers)
+   */
+  void SetBit(std::size_t bit_pos,
+              std::memory_order order = std::memory_order_relaxed) {
+    word(bit_pos).fetch_or(bit_set[bit_pos % type_size], order);
+  }
+
+  /**
+   * @brief Set bit at bit_pos to 0 (safe with concurrent writers)
+   */
+  void ClearBit(std::size_t bit_pos,
+                std::memory_order order = std::memory_order_relaxed) {
+    word(bit_pos).fetch_and(~bit_set[bit_pos % type_size], order);
+  }
+
+  /**
+   * @brief Set bit at bit_pos to 1
+   *
+   * Of many threads setting the same bit exactly one sees false
+   *
+   * @return bool value of the bit before setting it
+   */
+  bool TestAndSet(std::size_t bit_pos,
+                  std::memory_order order = std::memory_order_relaxed) {
+    Type mask = bit_set[bit_pos % type_size];
+    return word(bit_pos).fetch_or(mask, order) & mask;
+  }
+
+  /**
+   * @brief Set bit at bit_pos to 0
+   *
+   * @return bool value of the bit before clearing it
+   */
+  bool TestAndClear(std::size_t bit_pos,
+                    std::memory_order order = std::memory_order_relaxed) {
+    Type mask = bit_set[bit_pos % type_size];
+    return word(bit_pos).fetch_and(~mask, order) & mask;
+  }
+
+  /**
+   * @brief Sets to 1 the bits of mask in the w-th word (a fetch_or per word
+   * for writers producing many bits at once)
+   */
+  void OrWord(std::size_t w, Type mask,
+              std::memory_order order = std::memory_order_relaxed) {
+    std::atomic_ref<Type>(words_[w]).fetch_or(mask, order);
+  }
+
+  /**
+   * @brief Value of bit at bit_pos (atomic load)
+   */
+  bool GetBit(std::size_t bit_pos,
+              std::memory_order order = std::memory_order_relaxed) const {
+    return std::atomic_ref<Type>(const_cast<Type&>(words_[bit_pos / type_size]))
+               .load(order) &
+           bit_set[bit_pos % type_size];
+  }
+
+  std::size_t size() const { return num_bits_; }
+  std::size_t getNumBits() const { return num_bits_; }
+
+  /**
+   * @brief Moves the words in a Bitvector (no copy), the concurrent
+   * bitvector is left empty
+   *
+   * Important: every writer must be done (e.g. threads joined)
+   *
+   * @return Bitvector with the bits written
+   */
+  Bitvector freeze() && {
+    std::size_t num_bits = num_bits_;
+    num_bits_ = 0;
+    return Bitvector(WordBuffer(std::move(words_)), num_bits);
+  }
+
+ private:
+  std::atomic_ref<Type> word(std::size_t bit_pos) {
+    assert(bit_pos < num_bits_ && "ConcurrentBitvector access out of bounds");
+    return std::atomic_ref<Type>(words_[bit_pos / type_size]);
+  }
+
+  WordBuffer::Storage words_;  // words containing the bits
+  std::size_t num_bits_;       // number of bits stored
+};
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_CONCURRENTBITVECTOR_
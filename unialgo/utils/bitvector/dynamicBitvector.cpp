@@ -0,0 +1,361 @@
+#include "unialgo/utils/bitvector/dynamicBitvector.hpp"
+
+#include <algorithm>  // std::min, std::fill
+#include <cassert>    // assert
+#include <iterator>   // std::make_move_iterator
+#include <utility>    // std::move, std::swap
+
+#include "unialgo/utils/bitvector/bitMaps.hpp"
+
+namespace unialgo {
+namespace utils {
+
+namespace {
+using Type = DynamicBitvector::Type;
+constexpr std::size_t type_size = DynamicBitvector::type_size;
+
+/**
+ * @brief Copies len bits of src from bit src_pos to dst from bit dst_pos
+ */
+void copy_bits(Type* dst, std::size_t dst_pos, const Type* src,
+               std::size_t src_pos, std::size_t len) {
+  for (std::size_t done = 0; done < len; done += type_size) {
+    uint8_t chunk = std::min(type_size, len - done);
+    std::size_t from = src_pos + done;
+    std::size_t to = dst_pos + done;
+    write_bits(dst + to / type_size,
+               read_bits(src + from / type_size, from % type_size, chunk),
+               to % type_size, chunk);
+  }
+}
+
+/**
+ * @brief # of 1s in the first len bits of words
+ */
+std::size_t count_ones(const Type* words, std::size_t len) {
+  std::size_t res = 0;
+  for (std::size_t w = 0; w < len / type_size; ++w)
+    res += __builtin_popcountll(words[w]);
+  if (len % type_size)
+    res += __builtin_popcountll(words[len / type_size] &
+                                lower_bits_set[len % type_size]);
+  return res;
+}
+
+/**
+ * @brief Inserts bit at pos in the n bits of words (the bits after n must
+ * be 0 and there must be room for n + 1 bits)
+ */
+void insert_bit(Type* words, std::size_t n, std::size_t pos, bool bit) {
+  std::size_t w = pos / type_size;
+  std::size_t offset = pos % type_size;
+  // every word after w moves up a bit, taking the top bit of the one before
+  for (std::size_t i = n / type_size; i > w; --i)
+    words[i] = words[i] << 1 | words[i - 1] >> (type_size - 1);
+  Type low = words[w] & lower_bits_set[offset];
+  Type high = words[w] & ~lower_bits_set[offset];
+  words[w] = low | high << 1 | Type{bit} << offset;
+}
+
+/**
+ * @brief Removes the bit at pos from the n bits of words, the bits after
+ * n - 1 are left to 0
+ *
+ * @return bool bit removed
+ */
+bool erase_bit(Type* words, std::size_t n, std::size_t pos) {
+  std::size_t w = pos / type_size;
+  std::size_t offset = pos % type_size;
+  std::size_t last = (n - 1) / type_size;
+  bool bit = (words[w] >> offset) & 1;
+  Type low = words[w] & lower_bits_set[offset];
+  Type high = (words[w] >> 1) & ~lower_bits_set[offset];
+  words[w] = low | high;
+  // every word after w moves down a bit, its lowest bit goes to the top of
+  // the word before
+  for (std::size_t i = w + 1; i <= last; ++i) {
+    words[i - 1] |= words[i] << (type_size - 1);
+    words[i] >>= 1;
+  }
+  return bit;
+}
+}  // namespace
+
+DynamicBitvector::DynamicBitvector() : root_(makeLeaf(nullptr, 0, 0)) {}
+
+DynamicBitvector::DynamicBitvector(const Bitvector& bv) {
+  const std::size_t n = bv.size();
+  std::vector<std::unique_ptr<Node>> level;
+  for (std::size_t begin = 0; begin < n; begin += leaf_bits / 2)
+    level.push_back(makeLeaf(bv.data(), begin,
+                             std::min(leaf_bits / 2, n - begin)));
+  if (level.empty()) level.push_back(makeLeaf(nullptr, 0, 0));
+  // levels of half full nodes up to the root
+  while (level.size() > 1) {
+    std::vector<std::unique_ptr<Node>> parents;
+    for (std::size_t i = 0; i < level.size(); i += fanout / 2) {
+      auto node = std::make_unique<Node>();
+      node->leaf = false;
+      std::size_t end = std::min(level.size(), i + fanout / 2);
+      for (std::size_t c = i; c < end; ++c)
+        node->children.push_back(std::move(level[c]));
+      update(*node);
+      parents.push_back(std::move(node));
+    }
+    level = std::move(parents);
+  }
+  root_ = std::move(level[0]);
+}
+
+DynamicBitvector::DynamicBitvector(const DynamicBitvector& other)
+    : root_(other.root_ ? clone(*other.root_) : nullptr) {}
+
+DynamicBitvector& DynamicBitvector::operator=(const DynamicBitvector& other) {
+  if (this != &other) root_ = other.root_ ? clone(*other.root_) : nullptr;
+  return *this;
+}
+
+std::unique_ptr<DynamicBitvector::Node> DynamicBitvector::makeLeaf(
+    const Type* bits, std::size_t begin, std::size_t len) {
+  auto node = std::make_unique<Node>();
+  node->leaf = true;
+  node->words.fill(0);
+  if (len) copy_bits(node->words.data(), 0, bits, begin, len);
+  node->size = len;
+  node->ones = count_ones(node->words.data(), len);
+  return node;
+}
+
+std::unique_ptr<DynamicBitvector::Node> DynamicBitvector::clone(
+    const Node& node) {
+  auto res = std::make_unique<Node>();
+  res->leaf = node.leaf;
+  res->size = node.size;
+  res->ones = node.ones;
+  res->words = node.words;
+  for (const auto& child : node.children)
+    res->children.push_back(clone(*child));
+  return res;
+}
+
+void DynamicBitvector::update(Node& node) {
+  node.size = node.ones = 0;
+  for (const auto& child : node.children) {
+    node.size += child->size;
+    node.ones += child->ones;
+  }
+}
+
+bool DynamicBitvector::underflow(const Node& node) {
+  return node.leaf ? node.size < leaf_bits / 4
+                   : node.children.size() < fanout / 4;
+}
+
+std::size_t DynamicBitvector::size() const {
+  return root_ ? root_->size : 0;
+}
+
+std::size_t DynamicBitvector::countOnes() const {
+  return root_ ? root_->ones : 0;
+}
+
+std::size_t DynamicBitvector::height() const {
+  std::size_t res = 0;
+  for (const Node* node = root_.get(); node;
+       node = node->leaf ? nullptr : node->children[0].get())
+    ++res;
+  return res;
+}
+
+bool DynamicBitvector::GetBit(std::size_t pos) const {
+  assert(pos < size() && "GetBit out of range");
+  const Node* node = root_.get();
+  while (!node->leaf) {
+    std::size_t i = 0;
+    while (pos >= node->children[i]->size) pos -= node->children[i++]->size;
+    node = node->children[i].get();
+  }
+  return (node->words[pos / type_size] >> (pos % type_size)) & 1;
+}
+
+std::size_t DynamicBitvector::rank(std::size_t indx, bool value) const {
+  assert(indx < size() && "rank out of range");
+  // 1s in the first pos bits
+  std::size_t pos = indx + 1;
+  std::size_t ones = 0;
+  const Node* node = root_.get();
+  while (!node->leaf) {
+    std::size_t i = 0;
+    while (pos > node->children[i]->size) {
+      ones += node->children[i]->ones;
+      pos -= node->children[i++]->size;
+    }
+    node = node->children[i].get();
+  }
+  ones += count_ones(node->words.data(), pos);
+  return value ? ones : indx + 1 - ones;
+}
+
+std::size_t DynamicBitvector::select(std::size_t count, bool value) const {
+  std::size_t total = value ? countOnes() : size() - countOnes();
+  if (count == 0 || count > total) return -1;
+  std::size_t pos = 0;
+  const Node* node = root_.get();
+  while (!node->leaf) {
+    for (const auto& child : node->children) {
+      std::size_t in_child = value ? child->ones : child->size - child->ones;
+      if (count <= in_child) {
+        node = child.get();
+        break;
+      }
+      count -= in_child;
+      pos += child->size;
+    }
+  }
+  for (std::size_t w = 0;; ++w) {
+    // bits past the end of the leaf are 0, they are never selected as 0s
+    // since count is at most the 0s of the leaf
+    Type word = value ? node->words[w] : ~node->words[w];
+    std::size_t in_word = __builtin_popcountll(word);
+    if (count <= in_word)
+      return pos + w * type_size + select_in_word(word, count - 1);
+    count -= in_word;
+  }
+}
+
+std::unique_ptr<DynamicBitvector::Node> DynamicBitvector::insert(
+    Node& node, std::size_t pos, bool bit) {
+  if (node.leaf) {
+    std::unique_ptr<Node> right;
+    Node* target = &node;
+    if (node.size == leaf_bits) {
+      std::size_t half = leaf_bits / 2;
+      right = makeLeaf(node.words.data(), half, leaf_bits - half);
+      std::fill(node.words.begin() + half / type_size, node.words.end(), 0);
+      node.size = half;
+      node.ones -= right->ones;
+      if (pos > half) {
+        pos -= half;
+        target = right.get();
+      }
+    }
+    insert_bit(target->words.data(), target->size, pos, bit);
+    ++target->size;
+    target->ones += bit;
+    return right;
+  }
+
+  std::size_t i = 0;
+  while (pos > node.children[i]->size) pos -= node.children[i++]->size;
+  auto right = insert(*node.children[i], pos, bit);
+  ++node.size;
+  node.ones += bit;
+  if (!right) return nullptr;
+  node.children.insert(node.children.begin() + i + 1, std::move(right));
+  if (node.children.size() <= fanout) return nullptr;
+  auto split = std::make_unique<Node>();
+  split->leaf = false;
+  std::size_t half = node.children.size() / 2;
+  split->children.assign(
+      std::make_move_iterator(node.children.begin() + half),
+      std::make_move_iterator(node.children.end()));
+  node.children.resize(half);
+  update(node);
+  update(*split);
+  return split;
+}
+
+void DynamicBitvector::insert(std::size_t pos, bool bit) {
+  assert(pos <= size() && "insert out of range");
+  if (!root_) root_ = makeLeaf(nullptr, 0, 0);
+  auto right = insert(*root_, pos, bit);
+  if (!right) return;
+  // the root split: the tree grows a level
+  auto root = std::make_unique<Node>();
+  root->leaf = false;
+  root->children.push_back(std::move(root_));
+  root->children.push_back(std::move(right));
+  update(*root);
+  root_ = std::move(root);
+}
+
+bool DynamicBitvector::erase(Node& node, std::size_t pos) {
+  if (node.leaf) {
+    bool bit = erase_bit(node.words.data(), node.size, pos);
+    --node.size;
+    node.ones -= bit;
+    return bit;
+  }
+  std::size_t i = 0;
+  while (pos >= node.children[i]->size) pos -= node.children[i++]->size;
+  bool bit = erase(*node.children[i], pos);
+  --node.size;
+  node.ones -= bit;
+  if (underflow(*node.children[i])) rebalance(node, i);
+  return bit;
+}
+
+bool DynamicBitvector::erase(std::size_t pos) {
+  assert(pos < size() && "erase out of range");
+  bool bit = erase(*root_, pos);
+  // a root with a single child is not needed
+  while (!root_->leaf && root_->children.size() == 1) {
+    std::unique_ptr<Node> child = std::move(root_->children[0]);
+    root_ = std::move(child);
+  }
+  return bit;
+}
+
+void DynamicBitvector::rebalance(Node& node, std::size_t i) {
+  if (node.children.size() < 2) return;
+  std::size_t l = i + 1 < node.children.size() ? i : i - 1;
+  Node& a = *node.children[l];
+  Node& b = *node.children[l + 1];
+  bool merge;
+  if (a.leaf) {
+    std::size_t total = a.size + b.size;
+    Type bits[2 * leaf_words] = {};
+    copy_bits(bits, 0, a.words.data(), 0, a.size);
+    copy_bits(bits, a.size, b.words.data(), 0, b.size);
+    merge = total <= leaf_bits;
+    std::size_t first = merge ? total : total / 2;
+    node.children[l] = makeLeaf(bits, 0, first);
+    if (!merge) node.children[l + 1] = makeLeaf(bits, first, total - first);
+  } else {
+    a.children.insert(a.children.end(),
+                      std::make_move_iterator(b.children.begin()),
+                      std::make_move_iterator(b.children.end()));
+    b.children.clear();
+    merge = a.children.size() <= fanout;
+    if (!merge) {
+      std::size_t half = a.children.size() / 2;
+      b.children.assign(std::make_move_iterator(a.children.begin() + half),
+                        std::make_move_iterator(a.children.end()));
+      a.children.resize(half);
+      update(b);
+    }
+    update(a);
+  }
+  if (merge) node.children.erase(node.children.begin() + l + 1);
+}
+
+void DynamicBitvector::set(std::size_t pos, bool bit) {
+  assert(pos < size() && "set out of range");
+  if (GetBit(pos) == bit) return;
+  // the # of 1s changes on the whole path
+  Node* node = root_.get();
+  while (true) {
+    if (bit)
+      ++node->ones;
+    else
+      --node->ones;
+    if (node->leaf) break;
+    std::size_t i = 0;
+    while (pos >= node->children[i]->size) pos -= node->children[i++]->size;
+    node = node->children[i].get();
+  }
+  node->words[pos / type_size] ^= Type{1} << (pos % type_size);
+}
+
+}  // namespace utils
+}  // namespace unialgo
@@ -0,0 +1,138 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_DYNAMIC_BITVECTOR_
+#define UNIALGO_UTILS_BITVECTOR_DYNAMIC_BITVECTOR_
+
+#include <stdint.h>  // uint64_t
+
+#include <array>   // std::array
+#include <memory>  // std::unique_ptr
+#include <vector>  // std::vector
+
+#include "unialgo/utils/bitvector/bitvector.hpp"
+
+/**
+ * @file This file contains a dynamic bitvector with rank and select
+ *
+ * Bits are stored in a B-tree: leaves hold up to leaf_bits packed bits,
+ * internal nodes up to fanout children, and every node knows the # of bits
+ * and of 1s below it. Access, rank, select, insert, erase and set go down a
+ * single path, O(log(n)) nodes with O(fanout + leaf_words) work each.
+ * Leaves split in halves when full and are merged with (or refilled from) a
+ * sibling when they fall under a quarter, internal nodes do the same on
+ * their children:
+ *
+ *   utils::DynamicBitvector bv;
+ *   bv.push_back(true);
+ *   bv.insert(0, false);
+ *   bv.rank(1);  // 1
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+class DynamicBitvector {
+ public:
+  using Type = uint64_t;                                  // type of words
+  static const std::size_t type_size = sizeof(Type) * 8;  // size of Type in bit
+  static constexpr std::size_t leaf_words = 16;           // words of a leaf
+  static constexpr std::size_t leaf_bits =
+      leaf_words * type_size;                   // max bits in a leaf
+  static constexpr std::size_t fanout = 16;  // max children of a node
+
+  DynamicBitvector();
+
+  /**
+   * @brief Construct a new Dynamic Bitvector object with the bits of bv
+   *
+   * Leaves are filled to half, so that the first inserts do not split
+   */
+  explicit DynamicBitvector(const Bitvector& bv);
+
+  ~DynamicBitvector() = default;
+
+  DynamicBitvector(const DynamicBitvector& other);
+  DynamicBitvector(DynamicBitvector&& other) noexcept = default;
+
+  DynamicBitvector& operator=(const DynamicBitvector& other);
+  DynamicBitvector& operator=(DynamicBitvector&& other) noexcept = default;
+
+  /**
+   * @brief Number of bits
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief Number of bits set
+   */
+  std::size_t countOnes() const;
+
+  bool GetBit(std::size_t pos) const;
+  bool operator[](std::size_t pos) const { return GetBit(pos); }
+
+  /**
+   * @brief # of bits set to value in [0, indx]
+   */
+  std::size_t rank(std::size_t indx, bool value = true) const;
+
+  /**
+   * @brief Position of the count-th bit set to value
+   *
+   * @param count i-th occurrence searched (starting from 1)
+   * @param value value of the bit searched
+   * @return std::size_t position of the bit, -1 if there are less than
+   * count bits set to value
+   */
+  std::size_t select(std::size_t count, bool value = true) const;
+
+  /**
+   * @brief Inserts bit before position pos (pos == size() appends)
+   */
+  void insert(std::size_t pos, bool bit);
+  void push_back(bool bit) { insert(size(), bit); }
+
+  /**
+   * @brief Removes the bit in position pos
+   *
+   * @return bool value of the bit removed
+   */
+  bool erase(std::size_t pos);
+
+  /**
+   * @brief Sets the bit in position pos to bit
+   */
+  void set(std::size_t pos, bool bit);
+
+  /**
+   * @brief Number of levels of the tree (1 = a single leaf)
+   */
+  std::size_t height() const;
+
+ private:
+  struct Node {
+    bool leaf;
+    std::size_t size;                             // bits below the node
+    std::size_t ones;                             // 1s below the node
+    std::array<Type, leaf_words> words;           // bits of a leaf
+    std::vector<std::unique_ptr<Node>> children;  // children of a node
+  };
+
+  static std::unique_ptr<Node> makeLeaf(const Type* bits, std::size_t begin,
+                                        std::size_t len);
+  static std::unique_ptr<Node> clone(const Node& node);
+  static void update(Node& node);  // size and ones from the children
+  static bool underflow(const Node& node);
+
+  // insert / erase in the subtree of node, insert returns the right half
+  // of node if it had to split
+  static std::unique_ptr<Node> insert(Node& node, std::size_t pos, bool bit);
+  static bool erase(Node& node, std::size_t pos);
+  // merges children i and a sibling, or shares their content evenly
+  static void rebalance(Node& node, std::size_t i);
+
+  std::unique_ptr<Node> root_;  // root of the tree (a leaf when small)
+};
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_DYNAMIC_BITVECTOR_
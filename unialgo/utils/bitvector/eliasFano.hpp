@@ -0,0 +1,254 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_ELIASFANO_
+#define UNIALGO_UTILS_BITVECTOR_ELIASFANO_
+
+#include <stdint.h>  // uint64_t
+
+#include <memory>           // shared_ptr, std::allocate_shared
+#include <memory_resource>  // std::pmr::polymorphic_allocator
+#include <utility>          // std::move
+
+#include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/bitvector.hpp"
+#include "unialgo/utils/bitvector/builders.hpp"
+#include "unialgo/utils/bitvector/rankHelper.hpp"
+#include "unialgo/utils/bitvector/wordVector.hpp"
+
+/**
+ * @file This file contains an Elias-Fano encoded sparse bitvector with rank
+ * and select
+ *
+ * The m positions of the 1s in n bits are split in low_bits low bits
+ * (low_bits = floor(log2(n / m)), packed in a WordVector) and high bits,
+ * stored in unary in a bitvector of m + n / 2^low_bits + 1 bits. This takes
+ * about m * (2 + log2(n / m)) bits: for sparse bitvectors it is far less than
+ * n. Select on 1s is a select on the high bits, rank is a select on 0s of
+ * the high bits followed by a scan of the (short) bucket.
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+class EliasFanoBitvector {
+ public:
+  static const bool stores_bits = true;  // bits are kept encoded
+
+  EliasFanoBitvector() : num_bits_(0), num_ones_(0), low_bits_(0) {}
+
+  /**
+   * @brief Construct a new Elias Fano Bitvector object
+   *
+   * @param bv bitvector to encode
+   * @param num_threads unused, the positions are encoded in a single pass
+   * (same arguments of RankHelper)
+   * @param resource memory resource the low and high bits (and the rank
+   * support of the high ones) are allocated from
+   */
+  EliasFanoBitvector(
+      std::shared_ptr<unialgo::utils::Bitvector> bv,
+      [[maybe_unused]] std::size_t num_threads = 1,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : EliasFanoBitvector(*bv, resource) {}
+
+  EliasFanoBitvector(
+      const unialgo::utils::Bitvector& bv,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : num_bits_(bv.size()), num_ones_(bv.count()), low_bits_(0) {
+    init(bv, resource);
+  }
+
+  ~EliasFanoBitvector() = default;
+  EliasFanoBitvector(const EliasFanoBitvector&) = default;
+  EliasFanoBitvector(EliasFanoBitvector&&) = default;
+  EliasFanoBitvector& operator=(const EliasFanoBitvector&) = default;
+  EliasFanoBitvector& operator=(EliasFanoBitvector&&) = default;
+
+  /**
+   * @brief Rank on the encoded bits
+   *
+   * @param indx index (must be valid)
+   * @return std::size_t # of bits set to 1 in [0, indx] (returns 0 if empty)
+   */
+  std::size_t rank(std::size_t indx) const {
+    if (num_ones_ == 0) return 0;
+    std::size_t pos = 0;
+    std::size_t ones = bucketStart(indx >> low_bits_, pos);
+    uint64_t low = indx & lower_bits_set[low_bits_];
+    while (pos < high_->size() && high_->GetBit(pos) && lowAt(ones) <= low) {
+      ++pos;
+      ++ones;
+    }
+    return ones;
+  }
+
+  /**
+   * @brief Rank on the encoded bits
+   *
+   * @param indx index (must be valid)
+   * @param value what to count 0, 1
+   * @return std::size_t # of bits set to value [0, indx] (returns 0 if empty)
+   */
+  std::size_t rank(std::size_t indx, bool value) const {
+    if (num_bits_ == 0) return 0;
+    if (value) return rank(indx);  // count 1
+    return indx - rank(indx) + 1;  // count 0
+  }
+
+  /**
+   * @brief Counter of value from start to end
+   *
+   * @param start range
+   * @param end range
+   * @param value what to count 0, 1
+   * @return std::size_t # ob bits set to value in [start, end]
+   */
+  std::size_t rank(std::size_t start, std::size_t end, bool value) const {
+    if (start == 0) return rank(end, value);
+    std::size_t r_end = rank(end, value);
+    std::size_t r_start = rank(start - 1, value);
+    if (r_end <= r_start) return 0;
+    return r_end - r_start;
+  }
+
+  /**
+   * @brief Select on the encoded bits
+   *
+   * Select on 1s is a select on the high bits. Select on 0s binary searches
+   * the 1s: the count-th 0 comes after the j 1s with less than count 0s
+   * before them, this is O(log(m)) selects
+   *
+   * @param count i-th element searched
+   * @param value what to search 0, 1
+   * @return std::size_t position in bv of the i-th value, -1 if not present
+   * (returns 0 if empty)
+   */
+  std::size_t select(std::size_t count, bool value) const {
+    if (num_bits_ == 0) return 0;
+    if (count == 0 || count > GetTotal(value)) return -1;
+    if (value) return position(count - 1);
+
+    // first 1 with at least count 0s before it
+    std::size_t lo = 0;
+    std::size_t hi = num_ones_;
+    while (lo < hi) {
+      std::size_t mid = lo + (hi - lo) / 2;
+      if (position(mid) - mid < count)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return count - 1 + lo;
+  }
+
+  /**
+   * @brief Access single bit
+   *
+   * @param bit_pos position of bit to access
+   * @return bool value of bit at bit_pos
+   */
+  bool GetBit(std::size_t bit_pos) const {
+    if (num_ones_ == 0) return false;
+    std::size_t pos = 0;
+    std::size_t ones = bucketStart(bit_pos >> low_bits_, pos);
+    uint64_t low = bit_pos & lower_bits_set[low_bits_];
+    for (; pos < high_->size() && high_->GetBit(pos); ++pos, ++ones) {
+      uint64_t value = lowAt(ones);
+      if (value >= low) return value == low;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Number of bits set to value in the bitvector
+   *
+   * @param value what to count 0, 1
+   * @return std::size_t # of bits set to value
+   */
+  std::size_t GetTotal(bool value) const {
+    return value ? num_ones_ : num_bits_ - num_ones_;
+  }
+
+  /**
+   * @brief Size of the encoded bitvector
+   *
+   * @return std::size_t number of bits
+   */
+  std::size_t size() const { return num_bits_; }
+
+  /**
+   * @brief Memory used by low bits, high bits and the select support on them
+   *
+   * @return std::size_t # of bits used (compare with size())
+   */
+  std::size_t GetSizeInBits() const {
+    if (num_ones_ == 0) return 0;
+    return low_.getNumBits() + high_->size() +
+           high_helper_.GetRankOverhead() + high_helper_.GetSelectOverhead();
+  }
+
+ private:
+  /**
+   * @brief Low bits of the i-th 1
+   */
+  uint64_t lowAt(std::size_t i) const {
+    return low_bits_ ? low_[i].getValue() : 0;
+  }
+
+  /**
+   * @brief Position of the i-th 1 (0 based)
+   */
+  std::size_t position(std::size_t i) const {
+    std::size_t high = high_helper_.select(i + 1, true) - i;
+    return (high << low_bits_) | lowAt(i);
+  }
+
+  /**
+   * @brief First bit of bucket high in high_ (saved in pos)
+   *
+   * @return std::size_t # of 1s in the buckets before high
+   */
+  std::size_t bucketStart(std::size_t high, std::size_t& pos) const {
+    pos = high ? high_helper_.select(high, false) + 1 : 0;
+    return pos - high;
+  }
+
+  /**
+   * @brief Splits the positions of the 1s of bv in low and high bits
+   */
+  void init(const unialgo::utils::Bitvector& bv,
+            std::pmr::memory_resource* resource) {
+    if (num_ones_ == 0) return;
+    if (num_bits_ > num_ones_)
+      low_bits_ = 63 - __builtin_clzll(num_bits_ / num_ones_);
+    WordVectorBuilder low(low_bits_, resource);
+    BitvectorBuilder high(resource);
+    low.reserve(num_ones_);
+    high.reserve(num_ones_ + (num_bits_ >> low_bits_) + 1);
+    std::size_t bucket = 0;  // buckets closed so far (0s appended)
+    for (std::size_t pos : bv.ones()) {
+      for (; bucket < (pos >> low_bits_); ++bucket) high.push_back(false);
+      high.push_back(true);
+      if (low_bits_) low.push_back(pos & lower_bits_set[low_bits_]);
+    }
+    for (; bucket <= (num_bits_ >> low_bits_); ++bucket) high.push_back(false);
+    if (low_bits_) low_ = low.build();
+    // the control block is allocated next to the bits, from resource
+    high_ = std::allocate_shared<Bitvector>(
+        std::pmr::polymorphic_allocator<Bitvector>(resource), high.build());
+    high_helper_ = RankHelper(high_, 1, resource);
+  }
+
+  std::size_t num_bits_;  // size of the encoded bitvector
+  std::size_t num_ones_;  // # of 1s in the bitvector
+  uint8_t low_bits_;      // # of low bits of a position stored in low_
+  unialgo::utils::WordVector low_;  // low bits of the positions of the 1s
+  std::shared_ptr<unialgo::utils::Bitvector>
+      high_;                 // high bits of the positions in unary
+  RankHelper high_helper_;  // rank and select on high_
+
+};  // EliasFanoBitvector
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_ELIASFANO_
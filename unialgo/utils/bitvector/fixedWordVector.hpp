@@ -0,0 +1,290 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_FIXEDWORDVECTOR_
+#define UNIALGO_UTILS_BITVECTOR_FIXEDWORDVECTOR_
+
+#include <stdint.h>  // uint64_t
+
+#include <algorithm>  // std::copy
+#include <cassert>    // assert
+#include <cstddef>    // std::ptrdiff_t
+#include <iterator>   // std::random_access_iterator_tag
+
+#include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/wordBuffer.hpp"
+#include "unialgo/utils/bitvector/wordVector.hpp"
+
+/**
+ * @file This file contains a WordVector with the word size fixed at compile
+ * time
+ *
+ * Values are packed as in WordVector (value i at bit i * W). When W divides
+ * 64 a value never straddles two words, so access is a shift and a mask with
+ * constants and scans over whole words can be vectorized by the compiler.
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+/**
+ * @brief Class FixedWordVector
+ * vector of words of W bits
+ *
+ * @tparam W size of a word in bits (1 <= W <= 64)
+ */
+template <uint8_t W>
+class FixedWordVector {
+  static_assert(W >= 1 && W <= 64, "word size must be in [1, 64]");
+
+ public:
+  using Type = uint64_t;                                  // type used in vector
+  using value_type = std::size_t;                         // type of a word
+  static const std::size_t type_size = sizeof(Type) * 8;  // size of Type
+  static const uint8_t word_size = W;                     // size of a word
+  static const bool aligned = type_size % W == 0;  // words never straddle
+  static const std::size_t words_per_type =
+      type_size / W;  // whole words in a Type
+  static const Type mask = W == type_size ? ~Type(0) : (Type(1) << W) - 1;
+
+  class Reference;
+  class ConstIterator;
+
+  /**
+   * @brief Construct a new Fixed Word Vector object
+   *
+   * @param num_words num words to store in vector (all set to 0)
+   */
+  explicit FixedWordVector(std::size_t num_words = 0)
+      : bits_((num_words * W + type_size - 1) / type_size),
+        num_words_(num_words) {}
+
+  /**
+   * @brief Construct a new Fixed Word Vector object with the values of wv
+   *
+   * Important: wv.getWordSize() must be W
+   */
+  explicit FixedWordVector(const WordVector& wv) : FixedWordVector(wv.size()) {
+    assert(wv.getWordSize() == W && "word size not matching");
+    std::copy(wv.data(), wv.data() + bits_.size(), bits_.data());
+  }
+
+  /**
+   * @brief Value of word at pos (unchecked)
+   */
+  value_type get(std::size_t pos) const {
+    if constexpr (aligned) {
+      return (bits_[pos / words_per_type] >> (pos % words_per_type * W)) &
+             mask;
+    } else {
+      std::size_t bit = pos * W;
+      return read_bits(bits_.data() + bit / type_size, bit % type_size, W);
+    }
+  }
+
+  /**
+   * @brief Set word at pos to value (bits past W are ignored, unchecked)
+   */
+  void set(std::size_t pos, value_type value) {
+    if constexpr (aligned) {
+      std::size_t shift = pos % words_per_type * W;
+      Type& word = bits_[pos / words_per_type];
+      word = (word & ~(mask << shift)) | ((value & mask) << shift);
+    } else {
+      std::size_t bit = pos * W;
+      write_bits(bits_.data() + bit / type_size, value, bit % type_size, W);
+    }
+  }
+
+  value_type operator[](std::size_t pos) const { return get(pos); }
+  Reference operator[](std::size_t pos) { return Reference(this, pos); }
+
+  /**
+   * @brief Value of word at pos
+   *
+   * This checks the access (pos < size())
+   */
+  value_type at(std::size_t pos) const {
+    assert(pos < num_words_ && "FixedWordVector access out of bounds");
+    return get(pos);
+  }
+
+  /**
+   * @brief Calls f(value) on every word in order
+   *
+   * Words are unpacked a Type at a time with constant shifts
+   *
+   * @param f callable taking a value_type
+   */
+  template <typename F>
+  void for_each(F f) const {
+    if constexpr (aligned) {
+      std::size_t full = num_words_ / words_per_type;
+      for (std::size_t w = 0; w < full; ++w) {
+        Type word = bits_[w];
+        for (std::size_t k = 0; k < words_per_type; ++k)
+          f(static_cast<value_type>((word >> (k * W)) & mask));
+      }
+      for (std::size_t i = full * words_per_type; i < num_words_; ++i)
+        f(get(i));
+    } else {
+      for (std::size_t i = 0; i < num_words_; ++i) f(get(i));
+    }
+  }
+
+  /**
+   * @brief Number of words equal to value
+   */
+  std::size_t count(value_type value) const {
+    std::size_t res = 0;
+    for_each([&res, value](value_type v) { res += v == value; });
+    return res;
+  }
+
+  std::size_t size() const { return num_words_; }
+  uint8_t getWordSize() const { return W; }
+  std::size_t getNumBits() const { return num_words_ * W; }
+
+  /**
+   * @brief Direct access to underlying word array
+   */
+  const Type* data() const { return bits_.data(); }
+
+  /**
+   * @brief WordVector with the same values
+   */
+  WordVector toWordVector() const {
+    return WordVector(WordBuffer(bits_), num_words_, W);
+  }
+
+  ConstIterator begin() const { return ConstIterator(0, this); }
+  ConstIterator end() const { return ConstIterator(num_words_, this); }
+  ConstIterator cbegin() const { return begin(); }
+  ConstIterator cend() const { return end(); }
+
+  /**
+   * @brief Reference to a word inside a FixedWordVector
+   */
+  class Reference {
+   public:
+    Reference(FixedWordVector* wv, std::size_t pos) : wv_(wv), pos_(pos) {}
+
+    operator value_type() const { return wv_->get(pos_); }
+
+    Reference& operator=(value_type value) {
+      wv_->set(pos_, value);
+      return *this;
+    }
+
+    Reference& operator=(const Reference& other) {
+      return *this = static_cast<value_type>(other);
+    }
+
+   private:
+    FixedWordVector* wv_;  // vector referenced
+    std::size_t pos_;      // position of word referenced
+  };
+
+  /**
+   * @brief Random access iterator on the values of the vector
+   */
+  class ConstIterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = FixedWordVector::value_type;
+    using pointer = const value_type*;
+    using reference = value_type;
+
+    ConstIterator() : pos_(0), wv_(nullptr) {}
+    ConstIterator(std::size_t pos, const FixedWordVector* wv)
+        : pos_(pos), wv_(wv) {}
+
+    reference operator*() const { return wv_->get(pos_); }
+    reference operator[](difference_type n) const { return wv_->get(pos_ + n); }
+
+    ConstIterator& operator++() {
+      ++pos_;
+      return *this;
+    }
+
+    ConstIterator operator++(int) {
+      ConstIterator tmp = *this;
+      ++pos_;
+      return tmp;
+    }
+
+    ConstIterator& operator--() {
+      --pos_;
+      return *this;
+    }
+
+    ConstIterator operator--(int) {
+      ConstIterator tmp = *this;
+      --pos_;
+      return tmp;
+    }
+
+    ConstIterator& operator+=(difference_type n) {
+      pos_ += n;
+      return *this;
+    }
+
+    ConstIterator& operator-=(difference_type n) {
+      pos_ -= n;
+      return *this;
+    }
+
+    friend ConstIterator operator+(ConstIterator it, difference_type n) {
+      return it += n;
+    }
+
+    friend ConstIterator operator+(difference_type n, ConstIterator it) {
+      return it += n;
+    }
+
+    friend ConstIterator operator-(ConstIterator it, difference_type n) {
+      return it -= n;
+    }
+
+    friend difference_type operator-(const ConstIterator& a,
+                                     const ConstIterator& b) {
+      return a.pos_ - b.pos_;
+    }
+
+    friend bool operator==(const ConstIterator& a, const ConstIterator& b) {
+      return a.wv_ == b.wv_ && a.pos_ == b.pos_;
+    }
+
+    friend bool operator!=(const ConstIterator& a, const ConstIterator& b) {
+      return !(a == b);
+    }
+
+    friend bool operator<(const ConstIterator& a, const ConstIterator& b) {
+      return a.pos_ < b.pos_;
+    }
+
+    friend bool operator>(const ConstIterator& a, const ConstIterator& b) {
+      return b < a;
+    }
+
+    friend bool operator<=(const ConstIterator& a, const ConstIterator& b) {
+      return !(b < a);
+    }
+
+    friend bool operator>=(const ConstIterator& a, const ConstIterator& b) {
+      return !(a < b);
+    }
+
+   private:
+    std::size_t pos_;            // position of word in vector
+    const FixedWordVector* wv_;  // vector iterated
+  };
+
+ private:
+  WordBuffer bits_;        // words containing the packed values
+  std::size_t num_words_;  // number of words stored
+};
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_FIXEDWORDVECTOR_
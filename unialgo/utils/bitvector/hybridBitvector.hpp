@@ -0,0 +1,192 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_HYBRIDBITVECTOR_
+#define UNIALGO_UTILS_BITVECTOR_HYBRIDBITVECTOR_
+
+#include <stdint.h>  // uint8_t
+
+#include <memory>           // shared_ptr
+#include <memory_resource>  // std::pmr::memory_resource
+#include <utility>          // std::move
+#include <variant>          // std::variant, std::visit
+
+#include "unialgo/utils/bitvector/bitvector.hpp"
+#include "unialgo/utils/bitvector/eliasFano.hpp"
+#include "unialgo/utils/bitvector/rankInterleaved.hpp"
+#include "unialgo/utils/bitvector/rrrBitvector.hpp"
+
+/**
+ * @file This file contains a bitvector stored in the smallest of three
+ * encodings
+ *
+ * The bits are encoded as plain bits with interleaved rank counts, as RRR
+ * blocks and as Elias-Fano, the one with the smallest GetSizeInBits() is
+ * kept (plain on ties). Queries dispatch to the encoding kept: a wavelet
+ * matrix level that is almost all 0s ends up Elias-Fano, a skewed one RRR
+ * and a balanced one plain.
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+class HybridBitvector {
+ public:
+  static const bool stores_bits = true;  // bits are kept encoded
+
+  // encodings in order of preference on ties
+  enum class Encoding : uint8_t { kPlain, kRRR, kEliasFano };
+
+  HybridBitvector() = default;
+
+  /**
+   * @brief Construct a new Hybrid Bitvector object
+   *
+   * @param bv bitvector to encode
+   * @param num_threads unused, every encoding is built in a single pass
+   * (same arguments of RankHelper)
+   * @param resource memory resource of the encodings
+   */
+  HybridBitvector(
+      std::shared_ptr<unialgo::utils::Bitvector> bv,
+      [[maybe_unused]] std::size_t num_threads = 1,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : HybridBitvector(*bv, resource) {}
+
+  HybridBitvector(
+      const unialgo::utils::Bitvector& bv,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : bits_(InterleavedRankHelper(bv)) {
+    // candidates are built one at a time off resource (a monotonic one would
+    // keep the losers), the smallest so far is kept
+    RRRBitvector rrr(bv);
+    if (rrr.GetSizeInBits() < GetSizeInBits()) bits_ = std::move(rrr);
+    EliasFanoBitvector elias_fano(bv);
+    if (elias_fano.GetSizeInBits() < GetSizeInBits())
+      bits_ = std::move(elias_fano);
+    if (resource == std::pmr::get_default_resource()) return;
+    // only the winner is built on resource
+    switch (encoding()) {
+      case Encoding::kPlain:
+        bits_.emplace<InterleavedRankHelper>(bv, resource);
+        break;
+      case Encoding::kRRR:
+        bits_.emplace<RRRBitvector>(bv, resource);
+        break;
+      case Encoding::kEliasFano:
+        bits_.emplace<EliasFanoBitvector>(bv, resource);
+        break;
+    }
+  }
+
+  ~HybridBitvector() = default;
+  HybridBitvector(const HybridBitvector&) = default;
+  HybridBitvector(HybridBitvector&&) = default;
+  HybridBitvector& operator=(const HybridBitvector&) = default;
+  HybridBitvector& operator=(HybridBitvector&&) = default;
+
+  /**
+   * @brief Rank on the kept encoding
+   *
+   * @param indx index (must be valid)
+   * @return std::size_t # of bits set to 1 in [0, indx] (returns 0 if empty)
+   */
+  std::size_t rank(std::size_t indx) const {
+    return std::visit([&](const auto& bits) { return bits.rank(indx); },
+                      bits_);
+  }
+
+  /**
+   * @brief Rank on the kept encoding
+   *
+   * @param indx index (must be valid)
+   * @param value what to count 0, 1
+   * @return std::size_t # of bits set to value [0, indx] (returns 0 if empty)
+   */
+  std::size_t rank(std::size_t indx, bool value) const {
+    return std::visit(
+        [&](const auto& bits) { return bits.rank(indx, value); }, bits_);
+  }
+
+  /**
+   * @brief Counter of value from start to end
+   *
+   * @return std::size_t # ob bits set to value in [start, end]
+   */
+  std::size_t rank(std::size_t start, std::size_t end, bool value) const {
+    return std::visit(
+        [&](const auto& bits) { return bits.rank(start, end, value); },
+        bits_);
+  }
+
+  /**
+   * @brief Prefetch of the memory read by rank(indx) (plain and RRR)
+   */
+  void prefetch(std::size_t indx) const {
+    std::visit(
+        [&](const auto& bits) {
+          if constexpr (requires { bits.prefetch(indx); }) bits.prefetch(indx);
+        },
+        bits_);
+  }
+
+  /**
+   * @brief Select on the kept encoding
+   *
+   * @param count i-th element searched
+   * @param value what to search 0, 1
+   * @return std::size_t position in bv of the i-th value, -1 if not present
+   */
+  std::size_t select(std::size_t count, bool value) const {
+    return std::visit(
+        [&](const auto& bits) { return bits.select(count, value); }, bits_);
+  }
+
+  /**
+   * @brief Access single bit
+   *
+   * @param bit_pos position of bit to access
+   * @return bool value of bit at bit_pos
+   */
+  bool GetBit(std::size_t bit_pos) const {
+    return std::visit(
+        [&](const auto& bits) { return bits.GetBit(bit_pos); }, bits_);
+  }
+
+  /**
+   * @brief Number of bits set to value in the bitvector
+   */
+  std::size_t GetTotal(bool value) const {
+    return std::visit(
+        [&](const auto& bits) { return bits.GetTotal(value); }, bits_);
+  }
+
+  /**
+   * @brief Number of bits of the bitvector
+   */
+  std::size_t size() const {
+    return std::visit([](const auto& bits) { return bits.size(); }, bits_);
+  }
+
+  /**
+   * @brief Memory used by the kept encoding
+   *
+   * @return std::size_t # of bits used (compare with size())
+   */
+  std::size_t GetSizeInBits() const {
+    return std::visit([](const auto& bits) { return bits.GetSizeInBits(); },
+                      bits_);
+  }
+
+  /**
+   * @brief Encoding kept
+   */
+  Encoding encoding() const { return static_cast<Encoding>(bits_.index()); }
+
+ private:
+  std::variant<InterleavedRankHelper, RRRBitvector, EliasFanoBitvector>
+      bits_;  // bits in the smallest encoding
+};  // HybridBitvector
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_HYBRIDBITVECTOR_
@@ -0,0 +1,178 @@
+#include "unialgo/utils/bitvector/rankHelper.hpp"
+
+#include <algorithm>  // std::min
+#include <cassert>    // assert
+#include <thread>     // std::thread
+#include <vector>     // std::vector
+
+#include "unialgo/utils/bitvector/serialize.hpp"
+
+namespace unialgo {
+namespace utils {
+
+namespace {
+
+// bits of a position in a bitvector of num_bits bits (select samples)
+uint8_t position_size(std::size_t num_bits) {
+  return std::ceil(std::log(num_bits + 1) / std::log(2));
+}
+
+}  // namespace
+
+// ============ Implementation RankHelper ============
+
+std::size_t RankHelper::initRange(std::size_t sb_begin, std::size_t sb_end) {
+  const auto* data = bv_ptr_->data();
+  const std::size_t word_bits = Bitvector::type_size;
+  const std::size_t num_words = (bv_ptr_->size() + word_bits - 1) / word_bits;
+
+  std::size_t begin = sb_begin * size_first_;  // first bit of the range
+  std::size_t end = std::min(sb_end * size_first_, num_words * word_bits);
+  std::size_t block = sb_begin * size_second_;  // current entry of second_
+  std::size_t block_end = std::min(sb_end * size_second_, second_.size());
+  std::size_t boundary = block * size_second_;  // bit of current block
+
+  std::size_t count = 0;             // # of 1s before current word
+  std::size_t superblock_count = 0;  // # of 1s up to current superblock
+
+  // writes first_ / second_ entries for the block at boundary
+  auto emit = [&](std::size_t ones) {
+    if (boundary % size_first_ == 0) {
+      first_[boundary / size_first_] = ones;
+      superblock_count = ones;
+    }
+    second_[block] = ones - superblock_count;
+  };
+
+  for (std::size_t w = begin / word_bits; w * word_bits < end; ++w) {
+    uint64_t word = data[w];
+    // bits outside [begin, end) belong to other chunks
+    if (w == begin / word_bits) word &= all_set << (begin % word_bits);
+    if ((w + 1) * word_bits > end) word &= lower_bits_set[end - w * word_bits];
+
+    for (; block < block_end && boundary < (w + 1) * word_bits;
+         ++block, boundary += size_second_) {
+      emit(count + __builtin_popcountll(
+                       word & lower_bits_set[boundary % word_bits + 1]));
+    }
+    count += __builtin_popcountll(word);
+  }
+  // blocks past the last word count every bit
+  for (; block < block_end; ++block, boundary += size_second_) emit(count);
+  return count;
+}
+
+void RankHelper::init() { initRange(0, first_.size()); }
+
+void RankHelper::initParallel(std::size_t num_threads) {
+  // chunks are multiple of 64 superblocks: first_[k] and second_[k * s2]
+  // starts then fall at the start of a word of the layers
+  const std::size_t align = Bitvector::type_size;
+  std::size_t num_chunks = (first_.size() + align - 1) / align;
+  num_threads = std::min(num_threads, num_chunks);
+  if (num_threads <= 1) return init();
+
+  std::size_t per_thread = (num_chunks + num_threads - 1) / num_threads * align;
+  std::vector<std::size_t> totals(num_threads, 0);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < num_threads; ++t) {
+    std::size_t sb_begin = std::min(t * per_thread, first_.size());
+    std::size_t sb_end = std::min(sb_begin + per_thread, first_.size());
+    threads.emplace_back([this, &totals, t, sb_begin, sb_end]() {
+      totals[t] = initRange(sb_begin, sb_end);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  // fix up first_ with the # of 1s in the previous chunks
+  std::size_t offset = totals[0];
+  for (std::size_t t = 1; t < num_threads; ++t) {
+    std::size_t sb_end = std::min((t + 1) * per_thread, first_.size());
+    for (std::size_t k = t * per_thread; k < sb_end; ++k)
+      first_[k] = first_[k].getValue() + offset;
+    offset += totals[t];
+  }
+}
+
+void RankHelper::initSelect() {
+  std::size_t num_bits = bv_ptr_->size();
+  uint8_t pos_size = position_size(num_bits);
+  std::size_t ones = GetTotal(1);
+  std::size_t zeros = num_bits - ones;
+  // same resource of the rank layers
+  select_ones_ = unialgo::utils::WordVector(
+      (ones + select_sample_rate - 1) / select_sample_rate, pos_size,
+      first_.getResource());
+  select_zeros_ = unialgo::utils::WordVector(
+      (zeros + select_sample_rate - 1) / select_sample_rate, pos_size,
+      first_.getResource());
+
+  const auto* data = bv_ptr_->data();
+  std::size_t num_words =
+      (num_bits + Bitvector::type_size - 1) / Bitvector::type_size;
+  std::size_t seen[2] = {0, 0};  // # of 0s, 1s before current word
+  unialgo::utils::WordVector* samples[2] = {&select_zeros_, &select_ones_};
+  for (std::size_t w = 0; w < num_words; ++w) {
+    for (uint8_t value = 0; value < 2; ++value) {
+      uint64_t word = value ? data[w] : ~data[w];
+      if (!value && (w + 1) * Bitvector::type_size > num_bits)
+        word &= lower_bits_set[num_bits - w * Bitvector::type_size];
+      std::size_t in_word = __builtin_popcountll(word);
+      // next sampled occurrence is the (k * rate + 1)-th
+      std::size_t next = (seen[value] + select_sample_rate - 1) /
+                         select_sample_rate * select_sample_rate;
+      for (; next < seen[value] + in_word; next += select_sample_rate) {
+        (*samples[value])[next / select_sample_rate] =
+            w * Bitvector::type_size + select_in_word(word, next - seen[value]);
+      }
+      seen[value] += in_word;
+    }
+  }
+}
+
+void RankHelper::write(SerialWriter& out) const {
+  assert(bv_ptr_ && "RankHelper without bitvector can not be written");
+  out.header(serial::Tag::kRankHelper);
+  bv_ptr_->write(out);
+  out.value(size_first_);
+  out.value(size_second_);
+  first_.write(out);
+  second_.write(out);
+  select_ones_.write(out);
+  select_zeros_.write(out);
+}
+
+RankHelper RankHelper::read(SerialReader& in) {
+  in.header(serial::Tag::kRankHelper);
+  RankHelper helper;
+  helper.bv_ptr_ = std::make_shared<Bitvector>(Bitvector::read(in));
+  helper.size_first_ = in.value();
+  helper.size_second_ = in.value();
+  helper.first_ = WordVector::read(in);
+  helper.second_ = WordVector::read(in);
+  helper.select_ones_ = WordVector::read(in);
+  helper.select_zeros_ = WordVector::read(in);
+
+  std::size_t num_bits = helper.bv_ptr_->size();
+  if (helper.size_second_ == 0 ||
+      helper.size_first_ != helper.size_second_ * helper.size_second_ ||
+      helper.first_.size() != num_bits / helper.size_first_ + 1 ||
+      helper.second_.size() != num_bits / helper.size_second_ + 1)
+    throw std::runtime_error("unialgo: corrupted serialized RankHelper");
+
+  // select samples: one every select_sample_rate occurrences, as positions
+  std::size_t ones = helper.GetTotal(1);
+  std::size_t zeros = num_bits - ones;
+  uint8_t pos_size = position_size(num_bits);
+  if (helper.select_ones_.size() !=
+          (ones + select_sample_rate - 1) / select_sample_rate ||
+      helper.select_zeros_.size() !=
+          (zeros + select_sample_rate - 1) / select_sample_rate ||
+      helper.select_ones_.getWordSize() != pos_size ||
+      helper.select_zeros_.getWordSize() != pos_size)
+    throw std::runtime_error("unialgo: corrupted serialized RankHelper");
+  return helper;
+}
+
+}  // namespace utils
+}  // namespace unialgo
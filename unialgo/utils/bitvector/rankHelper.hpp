@@ -3,8 +3,10 @@
 
 #include <stdint.h>  // uint64_t
 
-#include <cmath>    // std::pow, std::log, std::ceil
-#include <memory>   // shared_ptr
+#include <algorithm>        // std::max
+#include <cmath>            // std::pow, std::log, std::ceil
+#include <memory>           // shared_ptr
+#include <memory_resource>  // std::pmr::memory_resource
 
 #include "unialgo/utils/bitvector/bitvector.hpp"
 #include "unialgo/utils/bitvector/wordVector.hpp"
@@ -21,18 +23,46 @@ namespace utils {
 
 class RankHelper {
  public:
+  static const bool stores_bits = false;  // bits are read from bv_ptr_
+  static const std::size_t select_sample_rate =
+      256;  // distance (in occurrences) between select samples
+  static const std::size_t select_scan_words =
+      8;  // max words scanned before narrowing with the rank layers
+  static constexpr std::size_t prefetch_distance =
+      16;  // queries prefetched ahead by rank_batch
+
   RankHelper() : bv_ptr_() {};
 
-  RankHelper(std::shared_ptr<unialgo::utils::Bitvector> bv) : bv_ptr_(bv) {
-    size_second_ = std::ceil(std::log(bv->size()) / 2);
+  /**
+   * @brief Construct a new Rank Helper object
+   *
+   * @param bv bitvector to build rank and select support on
+   * @param num_threads threads used to build the rank layers (see
+   * initParallel)
+   * @param resource memory resource the layers are allocated from
+   */
+  RankHelper(
+      std::shared_ptr<unialgo::utils::Bitvector> bv,
+      std::size_t num_threads = 1,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : bv_ptr_(bv) {
+    size_second_ =
+        std::max<std::size_t>(1, std::ceil(std::log(bv->size()) / 2));
     size_first_ = std::pow(size_second_, 2);
     first_ = unialgo::utils::WordVector(
         bv->size() / size_first_ + 1,
-        std::ceil(std::log(bv.get()->size()) / std::log(2)));
+        std::ceil(std::log(bv.get()->size() + 1) / std::log(2)), resource);
+    // at least a bit: size_first_ is 1 on bitvectors of less than 8 bits
     second_ = unialgo::utils::WordVector(
         bv->size() / size_second_ + 1,
-        std::ceil(std::log(size_first_) / std::log(2)));
-    init();
+        std::max<std::size_t>(
+            1, std::ceil(std::log(size_first_) / std::log(2))),
+        resource);
+    if (num_threads > 1)
+      initParallel(num_threads);
+    else
+      init();
+    initSelect();
   };
 
   ~RankHelper() = default;
@@ -116,10 +146,49 @@ class RankHelper {
     return r_end - r_start;
   }
 
+  /**
+   * @brief Starts loading in cache the layer entries and the word of bits
+   * rank(indx) reads
+   *
+   * @param indx index (must be valid)
+   */
+  void prefetch(std::size_t indx) const {
+    if (bv_ptr_.get() == nullptr) return;
+    first_.prefetch(indx / size_first_);
+    second_.prefetch(indx / size_second_);
+    __builtin_prefetch(bv_ptr_->data() + indx / Bitvector::type_size);
+  }
+
+  /**
+   * @brief Rank of many positions, out[i] = rank(pos[i])
+   *
+   * The lines of pos[i + prefetch_distance] are prefetched while pos[i] is
+   * answered, so the cache misses of independent queries overlap instead of
+   * being paid one after the other
+   *
+   * @param pos indexes (must be valid)
+   * @param n number of queries
+   * @param out # of bits set to 1 in [0, pos[i]]
+   */
+  void rank_batch(const std::size_t* pos, std::size_t n,
+                  std::size_t* out) const {
+    for (std::size_t i = 0; i < std::min(n, prefetch_distance); ++i)
+      prefetch(pos[i]);
+    for (std::size_t i = 0; i < n; ++i) {
+      if (i + prefetch_distance < n) prefetch(pos[i + prefetch_distance]);
+      out[i] = rank(pos[i]);
+    }
+  }
+
   /**
    * @brief Select helper for bitvector
    *
-   * Note this implementation is O(log(n))
+   * Uses the select directory: the sampled position of every
+   * select_sample_rate-th occurrence of value bounds the search, when the
+   * sampled gap is short the words are scanned with popcount, otherwise the
+   * rank layers narrow the gap to a single second layer block first.
+   * This is O(1) on dense regions and O(log(gap / size_second_)) layer
+   * lookups on sparse ones.
    *
    * @param count i-th element searched
    * @param value what to search 0, 1
@@ -128,55 +197,139 @@ class RankHelper {
    */
   std::size_t select(std::size_t count, bool value) const {
     if (bv_ptr_.get() == nullptr) return 0;
+    if (count == 0 || count > GetTotal(value)) return -1;
+
+    const unialgo::utils::WordVector& samples =
+        value ? select_ones_ : select_zeros_;
+    std::size_t sample = (count - 1) / select_sample_rate;
+    std::size_t lo = samples[sample];  // position of (sample * rate + 1)-th
+    std::size_t seen = sample * select_sample_rate + 1;  // rank(lo, value)
+    if (seen == count) return lo;
+
+    std::size_t hi = (sample + 1 < samples.size()) ? samples[sample + 1]
+                                                    : bv_ptr_->size() - 1;
+    if ((hi - lo) / Bitvector::type_size <= select_scan_words)
+      return scanSelect(lo + 1, count - seen, value);
 
-    std::size_t start = 0;
-    std::size_t end = bv_ptr_->getNumBits() - 1;
-
-    while (start <= end) {
-      std::size_t mid = start + (end - start) / 2;
-      // found first occ of i-th element
-      if ((mid == 0 || count > rank(mid - 1, value)) &&
-          rank(mid, value) == count)
-        return mid;
-      // classic search
-      else if (rank(mid, value) < count)
-        start = mid + 1;
+    // sparse gap: binary search the last block with blockRank < count
+    std::size_t block_lo = lo / size_second_;
+    std::size_t block_hi = hi / size_second_;
+    while (block_lo < block_hi) {
+      std::size_t mid = block_lo + (block_hi - block_lo + 1) / 2;
+      if (blockRank(mid, value) < count)
+        block_lo = mid;
       else
-        end = mid - 1;
+        block_hi = mid - 1;
     }
-    return -1;
+    std::size_t block_start = block_lo * size_second_;
+    if (block_start < lo) return scanSelect(lo + 1, count - seen, value);
+    return scanSelect(block_start + 1, count - blockRank(block_lo, value),
+                      value);
   }
 
   /**
-   * @brief Create and computes the layers for rank
+   * @brief Access single bit in the referenced bitvector
    *
+   * @param bit_pos position of bit to access
+   * @return bool value of bit at bit_pos
    */
-  void init() {
-    for (std::size_t i = 0; i < bv_ptr_->size(); ++i) {
-      if (bv_ptr_->GetBit(i)) {
-        ++first_[std::ceil(static_cast<double>(i) / size_first_)];
-        ++second_[std::ceil(static_cast<double>(i) / size_second_)];
-      }
-      if (i % size_first_ == 0 && (i / size_first_ + 1) < first_.size())
-        first_[i / size_first_ + 1] = first_[i / size_first_];
-
-      if (i % size_second_ == 0) {
-        // reset counter if aligned with first level
-        if (i % size_first_ == 0) second_[i / size_second_] = 0;
-        if ((i / size_second_ + 1) < second_.size())
-          second_[i / size_second_ + 1] = second_[i / size_second_];
-      }
-    }
+  bool GetBit(std::size_t bit_pos) const { return bv_ptr_->GetBit(bit_pos); }
+
+  /**
+   * @brief Size of the referenced bitvector
+   *
+   * @return std::size_t number of bits (0 if pointer = nullptr)
+   */
+  std::size_t size() const {
+    return bv_ptr_.get() == nullptr ? 0 : bv_ptr_->size();
   }
 
+  /**
+   * @brief Number of bits set to value in the bitvector
+   *
+   * @param value what to count 0, 1
+   * @return std::size_t # of bits set to value (0 if pointer = nullptr)
+   */
+  std::size_t GetTotal(bool value) const {
+    if (bv_ptr_.get() == nullptr || bv_ptr_->size() == 0) return 0;
+    return rank(bv_ptr_->size() - 1, value);
+  }
+
+  /**
+   * @brief Create and computes the layers for rank
+   *
+   * Works a word at a time: each word is popcounted once and the block
+   * boundaries inside it are read with a masked popcount, the layers are
+   * written sequentially.
+   *
+   */
+  void init();
+
+  /**
+   * @brief Create and computes the layers for rank using num_threads threads
+   *
+   * The superblocks are split in chunks (aligned so that no two threads write
+   * the same word of first_ or second_), every thread fills its chunk with
+   * counts relative to the chunk start, then the first layer is fixed up with
+   * the prefix sum of the chunk totals.
+   *
+   * @param num_threads number of threads to use
+   */
+  void initParallel(std::size_t num_threads);
+
+  /**
+   * @brief Create the select directory, sampled positions of every
+   * select_sample_rate-th 1 and 0 in the bitvector
+   *
+   */
+  void initSelect();
+
   std::size_t GetFirstBlockSize() const { return size_first_; }
   std::size_t GetSecondBlockSize() const { return size_second_; }
 
+  /**
+   * @brief Memory used by the rank layers (first_ and second_)
+   *
+   * @return std::size_t # of bits used on top of the bitvector for rank
+   */
+  std::size_t GetRankOverhead() const {
+    return first_.getNumBits() + second_.getNumBits();
+  }
+
+  /**
+   * @brief Memory used by the select directory
+   *
+   * @return std::size_t # of bits used on top of the bitvector for select
+   */
+  std::size_t GetSelectOverhead() const {
+    return select_ones_.getNumBits() + select_zeros_.getNumBits();
+  }
+
+  /**
+   * @brief Writes the helper and its bitvector in the binary format (see
+   * serialize.hpp)
+   *
+   * @param out writer to the destination
+   */
+  void write(SerialWriter& out) const;
+
+  /**
+   * @brief Reads a helper written by write, the bitvector read with it is
+   * owned by the helper. On a mapped file every layer is viewed in place
+   *
+   * @param in reader on the source
+   * @return RankHelper read
+   */
+  static RankHelper read(SerialReader& in);
+
   void debug() {
     std::cout << "FirstLayerSize: " << size_first_
               << " SecondLayerSize: " << size_second_ << std::endl
               << " length array first: " << first_.size()
-              << " length second: " << second_.size() << std::endl;
+              << " length second: " << second_.size() << std::endl
+              << " rank overhead (bits): " << GetRankOverhead()
+              << " select overhead (bits): " << GetSelectOverhead()
+              << std::endl;
     for (int i = 0; i < bv_ptr_->getNumBits(); ++i) {
       std::cout << bv_ptr_->GetBit(i) << " ";
     }
@@ -202,6 +355,50 @@ class RankHelper {
   }
 
  private:
+  /**
+   * @brief Fills first_[sb_begin, sb_end) and the second_ blocks they cover
+   *
+   * first_ values are relative to bit sb_begin * size_first_
+   *
+   * @return std::size_t # of 1s in the bits covered by the superblocks
+   */
+  std::size_t initRange(std::size_t sb_begin, std::size_t sb_end);
+
+  /**
+   * @brief # of bits set to value in [0, block * size_second_] from layers
+   */
+  std::size_t blockRank(std::size_t block, bool value) const {
+    std::size_t pos = block * size_second_;
+    std::size_t ones = first_[pos / size_first_].getValue() +
+                       second_[block].getValue();
+    return value ? ones : pos + 1 - ones;
+  }
+
+  /**
+   * @brief Position of the remaining-th bit set to value starting from pos
+   *
+   * Important: the bit must exist
+   */
+  std::size_t scanSelect(std::size_t pos, std::size_t remaining,
+                         bool value) const {
+    const auto* data = bv_ptr_->data();
+    std::size_t num_bits = bv_ptr_->size();
+    std::size_t w = pos / Bitvector::type_size;
+    uint64_t word = (value ? data[w] : ~data[w]) &
+                    (all_set << (pos % Bitvector::type_size));
+    while (true) {
+      // clear the unused bits of the last word when counting 0s
+      if (!value && (w + 1) * Bitvector::type_size > num_bits)
+        word &= lower_bits_set[num_bits - w * Bitvector::type_size];
+      std::size_t in_word = __builtin_popcountll(word);
+      if (in_word >= remaining)
+        return w * Bitvector::type_size + select_in_word(word, remaining - 1);
+      remaining -= in_word;
+      ++w;
+      word = value ? data[w] : ~data[w];
+    }
+  }
+
   std::shared_ptr<unialgo::utils::Bitvector>
       bv_ptr_;  // shared_ptr to bitvector
 
@@ -212,6 +409,10 @@ class RankHelper {
   std::size_t size_first_;   // first layer's block size
   std::size_t size_second_;  // second layer's block size
 
+  // select directory: position of every select_sample_rate-th 1 / 0
+  unialgo::utils::WordVector select_ones_;
+  unialgo::utils::WordVector select_zeros_;
+
 };  // RankHelper
 
 }  // namespace utils
@@ -0,0 +1,274 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_RANKINTERLEAVED_
+#define UNIALGO_UTILS_BITVECTOR_RANKINTERLEAVED_
+
+#include <stdint.h>  // uint64_t
+
+#include <algorithm>        // std::min
+#include <memory>           // shared_ptr
+#include <memory_resource>  // std::pmr::memory_resource
+#include <utility>          // std::move
+#include <vector>           // std::pmr::vector
+
+#include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/bitvector.hpp"
+
+/**
+ * @file This file contains a rank9-style rank helper for utils::bitvector
+ *
+ * Counts and bits are interleaved in 64-byte lines so a rank query touches a
+ * single cache line:
+ * | count before line | 5 x 9-bit counts inside line | 6 words of bits |
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+class InterleavedRankHelper {
+ public:
+  static const bool stores_bits = true;  // bits are copied inside the lines
+  static const std::size_t line_words = 6;  // words of bits in a line
+  static const std::size_t line_bits =
+      line_words * Bitvector::type_size;  // bits in a line
+  static constexpr std::size_t prefetch_distance =
+      16;  // queries prefetched ahead by rank_batch
+
+  InterleavedRankHelper() : num_bits_(0), total_ones_(0) {}
+
+  /**
+   * @brief Construct a new Interleaved Rank Helper object
+   *
+   * @param bv bitvector copied in the lines
+   * @param num_threads unused, the lines are filled in a single pass (same
+   * arguments of RankHelper)
+   * @param resource memory resource the lines are allocated from
+   */
+  InterleavedRankHelper(
+      std::shared_ptr<unialgo::utils::Bitvector> bv,
+      [[maybe_unused]] std::size_t num_threads = 1,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : InterleavedRankHelper(*bv, resource) {}
+
+  InterleavedRankHelper(
+      const unialgo::utils::Bitvector& bv,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : num_bits_(bv.size()),
+        total_ones_(0),
+        lines_((bv.size() + line_bits - 1) / line_bits, resource) {
+    init(bv);
+  }
+
+  ~InterleavedRankHelper() = default;
+  InterleavedRankHelper(const InterleavedRankHelper&) = default;
+  InterleavedRankHelper(InterleavedRankHelper&&) = default;
+  InterleavedRankHelper& operator=(const InterleavedRankHelper&) = default;
+  InterleavedRankHelper& operator=(InterleavedRankHelper&&) = default;
+
+  /**
+   * @brief Rank helper for bitvector
+   *
+   * Rank is O(1) and reads a single 64-byte line
+   *
+   * @param indx index (must be valid)
+   * @return std::size_t # of bits set to 1 in [0, indx] (returns 0 if empty)
+   */
+  std::size_t rank(std::size_t indx) const {
+    if (num_bits_ == 0) return 0;
+    const Line& line = lines_[indx / line_bits];
+    std::size_t offset = indx % line_bits;
+    std::size_t word = offset / Bitvector::type_size;
+    return line.count + ((line.sub >> (9 * word)) & 0x1FF) +
+           __builtin_popcountll(
+               line.bits[word] &
+               lower_bits_set[offset % Bitvector::type_size + 1]);
+  }
+
+  /**
+   * @brief Rank helper for bitvector
+   *
+   * @param indx index (must be valid)
+   * @param value what to count 0, 1
+   * @return std::size_t # of bits set to value [0, indx] (returns 0 if empty)
+   */
+  std::size_t rank(std::size_t indx, bool value) const {
+    if (num_bits_ == 0) return 0;
+    if (value) return rank(indx);  // count 1
+    return indx - rank(indx) + 1;  // count 0
+  }
+
+  /**
+   * @brief Counter of value from start to end
+   *
+   * @param start range
+   * @param end range
+   * @param value what to count 0, 1
+   * @return std::size_t # ob bits set to value in [start, end]
+   */
+  std::size_t rank(std::size_t start, std::size_t end, bool value) const {
+    if (start == 0) return rank(end, value);
+    std::size_t r_end = rank(end, value);
+    std::size_t r_start = rank(start - 1, value);
+    if (r_end <= r_start) return 0;
+    return r_end - r_start;
+  }
+
+  /**
+   * @brief Starts loading in cache the line rank(indx) reads
+   *
+   * @param indx index (must be valid)
+   */
+  void prefetch(std::size_t indx) const {
+    if (num_bits_ == 0) return;
+    __builtin_prefetch(lines_.data() + indx / line_bits);
+  }
+
+  /**
+   * @brief Rank of many positions, out[i] = rank(pos[i])
+   *
+   * A query reads one line: prefetching prefetch_distance queries ahead
+   * keeps that many line misses in flight
+   *
+   * @param pos indexes (must be valid)
+   * @param n number of queries
+   * @param out # of bits set to 1 in [0, pos[i]]
+   */
+  void rank_batch(const std::size_t* pos, std::size_t n,
+                  std::size_t* out) const {
+    for (std::size_t i = 0; i < std::min(n, prefetch_distance); ++i)
+      prefetch(pos[i]);
+    for (std::size_t i = 0; i < n; ++i) {
+      if (i + prefetch_distance < n) prefetch(pos[i + prefetch_distance]);
+      out[i] = rank(pos[i]);
+    }
+  }
+
+  /**
+   * @brief Select helper for bitvector
+   *
+   * Binary search on the line counts, then popcount scan inside the line.
+   * This is O(log(n / line_bits))
+   *
+   * @param count i-th element searched
+   * @param value what to search 0, 1
+   * @return std::size_t position in bv of the i-th value, -1 if not present
+   * (returns 0 if empty)
+   */
+  std::size_t select(std::size_t count, bool value) const {
+    if (num_bits_ == 0) return 0;
+    if (count == 0 || count > GetTotal(value)) return -1;
+
+    // last line with less than count values before it
+    std::size_t lo = 0;
+    std::size_t hi = lines_.size() - 1;
+    while (lo < hi) {
+      std::size_t mid = lo + (hi - lo + 1) / 2;
+      if (lineRank(mid, value) < count)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+
+    // padding bits come after every valid bit so they are never reached
+    std::size_t remaining = count - lineRank(lo, value);
+    const Line& line = lines_[lo];
+    for (std::size_t w = 0;; ++w) {
+      uint64_t word = value ? line.bits[w] : ~line.bits[w];
+      std::size_t in_word = __builtin_popcountll(word);
+      if (in_word >= remaining)
+        return lo * line_bits + w * Bitvector::type_size +
+               select_in_word(word, remaining - 1);
+      remaining -= in_word;
+    }
+  }
+
+  /**
+   * @brief Access single bit in the stored bitvector
+   *
+   * @param bit_pos position of bit to access
+   * @return bool value of bit at bit_pos
+   */
+  bool GetBit(std::size_t bit_pos) const {
+    std::size_t offset = bit_pos % line_bits;
+    return lines_[bit_pos / line_bits].bits[offset / Bitvector::type_size] &
+           bit_set[offset % Bitvector::type_size];
+  }
+
+  /**
+   * @brief Number of bits set to value in the bitvector
+   *
+   * @param value what to count 0, 1
+   * @return std::size_t # of bits set to value
+   */
+  std::size_t GetTotal(bool value) const {
+    return value ? total_ones_ : num_bits_ - total_ones_;
+  }
+
+  /**
+   * @brief Size of the indexed bitvector
+   *
+   * @return std::size_t number of bits
+   */
+  std::size_t size() const { return num_bits_; }
+
+  /**
+   * @brief Memory used by the counts interleaved in the lines
+   *
+   * @return std::size_t # of bits used on top of the bitvector for rank
+   */
+  std::size_t GetRankOverhead() const {
+    return lines_.size() * (sizeof(Line) * 8 - line_bits);
+  }
+
+  /**
+   * @brief Memory used by the lines, bits and counts
+   *
+   * @return std::size_t # of bits used (compare with size())
+   */
+  std::size_t GetSizeInBits() const { return lines_.size() * sizeof(Line) * 8; }
+
+ private:
+  struct alignas(64) Line {
+    uint64_t count;             // # of 1s before the line
+    uint64_t sub;               // 9-bit # of 1s before word k at bit 9 * k
+    uint64_t bits[line_words];  // bits of the line
+  };
+
+  /**
+   * @brief # of bits set to value before line
+   */
+  std::size_t lineRank(std::size_t line, bool value) const {
+    return value ? lines_[line].count : line * line_bits - lines_[line].count;
+  }
+
+  /**
+   * @brief Fills the lines with counts and bits of bv
+   */
+  void init(const unialgo::utils::Bitvector& bv) {
+    const auto* data = bv.data();
+    std::size_t num_words =
+        (num_bits_ + Bitvector::type_size - 1) / Bitvector::type_size;
+    for (std::size_t l = 0; l < lines_.size(); ++l) {
+      Line& line = lines_[l];
+      line.count = total_ones_;
+      line.sub = 0;
+      std::size_t in_line = 0;
+      for (std::size_t w = 0; w < line_words; ++w) {
+        std::size_t word = l * line_words + w;
+        line.bits[w] = word < num_words ? data[word] : 0;
+        line.sub |= static_cast<uint64_t>(in_line) << (9 * w);
+        in_line += __builtin_popcountll(line.bits[w]);
+      }
+      total_ones_ += in_line;
+    }
+  }
+
+  std::size_t num_bits_;          // size of the indexed bitvector
+  std::size_t total_ones_;        // # of 1s in the bitvector
+  std::pmr::vector<Line> lines_;  // interleaved counts and bits
+
+};  // InterleavedRankHelper
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_RANKINTERLEAVED_
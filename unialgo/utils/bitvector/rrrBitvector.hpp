@@ -0,0 +1,357 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_RRRBITVECTOR_
+#define UNIALGO_UTILS_BITVECTOR_RRRBITVECTOR_
+
+#include <stdint.h>  // uint64_t
+
+#include <algorithm>        // std::min
+#include <array>            // std::array
+#include <bit>              // std::bit_width
+#include <memory>           // shared_ptr
+#include <memory_resource>  // std::pmr::memory_resource
+#include <utility>          // std::move
+#include <vector>           // std::pmr::vector
+
+#include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/bitvector.hpp"
+#include "unialgo/utils/bitvector/builders.hpp"
+#include "unialgo/utils/bitvector/wordBuffer.hpp"
+#include "unialgo/utils/bitvector/wordVector.hpp"
+
+/**
+ * @file This file contains an RRR compressed bitvector with rank and select
+ *
+ * Bits are split in blocks of 63, a block is stored as its class (# of 1s,
+ * 6 bits) and its offset: the index of the block among the blocks with the
+ * same class (ceil(log2(63 choose class)) bits). Blocks that are almost all
+ * 0s or all 1s take few bits, so sparse and dense bitvectors shrink well
+ * below n bits. Every sample_rate blocks the # of 1s and the position of the
+ * offset are sampled.
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+namespace detail {
+// rrr_binomials[n][k] = n choose k for n, k < 64
+inline constexpr auto rrr_binomials = [] {
+  std::array<std::array<uint64_t, 64>, 64> res{};
+  for (std::size_t n = 0; n < 64; ++n) {
+    res[n][0] = 1;
+    for (std::size_t k = 1; k <= n; ++k)
+      res[n][k] = res[n - 1][k - 1] + (k < n ? res[n - 1][k] : 0);
+  }
+  return res;
+}();
+
+// rrr_offset_bits[c] = bits of the offset of a 63-bit block of class c
+inline constexpr auto rrr_offset_bits = [] {
+  std::array<uint8_t, 64> res{};
+  for (std::size_t c = 0; c < 64; ++c)
+    res[c] = std::bit_width(rrr_binomials[63][c] - 1);
+  return res;
+}();
+}  // namespace detail
+
+class RRRBitvector {
+ public:
+  static const bool stores_bits = true;       // bits are kept compressed
+  static constexpr std::size_t block_size = 63;  // bits in a block
+  static const std::size_t sample_rate = 32;  // blocks between samples
+
+  RRRBitvector() : num_bits_(0), total_ones_(0) {}
+
+  /**
+   * @brief Construct a new RRR Bitvector object
+   *
+   * @param bv bitvector to compress
+   * @param num_threads unused, the blocks are encoded in a single pass (same
+   * arguments of RankHelper)
+   * @param resource memory resource the blocks and samples are allocated
+   * from
+   */
+  RRRBitvector(
+      std::shared_ptr<unialgo::utils::Bitvector> bv,
+      [[maybe_unused]] std::size_t num_threads = 1,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : RRRBitvector(*bv, resource) {}
+
+  RRRBitvector(
+      const unialgo::utils::Bitvector& bv,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : num_bits_(bv.size()),
+        total_ones_(0),
+        rank_samples_(resource),
+        offset_samples_(resource) {
+    init(bv, resource);
+  }
+
+  ~RRRBitvector() = default;
+  RRRBitvector(const RRRBitvector&) = default;
+  RRRBitvector(RRRBitvector&&) = default;
+  RRRBitvector& operator=(const RRRBitvector&) = default;
+  RRRBitvector& operator=(RRRBitvector&&) = default;
+
+  /**
+   * @brief Rank on the compressed bits
+   *
+   * Sums the classes of the blocks after the last sample (< sample_rate)
+   * and decodes the block containing indx
+   *
+   * @param indx index (must be valid)
+   * @return std::size_t # of bits set to 1 in [0, indx] (returns 0 if empty)
+   */
+  std::size_t rank(std::size_t indx) const {
+    if (num_bits_ == 0) return 0;
+    std::size_t block = indx / block_size;
+    std::size_t ones = 0;
+    std::size_t offset_pos = 0;
+    locate(block, ones, offset_pos);
+    uint64_t bits = decodeBlock(block, offset_pos);
+    return ones +
+           __builtin_popcountll(bits & lower_bits_set[indx % block_size + 1]);
+  }
+
+  /**
+   * @brief Rank on the compressed bits
+   *
+   * @param indx index (must be valid)
+   * @param value what to count 0, 1
+   * @return std::size_t # of bits set to value [0, indx] (returns 0 if empty)
+   */
+  std::size_t rank(std::size_t indx, bool value) const {
+    if (num_bits_ == 0) return 0;
+    if (value) return rank(indx);  // count 1
+    return indx - rank(indx) + 1;  // count 0
+  }
+
+  /**
+   * @brief Counter of value from start to end
+   *
+   * @param start range
+   * @param end range
+   * @param value what to count 0, 1
+   * @return std::size_t # ob bits set to value in [start, end]
+   */
+  std::size_t rank(std::size_t start, std::size_t end, bool value) const {
+    if (start == 0) return rank(end, value);
+    std::size_t r_end = rank(end, value);
+    std::size_t r_start = rank(start - 1, value);
+    if (r_end <= r_start) return 0;
+    return r_end - r_start;
+  }
+
+  /**
+   * @brief Starts loading in cache the samples and the first class rank(indx)
+   * reads
+   *
+   * @param indx index (must be valid)
+   */
+  void prefetch(std::size_t indx) const {
+    if (num_bits_ == 0) return;
+    std::size_t sample = indx / block_size / sample_rate;
+    __builtin_prefetch(rank_samples_.data() + sample);
+    __builtin_prefetch(offset_samples_.data() + sample);
+    classes_.prefetch(sample * sample_rate);
+  }
+
+  /**
+   * @brief Select on the compressed bits
+   *
+   * Binary search on the samples, then the classes of the following blocks
+   * are summed until the block containing the bit is found and decoded
+   *
+   * @param count i-th element searched
+   * @param value what to search 0, 1
+   * @return std::size_t position in bv of the i-th value, -1 if not present
+   * (returns 0 if empty)
+   */
+  std::size_t select(std::size_t count, bool value) const {
+    if (num_bits_ == 0) return 0;
+    if (count == 0 || count > GetTotal(value)) return -1;
+
+    // last sample with less than count values before it
+    std::size_t lo = 0;
+    std::size_t hi = rank_samples_.size() - 1;
+    while (lo < hi) {
+      std::size_t mid = lo + (hi - lo + 1) / 2;
+      if (sampleRank(mid, value) < count)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+
+    // padding bits of the last block come after every valid bit
+    std::size_t seen = sampleRank(lo, value);
+    std::size_t offset_pos = offset_samples_[lo];
+    for (std::size_t block = lo * sample_rate;; ++block) {
+      uint8_t cls = classes_[block].getValue();
+      std::size_t in_block = value ? cls : block_size - cls;
+      if (seen + in_block >= count) {
+        uint64_t bits = decodeBlock(block, offset_pos);
+        if (!value) bits = ~bits & lower_bits_set[block_size];
+        return block * block_size + select_in_word(bits, count - seen - 1);
+      }
+      seen += in_block;
+      offset_pos += detail::rrr_offset_bits[cls];
+    }
+  }
+
+  /**
+   * @brief Access single bit
+   *
+   * @param bit_pos position of bit to access
+   * @return bool value of bit at bit_pos
+   */
+  bool GetBit(std::size_t bit_pos) const {
+    std::size_t block = bit_pos / block_size;
+    std::size_t ones = 0;
+    std::size_t offset_pos = 0;
+    locate(block, ones, offset_pos);
+    return decodeBlock(block, offset_pos) & bit_set[bit_pos % block_size];
+  }
+
+  /**
+   * @brief Number of bits set to value in the bitvector
+   *
+   * @param value what to count 0, 1
+   * @return std::size_t # of bits set to value
+   */
+  std::size_t GetTotal(bool value) const {
+    return value ? total_ones_ : num_bits_ - total_ones_;
+  }
+
+  /**
+   * @brief Size of the compressed bitvector
+   *
+   * @return std::size_t number of bits
+   */
+  std::size_t size() const { return num_bits_; }
+
+  /**
+   * @brief Memory used by the compressed bits and the samples
+   *
+   * @return std::size_t # of bits used (compare with size())
+   */
+  std::size_t GetSizeInBits() const {
+    return classes_.getNumBits() + offsets_.size() * Bitvector::type_size +
+           (rank_samples_.size() + offset_samples_.size()) *
+               sizeof(std::size_t) * 8;
+  }
+
+ private:
+  /**
+   * @brief Offset of the blocks of class cls with value bits
+   */
+  static uint64_t encode(uint64_t bits, uint8_t cls) {
+    uint64_t offset = 0;
+    for (std::size_t i = 0; cls > 0; ++i) {
+      if (bits & bit_set[i]) {
+        // blocks with bit i = 0 and the same bits before i come first
+        offset += detail::rrr_binomials[block_size - 1 - i][cls];
+        --cls;
+      }
+    }
+    return offset;
+  }
+
+  /**
+   * @brief Bits of the block of class cls with offset (inverse of encode)
+   */
+  static uint64_t decode(uint64_t offset, uint8_t cls) {
+    if (cls == block_size) return lower_bits_set[block_size];
+    uint64_t bits = 0;
+    for (std::size_t i = 0; cls > 0; ++i) {
+      uint64_t skip = detail::rrr_binomials[block_size - 1 - i][cls];
+      if (offset >= skip) {
+        bits |= bit_set[i];
+        offset -= skip;
+        --cls;
+      }
+    }
+    return bits;
+  }
+
+  /**
+   * @brief Bits of block, its offset starts at offset_pos in offsets_
+   */
+  uint64_t decodeBlock(std::size_t block, std::size_t offset_pos) const {
+    uint8_t cls = classes_[block].getValue();
+    uint8_t len = detail::rrr_offset_bits[cls];
+    uint64_t offset =
+        len ? read_bits(offsets_.data() + offset_pos / Bitvector::type_size,
+                        offset_pos % Bitvector::type_size, len)
+            : 0;
+    return decode(offset, cls);
+  }
+
+  /**
+   * @brief # of 1s before block and position of its offset in offsets_
+   */
+  void locate(std::size_t block, std::size_t& ones,
+              std::size_t& offset_pos) const {
+    std::size_t sample = block / sample_rate;
+    ones = rank_samples_[sample];
+    offset_pos = offset_samples_[sample];
+    for (std::size_t b = sample * sample_rate; b < block; ++b) {
+      uint8_t cls = classes_[b].getValue();
+      ones += cls;
+      offset_pos += detail::rrr_offset_bits[cls];
+    }
+  }
+
+  /**
+   * @brief # of bits set to value before the sample-th sampled block
+   */
+  std::size_t sampleRank(std::size_t sample, bool value) const {
+    return value ? rank_samples_[sample]
+                 : sample * sample_rate * block_size - rank_samples_[sample];
+  }
+
+  /**
+   * @brief Splits the bits of bv in blocks, fills classes, offsets, samples
+   */
+  void init(const unialgo::utils::Bitvector& bv,
+            std::pmr::memory_resource* resource) {
+    std::size_t num_blocks = (num_bits_ + block_size - 1) / block_size;
+    classes_ = WordVector(num_blocks, 6, resource);
+    std::size_t num_samples = (num_blocks + sample_rate - 1) / sample_rate;
+    rank_samples_.reserve(num_samples);
+    offset_samples_.reserve(num_samples);
+    // the size of the offsets is known at the end: they grow off resource
+    // and are copied on it once done
+    BitvectorBuilder offsets;
+    const auto* data = bv.data();
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+      if (block % sample_rate == 0) {
+        rank_samples_.push_back(total_ones_);
+        offset_samples_.push_back(offsets.size());
+      }
+      std::size_t pos = block * block_size;
+      uint64_t bits =
+          read_bits(data + pos / Bitvector::type_size,
+                    pos % Bitvector::type_size,
+                    std::min(block_size, num_bits_ - pos));
+      uint8_t cls = __builtin_popcountll(bits);
+      classes_[block] = cls;
+      offsets.append_bits(encode(bits, cls), detail::rrr_offset_bits[cls]);
+      total_ones_ += cls;
+    }
+    WordBuffer words = offsets.releaseWords();
+    offsets_ =
+        WordBuffer(WordBuffer::Storage(words.begin(), words.end(), resource));
+  }
+
+  std::size_t num_bits_;    // size of the compressed bitvector
+  std::size_t total_ones_;  // # of 1s in the bitvector
+  unialgo::utils::WordVector classes_;            // # of 1s of every block
+  WordBuffer offsets_;                            // packed block offsets
+  std::pmr::vector<std::size_t> rank_samples_;    // 1s before sampled blocks
+  std::pmr::vector<std::size_t> offset_samples_;  // offset pos of samples
+
+};  // RRRBitvector
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_RRRBITVECTOR_
@@ -0,0 +1,104 @@
+#include "unialgo/utils/bitvector/serialize.hpp"
+
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+
+namespace unialgo {
+namespace utils {
+
+// ============ Implementation SerialWriter ============
+
+void SerialWriter::header(serial::Tag tag) {
+  value(serial::magic);
+  value(static_cast<uint64_t>(serial::version) << 32 |
+        static_cast<uint32_t>(tag));
+}
+
+void SerialWriter::value(uint64_t value) {
+  os_.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void SerialWriter::words(const uint64_t* words, std::size_t n) {
+  value(n);
+  os_.write(reinterpret_cast<const char*>(words), n * sizeof(uint64_t));
+}
+
+// ============ Implementation SerialReader ============
+
+SerialReader SerialReader::fromFile(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("unialgo: cannot open " + path);
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::runtime_error("unialgo: cannot stat " + path);
+  }
+  std::size_t bytes = st.st_size;
+  if (bytes == 0 || bytes % sizeof(uint64_t) != 0) {
+    ::close(fd);
+    throw std::runtime_error("unialgo: not a serialized structure " + path);
+  }
+  // private mapping: pages are shared with the page cache until written
+  void* addr =
+      ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED)
+    throw std::runtime_error("unialgo: cannot map " + path);
+
+  std::shared_ptr<void> owner(addr,
+                              [bytes](void* p) { ::munmap(p, bytes); });
+  return SerialReader(nullptr, static_cast<uint64_t*>(addr),
+                      bytes / sizeof(uint64_t), std::move(owner));
+}
+
+SerialReader SerialReader::fromStream(std::istream& is) {
+  return SerialReader(&is, nullptr, 0, nullptr);
+}
+
+void SerialReader::header(serial::Tag tag) {
+  if (value() != serial::magic)
+    throw std::runtime_error("unialgo: bad magic, not a serialized structure");
+  uint64_t info = value();
+  if ((info >> 32) == 0 || (info >> 32) > serial::version)
+    throw std::runtime_error("unialgo: unsupported format version");
+  if (static_cast<uint32_t>(info) != static_cast<uint32_t>(tag))
+    throw std::runtime_error("unialgo: serialized structure of another type");
+}
+
+uint64_t SerialReader::value() {
+  uint64_t res;
+  if (is_) {
+    readStream(&res, 1);
+    return res;
+  }
+  require(1);
+  return data_[pos_++];
+}
+
+WordBuffer SerialReader::words() {
+  std::size_t n = value();
+  if (is_) {
+    WordBuffer res(n);
+    readStream(res.data(), n);
+    return res;
+  }
+  require(n);
+  WordBuffer res(data_ + pos_, n, owner_);
+  pos_ += n;
+  return res;
+}
+
+void SerialReader::readStream(uint64_t* dst, std::size_t n) {
+  is_->read(reinterpret_cast<char*>(dst), n * sizeof(uint64_t));
+  if (!*is_) throw std::runtime_error("unialgo: truncated serialized data");
+}
+
+void SerialReader::require(std::size_t n) const {
+  if (n > size_ - pos_)
+    throw std::runtime_error("unialgo: truncated serialized data");
+}
+
+}  // namespace utils
+}  // namespace unialgo
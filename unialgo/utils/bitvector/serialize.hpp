@@ -0,0 +1,184 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_SERIALIZE_
+#define UNIALGO_UTILS_BITVECTOR_SERIALIZE_
+
+#include <stdint.h>  // uint64_t, uint32_t
+
+#include <fstream>    // std::ofstream
+#include <istream>    // std::istream
+#include <memory>     // std::shared_ptr
+#include <ostream>    // std::ostream
+#include <stdexcept>  // std::runtime_error
+#include <string>     // std::string
+#include <utility>    // std::move
+
+#include "unialgo/utils/bitvector/wordBuffer.hpp"
+
+/**
+ * @file This file contains the binary format of the succinct structures
+ *
+ * A file is a sequence of 64-bit words in native byte order. Every structure
+ * starts with a header (magic, format version, structure tag) followed by its
+ * fields as words, word arrays are prefixed by their length. Everything is
+ * word aligned so a mapped file can be viewed in place:
+ *
+ *   auto bv = unialgo::utils::loadMapped<Bitvector>("bv.bin");
+ *
+ * Errors while reading (bad magic, unknown version, wrong tag, truncated
+ * data, failing I/O) throw std::runtime_error
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+namespace serial {
+static const uint64_t magic = 0x004f474c41494e55;  // "UNIALGO\0"
+static const uint32_t version = 1;                 // current format version
+
+// identifies the structure that follows a header
+enum class Tag : uint32_t {
+  kBitvector = 1,
+  kWordVector = 2,
+  kRankHelper = 3,
+};
+}  // namespace serial
+
+/**
+ * @brief Writes words of the binary format to a stream
+ */
+class SerialWriter {
+ public:
+  explicit SerialWriter(std::ostream& os) : os_(os) {}
+
+  /**
+   * @brief Writes the header of a structure
+   */
+  void header(serial::Tag tag);
+
+  /**
+   * @brief Writes a single word
+   */
+  void value(uint64_t value);
+
+  /**
+   * @brief Writes n followed by the n words
+   */
+  void words(const uint64_t* words, std::size_t n);
+
+ private:
+  std::ostream& os_;  // destination
+};
+
+/**
+ * @brief Reads words of the binary format from a mapped file or a stream
+ *
+ * On a mapped file word arrays are returned as WordBuffer views of the
+ * mapping (no copy), on a stream they are read in owning buffers
+ */
+class SerialReader {
+ public:
+  /**
+   * @brief Reader on a memory-mapped file (MAP_PRIVATE, so structures can
+   * still be modified without touching the file)
+   *
+   * @param path file to map
+   */
+  static SerialReader fromFile(const std::string& path);
+
+  /**
+   * @brief Reader on a stream, only the words of the structure are consumed
+   */
+  static SerialReader fromStream(std::istream& is);
+
+  /**
+   * @brief Reads and checks the header of a structure
+   *
+   * @param tag structure expected
+   */
+  void header(serial::Tag tag);
+
+  /**
+   * @brief Reads a single word
+   */
+  uint64_t value();
+
+  /**
+   * @brief Reads a word array written by SerialWriter::words
+   *
+   * @return WordBuffer with the words (a view when reading a mapped file)
+   */
+  WordBuffer words();
+
+ private:
+  SerialReader(std::istream* is, uint64_t* data, std::size_t size,
+               std::shared_ptr<void> owner)
+      : is_(is), data_(data), size_(size), pos_(0), owner_(std::move(owner)) {}
+
+  /**
+   * @brief Reads n words to dst from the stream
+   */
+  void readStream(uint64_t* dst, std::size_t n);
+
+  /**
+   * @brief Throws if less than n words are left
+   */
+  void require(std::size_t n) const;
+
+  std::istream* is_;             // source stream, nullptr for mapped files
+  uint64_t* data_;               // first word of the memory
+  std::size_t size_;             // # of words in memory
+  std::size_t pos_;              // next word to read
+  std::shared_ptr<void> owner_;  // keeps memory alive
+};
+
+/**
+ * @brief Writes obj to os in the binary format
+ *
+ * @tparam T structure with void write(SerialWriter&) const
+ */
+template <typename T>
+void save(const T& obj, std::ostream& os) {
+  SerialWriter writer(os);
+  obj.write(writer);
+}
+
+/**
+ * @brief Writes obj to the file at path in the binary format
+ */
+template <typename T>
+void save(const T& obj, const std::string& path) {
+  std::ofstream os(path, std::ios::binary | std::ios::trunc);
+  if (!os) throw std::runtime_error("unialgo: cannot open " + path);
+  save(obj, os);
+  os.flush();
+  if (!os) throw std::runtime_error("unialgo: cannot write " + path);
+}
+
+/**
+ * @brief Reads a structure from is (words are copied in memory)
+ *
+ * @tparam T structure with static T read(SerialReader&)
+ */
+template <typename T>
+T load(std::istream& is) {
+  SerialReader reader = SerialReader::fromStream(is);
+  return T::read(reader);
+}
+
+/**
+ * @brief Maps the file at path and views the words of the structure in place
+ *
+ * Only the header and the sizes are read, words are paged in on access
+ *
+ * @tparam T structure with static T read(SerialReader&)
+ */
+template <typename T>
+T loadMapped(const std::string& path) {
+  SerialReader reader = SerialReader::fromFile(path);
+  return T::read(reader);
+}
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_SERIALIZE_
@@ -1,9 +1,17 @@
 #include <gtest/gtest.h>
 
-#include <algorithm>  // std::sort
+#include <algorithm>  // std::sort, std::min_element
 #include <cmath>
-#include <memory>   // std::shared_ptr
-#include <utility>  // std::swap
+#include <cstdio>           // std::remove
+#include <functional>       // std::greater
+#include <memory>           // std::shared_ptr
+#include <memory_resource>  // std::pmr::memory_resource
+#include <random>           // std::mt19937
+#include <sstream>          // std::stringstream
+#include <string>           // std::string
+#include <thread>           // std::thread
+#include <unordered_set>    // std::unordered_set
+#include <utility>          // std::swap
 
 #include "unialgo/utils/bitvector/bitVectors.hpp"
 
@@ -713,6 +721,22 @@ TEST(TestingWordVector, testingIteratorEnd) {
   EXPECT_EQ(std::next(wv.begin(), 10), wv.end());
 }
 
+// testing iterators of empty vectors and end() past the last word
+TEST(TestingWordVector, testingIteratorEmpty) {
+  unialgo::utils::WordVector empty;
+  EXPECT_EQ(empty.begin(), empty.end());
+  EXPECT_EQ(empty.cbegin(), empty.cend());
+  for (auto value : empty) ADD_FAILURE() << value;
+
+  // 32 words of 4 bits fill two words: end() is past them
+  unialgo::utils::WordVector full(32, 4);
+  full[31] = 9;
+  auto it = full.end();
+  it = full.end();
+  EXPECT_EQ(*--it, 9);
+  EXPECT_EQ(full.cend() - full.cbegin(), 32);
+}
+
 // testing iterator end
 TEST(TestingWordVector, testingIteratorValueType) {
   unialgo::utils::WordVector wv(10);
@@ -1125,4 +1149,1065 @@ TEST(TestingHelpers, TestingRank0s) {
   EXPECT_EQ(helper2.rank(0, 100, 1), count1);
 }
 
-}  // namespace
\ No newline at end of file
+TEST(TestingHelpers, TestingSelectDirectory) {
+  // dense, sparse and mixed regions to go through scan and layer search
+  auto bv = std::make_shared<unialgo::utils::Bitvector>(20000);
+  std::mt19937 gen(42);
+  for (std::size_t i = 0; i < 5000; ++i)
+    if (gen() % 2) bv->SetBit(i);
+  for (std::size_t i = 5000; i < 15000; i += 997) bv->SetBit(i);
+  for (std::size_t i = 15000; i < 20000; ++i)
+    if (gen() % 8) bv->SetBit(i);
+  unialgo::utils::RankHelper helper(bv);
+
+  std::size_t count[2] = {0, 0};
+  for (std::size_t i = 0; i < bv->size(); ++i) {
+    bool value = bv->GetBit(i);
+    ++count[value];
+    EXPECT_EQ(helper.select(count[value], value), i);
+  }
+  EXPECT_EQ(helper.GetTotal(0), count[0]);
+  EXPECT_EQ(helper.GetTotal(1), count[1]);
+  EXPECT_EQ(helper.select(count[1] + 1, 1), static_cast<std::size_t>(-1));
+  EXPECT_EQ(helper.select(count[0] + 1, 0), static_cast<std::size_t>(-1));
+  EXPECT_EQ(helper.select(0, 1), static_cast<std::size_t>(-1));
+  EXPECT_GT(helper.GetSelectOverhead(), 0);
+}
+
+TEST(TestingHelpers, TestingSelectWordBoundaries) {
+  auto bv = std::make_shared<unialgo::utils::Bitvector>(130);
+  bv->SetBit(63);
+  bv->SetBit(64);
+  bv->SetBit(129);
+  unialgo::utils::RankHelper helper(bv);
+  EXPECT_EQ(helper.select(1, 1), 63);
+  EXPECT_EQ(helper.select(2, 1), 64);
+  EXPECT_EQ(helper.select(3, 1), 129);
+  EXPECT_EQ(helper.select(63, 0), 62);
+  EXPECT_EQ(helper.select(64, 0), 65);
+  EXPECT_EQ(helper.select(127, 0), 128);
+  EXPECT_EQ(helper.select(128, 0), static_cast<std::size_t>(-1));
+}
+
+TEST(TestingHelpers, TestingInterleavedRankHelper) {
+  auto bv = std::make_shared<unialgo::utils::Bitvector>(1000);
+  std::mt19937 gen(7);
+  for (std::size_t i = 0; i < bv->size(); ++i)
+    if (gen() % 3 == 0) bv->SetBit(i);
+  unialgo::utils::RankHelper expected(bv);
+  unialgo::utils::InterleavedRankHelper helper(bv);
+
+  EXPECT_EQ(helper.size(), bv->size());
+  for (std::size_t i = 0; i < bv->size(); ++i) {
+    EXPECT_EQ(helper.GetBit(i), bv->GetBit(i));
+    EXPECT_EQ(helper.rank(i), expected.rank(i));
+    EXPECT_EQ(helper.rank(i, 0), expected.rank(i, 0));
+  }
+  EXPECT_EQ(helper.rank(10, 500, 1), expected.rank(10, 500, 1));
+  for (std::size_t i = 1; i <= helper.GetTotal(1) + 1; ++i)
+    EXPECT_EQ(helper.select(i, 1), expected.select(i, 1));
+  for (std::size_t i = 1; i <= helper.GetTotal(0) + 1; ++i)
+    EXPECT_EQ(helper.select(i, 0), expected.select(i, 0));
+}
+
+TEST(TestingHelpers, RankBatch) {
+  auto bv = std::make_shared<unialgo::utils::Bitvector>(100000);
+  std::mt19937 gen(11);
+  for (std::size_t i = 0; i < bv->size(); ++i)
+    if (gen() % 5 == 0) bv->SetBit(i);
+  unialgo::utils::RankHelper helper(bv);
+  unialgo::utils::InterleavedRankHelper interleaved(bv);
+
+  // random positions, less and more queries than the prefetch distance
+  for (std::size_t n : {0, 5, 1000}) {
+    std::vector<std::size_t> pos(n);
+    for (auto& p : pos) p = gen() % bv->size();
+    std::vector<std::size_t> out(n);
+    std::vector<std::size_t> out_interleaved(n);
+    helper.rank_batch(pos.data(), n, out.data());
+    interleaved.rank_batch(pos.data(), n, out_interleaved.data());
+    for (std::size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(out[i], helper.rank(pos[i]));
+      EXPECT_EQ(out_interleaved[i], helper.rank(pos[i]));
+    }
+  }
+}
+
+TEST(TestingHelpers, TestingRankFullPowerOfTwo) {
+  // counts up to bv->size() must fit the first layer
+  auto bv = std::make_shared<unialgo::utils::Bitvector>(64);
+  for (std::size_t i = 0; i < 64; ++i) bv->SetBit(i);
+  unialgo::utils::RankHelper helper(bv);
+  for (std::size_t i = 0; i < 64; ++i) EXPECT_EQ(helper.rank(i), i + 1);
+}
+
+TEST(TestingHelpers, TestingParallelInit) {
+  auto bv = std::make_shared<unialgo::utils::Bitvector>(300000);
+  std::mt19937 gen(3);
+  for (std::size_t i = 0; i < bv->size(); ++i)
+    if (gen() % 5 < 2) bv->SetBit(i);
+  unialgo::utils::RankHelper expected(bv);
+
+  for (std::size_t threads : {2, 3, 8}) {
+    unialgo::utils::RankHelper helper(bv, threads);
+    for (std::size_t i = 0; i < bv->size(); i += 7)
+      EXPECT_EQ(helper.rank(i), expected.rank(i));
+    EXPECT_EQ(helper.rank(bv->size() - 1), expected.rank(bv->size() - 1));
+  }
+}
+
+// Testing operator |, ^, ~, AndNot against bit by bit results
+TEST(TestBitvector, BitwiseOperators) {
+  unialgo::utils::Bitvector a(300);
+  unialgo::utils::Bitvector b(300);
+  std::mt19937 gen(11);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (gen() % 2) a.SetBit(i);
+    if (gen() % 2) b.SetBit(i);
+  }
+
+  unialgo::utils::Bitvector o = a | b;
+  unialgo::utils::Bitvector x = a ^ b;
+  unialgo::utils::Bitvector n = ~a;
+  unialgo::utils::Bitvector an = a.AndNot(b);
+  unialgo::utils::Bitvector d = a & b;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(o.GetBit(i), a.GetBit(i) || b.GetBit(i));
+    EXPECT_EQ(x.GetBit(i), a.GetBit(i) != b.GetBit(i));
+    EXPECT_EQ(n.GetBit(i), !a.GetBit(i));
+    EXPECT_EQ(an.GetBit(i), a.GetBit(i) && !b.GetBit(i));
+    EXPECT_EQ(d.GetBit(i), a.GetBit(i) && b.GetBit(i));
+  }
+  // bits past size() are not set by ~
+  EXPECT_EQ(~n, a);
+
+  unialgo::utils::Bitvector c = a;
+  c |= b;
+  EXPECT_EQ(c, o);
+  c = a;
+  c ^= b;
+  EXPECT_EQ(c, x);
+  c = a;
+  c.AndNotAssign(b);
+  EXPECT_EQ(c, an);
+  c.Reset();
+  EXPECT_EQ(c, unialgo::utils::Bitvector(300));
+}
+
+// Testing shifts by amounts smaller and bigger than a word
+TEST(TestBitvector, ShiftOperators) {
+  unialgo::utils::Bitvector a(333);
+  std::mt19937 gen(5);
+  for (std::size_t i = 0; i < a.size(); ++i)
+    if (gen() % 3 == 0) a.SetBit(i);
+
+  for (std::size_t shift : {0, 1, 5, 63, 64, 65, 128, 200, 332, 333, 500}) {
+    unialgo::utils::Bitvector r = a >> shift;
+    unialgo::utils::Bitvector l = a << shift;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+      bool right = i + shift < a.size() && a.GetBit(i + shift);
+      bool left = i >= shift && a.GetBit(i - shift);
+      EXPECT_EQ(r.GetBit(i), right) << "shift " << shift << " bit " << i;
+      EXPECT_EQ(l.GetBit(i), left) << "shift " << shift << " bit " << i;
+    }
+    // dropped bits do not come back
+    EXPECT_EQ((l >> shift) << shift, l);
+  }
+}
+
+// Testing count / find_first / find_next / ones() against GetBit, sizes
+// cover the scalar tail and the vector popcount kernels
+TEST(TestBitvector, CountAndFindSetBits) {
+  std::mt19937 gen(5);
+  for (std::size_t size : {1, 63, 64, 65, 500, 4096, 10000, 70000}) {
+    for (std::size_t density : {1, 10, 50}) {
+      unialgo::utils::Bitvector bv(size);
+      std::vector<std::size_t> expected;
+      for (std::size_t i = 0; i < size; ++i) {
+        if (gen() % 100 < density) {
+          bv.SetBit(i);
+          expected.push_back(i);
+        }
+      }
+      EXPECT_EQ(bv.count(), expected.size());
+
+      std::vector<std::size_t> visited;
+      for (std::size_t pos : bv.ones()) visited.push_back(pos);
+      EXPECT_EQ(visited, expected);
+
+      visited.clear();
+      for (std::size_t pos = bv.find_first();
+           pos != unialgo::utils::Bitvector::npos; pos = bv.find_next(pos))
+        visited.push_back(pos);
+      EXPECT_EQ(visited, expected);
+    }
+  }
+
+  unialgo::utils::Bitvector empty(200);
+  EXPECT_EQ(empty.count(), 0);
+  EXPECT_EQ(empty.find_first(), unialgo::utils::Bitvector::npos);
+  EXPECT_EQ(empty.find_next(10), unialgo::utils::Bitvector::npos);
+  EXPECT_TRUE(empty.ones().begin() == empty.ones().end());
+
+  empty.SetBit(199);
+  EXPECT_EQ(empty.find_first(), 199);
+  EXPECT_EQ(empty.find_next(0), 199);
+  EXPECT_EQ(empty.find_next(199), unialgo::utils::Bitvector::npos);
+  EXPECT_EQ(unialgo::utils::Bitvector().count(), 0);
+}
+
+// ============ Testing serialization ============
+
+// Testing save / load through a stream and through a mapped file
+TEST(TestSerialize, BitvectorAndWordVector) {
+  unialgo::utils::Bitvector bv(1000);
+  unialgo::utils::WordVector wv(300, 13);
+  std::mt19937 gen(3);
+  for (std::size_t i = 0; i < bv.size(); ++i)
+    if (gen() % 3 == 0) bv.SetBit(i);
+  for (std::size_t i = 0; i < wv.size(); ++i) wv[i] = gen() % 8192;
+
+  std::stringstream ss;
+  unialgo::utils::save(bv, ss);
+  unialgo::utils::save(wv, ss);
+  EXPECT_EQ(unialgo::utils::load<unialgo::utils::Bitvector>(ss), bv);
+  unialgo::utils::WordVector wv_loaded =
+      unialgo::utils::load<unialgo::utils::WordVector>(ss);
+  ASSERT_EQ(wv_loaded.size(), wv.size());
+  ASSERT_EQ(wv_loaded.getWordSize(), wv.getWordSize());
+  for (std::size_t i = 0; i < wv.size(); ++i) EXPECT_EQ(wv_loaded[i], wv[i]);
+
+  std::string path = testing::TempDir() + "unialgo_bv.bin";
+  unialgo::utils::save(bv, path);
+  unialgo::utils::Bitvector mapped =
+      unialgo::utils::loadMapped<unialgo::utils::Bitvector>(path);
+  EXPECT_EQ(mapped, bv);
+
+  // writes to a mapped bitvector stay private to the process
+  mapped.Reset();
+  EXPECT_EQ(mapped.count(), 0);
+  EXPECT_EQ(unialgo::utils::loadMapped<unialgo::utils::Bitvector>(path), bv);
+
+  // copies of a mapped bitvector own their words
+  unialgo::utils::Bitvector copy =
+      unialgo::utils::loadMapped<unialgo::utils::Bitvector>(path);
+  unialgo::utils::Bitvector owned(copy);
+  copy.Reset();
+  EXPECT_EQ(owned, bv);
+  std::remove(path.c_str());
+}
+
+// Testing a mapped RankHelper answers as the one it was saved from
+TEST(TestSerialize, RankHelper) {
+  auto bv = std::make_shared<unialgo::utils::Bitvector>(20000);
+  std::mt19937 gen(8);
+  for (std::size_t i = 0; i < bv->size(); ++i)
+    if (gen() % 5 == 0) bv->SetBit(i);
+  unialgo::utils::RankHelper rs(bv);
+
+  std::string path = testing::TempDir() + "unialgo_rank.bin";
+  unialgo::utils::save(rs, path);
+  unialgo::utils::RankHelper mapped =
+      unialgo::utils::loadMapped<unialgo::utils::RankHelper>(path);
+  ASSERT_EQ(mapped.size(), rs.size());
+  for (std::size_t i = 0; i < bv->size(); i += 7) {
+    EXPECT_EQ(mapped.rank(i), rs.rank(i));
+    EXPECT_EQ(mapped.GetBit(i), bv->GetBit(i));
+  }
+  for (std::size_t k = 1; k <= rs.GetTotal(1); k += 11)
+    EXPECT_EQ(mapped.select(k, 1), rs.select(k, 1));
+  for (std::size_t k = 1; k <= rs.GetTotal(0); k += 11)
+    EXPECT_EQ(mapped.select(k, 0), rs.select(k, 0));
+  std::remove(path.c_str());
+}
+
+// Testing malformed input is rejected
+TEST(TestSerialize, Errors) {
+  unialgo::utils::Bitvector bv(100);
+  std::stringstream ss;
+  unialgo::utils::save(bv, ss);
+  std::string data = ss.str();
+
+  // wrong structure
+  std::stringstream wrong(data);
+  EXPECT_THROW(unialgo::utils::load<unialgo::utils::WordVector>(wrong),
+               std::runtime_error);
+  // truncated
+  std::stringstream truncated(data.substr(0, data.size() - 8));
+  EXPECT_THROW(unialgo::utils::load<unialgo::utils::Bitvector>(truncated),
+               std::runtime_error);
+  // bad magic
+  std::stringstream garbage(std::string(64, 'x'));
+  EXPECT_THROW(unialgo::utils::load<unialgo::utils::Bitvector>(garbage),
+               std::runtime_error);
+  EXPECT_THROW(unialgo::utils::loadMapped<unialgo::utils::Bitvector>(
+                   testing::TempDir() + "unialgo_missing.bin"),
+               std::runtime_error);
+}
+
+// Testing select samples not matching the bitvector are rejected
+TEST(TestSerialize, RankHelperSelect) {
+  // same size, all 0s and all 1s: one of the select samples is empty
+  auto zeros = std::make_shared<unialgo::utils::Bitvector>(1000);
+  auto ones = std::make_shared<unialgo::utils::Bitvector>(1000);
+  for (std::size_t i = 0; i < ones->size(); ++i) ones->SetBit(i);
+  std::stringstream zeros_ss;
+  std::stringstream ones_ss;
+  unialgo::utils::save(unialgo::utils::RankHelper(zeros), zeros_ss);
+  unialgo::utils::save(unialgo::utils::RankHelper(ones), ones_ss);
+  std::string zeros_data = zeros_ss.str();
+  std::string ones_data = ones_ss.str();
+  ASSERT_EQ(zeros_data.size(), ones_data.size());
+
+  // the select samples are the last two word vectors: 4 positions of 10 bits
+  // in a word for the non empty one, 5 words of header each
+  const std::size_t tail = 8 * (5 + 5 + 1);
+  std::stringstream swapped(zeros_data.substr(0, zeros_data.size() - tail) +
+                            ones_data.substr(ones_data.size() - tail));
+  EXPECT_THROW(unialgo::utils::load<unialgo::utils::RankHelper>(swapped),
+               std::runtime_error);
+
+  // word size of the select samples of 0s: the value before the last 2 words
+  std::string wide = zeros_data;
+  wide[wide.size() - 8 * 3] = 11;
+  std::stringstream wide_ss(wide);
+  EXPECT_THROW(unialgo::utils::load<unialgo::utils::RankHelper>(wide_ss),
+               std::runtime_error);
+
+  std::stringstream good(zeros_data);
+  EXPECT_EQ(
+      unialgo::utils::load<unialgo::utils::RankHelper>(good).select(300, 0),
+      299);
+}
+
+// ============ Testing views ============
+
+// Testing BitvectorView (and slices at every offset) against Bitvector
+TEST(TestViews, BitvectorView) {
+  unialgo::utils::Bitvector bv(700);
+  std::mt19937 gen(21);
+  for (std::size_t i = 0; i < bv.size(); ++i)
+    if (gen() % 4 == 0) bv.SetBit(i);
+
+  unialgo::utils::BitvectorView view(bv);
+  EXPECT_EQ(view.size(), bv.size());
+  EXPECT_EQ(view.count(), bv.count());
+  std::size_t i = 0;
+  for (bool bit : view) EXPECT_EQ(bit, bv.GetBit(i++));
+  EXPECT_EQ(i, bv.size());
+
+  for (std::size_t start : {0, 1, 37, 63, 64, 65, 200}) {
+    std::size_t end = bv.size() - 1 - start / 2;
+    unialgo::utils::BitvectorView slice = view.slice(start, end);
+    EXPECT_TRUE(slice == unialgo::utils::BitvectorView(bv(start, end)));
+
+    std::size_t ones = 0;
+    std::vector<std::size_t> expected;
+    for (std::size_t j = 0; j < slice.size(); ++j) {
+      ASSERT_EQ(slice.GetBit(j), bv.GetBit(start + j));
+      if (bv.GetBit(start + j)) {
+        ++ones;
+        expected.push_back(j);
+      }
+      EXPECT_EQ(slice.rank(j), ones);
+      EXPECT_EQ(slice.rank(j, 0), j + 1 - ones);
+    }
+    EXPECT_EQ(slice.count(), ones);
+
+    std::vector<std::size_t> visited;
+    for (std::size_t pos : slice.ones()) visited.push_back(pos);
+    EXPECT_EQ(visited, expected);
+    visited.clear();
+    // ranges and iterators of a temporary slice keep a copy of it
+    for (std::size_t pos : view.slice(start, end).ones())
+      visited.push_back(pos);
+    EXPECT_EQ(visited, expected);
+    auto bit = view.slice(start, end).begin();
+    EXPECT_EQ(*++bit, bv.GetBit(start + 1));
+    visited.clear();
+    for (std::size_t pos = slice.find_first();
+         pos != unialgo::utils::BitvectorView::npos;
+         pos = slice.find_next(pos))
+      visited.push_back(pos);
+    EXPECT_EQ(visited, expected);
+
+    // 13 bits read across word boundaries
+    for (std::size_t j = 0; j + 13 <= slice.size(); j += 5) {
+      uint64_t expected_bits = 0;
+      for (std::size_t k = 0; k < 13; ++k)
+        expected_bits |= static_cast<uint64_t>(slice.GetBit(j + k)) << k;
+      ASSERT_EQ(slice.ReadBits(j, 13), expected_bits);
+    }
+  }
+}
+
+// Testing WordVectorView and its slices against WordVector
+TEST(TestViews, WordVectorView) {
+  unialgo::utils::WordVector wv(500, 11);
+  std::mt19937 gen(4);
+  for (std::size_t i = 0; i < wv.size(); ++i) wv[i] = gen() % 2048;
+
+  unialgo::utils::WordVectorView view(wv);
+  ASSERT_EQ(view.size(), wv.size());
+  EXPECT_EQ(view.getWordSize(), 11);
+  for (std::size_t i = 0; i < wv.size(); ++i) EXPECT_EQ(view[i], wv[i]);
+
+  unialgo::utils::WordVectorView slice = view.slice(7, 300);
+  ASSERT_EQ(slice.size(), 294);
+  std::size_t i = 7;
+  for (std::size_t value : slice) EXPECT_EQ(value, wv[i++]);
+  // iterators of a temporary slice keep a copy of it
+  auto first = view.slice(7, 300).begin();
+  EXPECT_EQ(first[10], wv[17]);
+
+  // random access iterators work with std algorithms
+  std::vector<std::size_t> sorted(slice.begin(), slice.end());
+  std::sort(sorted.begin(), sorted.end());
+  unialgo::utils::WordVector sorted_wv(sorted.size(), 11);
+  for (std::size_t j = 0; j < sorted.size(); ++j) sorted_wv[j] = sorted[j];
+  unialgo::utils::WordVectorView sorted_view(sorted_wv);
+  auto it = std::lower_bound(sorted_view.begin(), sorted_view.end(),
+                             sorted[100]);
+  EXPECT_EQ(*it, sorted[100]);
+  EXPECT_EQ(sorted_view.end() - sorted_view.begin(), sorted.size());
+}
+
+// ============ Testing builders ============
+
+// Testing push_back / append_bits against SetBit at every alignment
+TEST(TestBuilders, BitvectorBuilder) {
+  std::mt19937 gen(17);
+  unialgo::utils::BitvectorBuilder builder;
+  std::vector<bool> expected;
+  for (int step = 0; step < 500; ++step) {
+    if (gen() % 2) {
+      bool bit = gen() % 2;
+      builder.push_back(bit);
+      expected.push_back(bit);
+    } else {
+      uint8_t len = gen() % 65;
+      uint64_t word = (static_cast<uint64_t>(gen()) << 32) | gen();
+      builder.append_bits(word, len);
+      for (uint8_t k = 0; k < len; ++k) expected.push_back((word >> k) & 1);
+    }
+    ASSERT_EQ(builder.size(), expected.size());
+  }
+
+  unialgo::utils::Bitvector bv = builder.build();
+  ASSERT_EQ(bv.size(), expected.size());
+  unialgo::utils::Bitvector set_bv(expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i)
+    if (expected[i]) set_bv.SetBit(i);
+  EXPECT_EQ(bv, set_bv);
+  EXPECT_EQ(builder.size(), 0);
+  EXPECT_EQ(builder.build().size(), 0);
+}
+
+// Testing WordVectorBuilder against assignment with operator[]
+TEST(TestBuilders, WordVectorBuilder) {
+  for (uint8_t word_size : {1, 3, 7, 13, 32, 64}) {
+    std::mt19937 gen(word_size);
+    unialgo::utils::WordVectorBuilder builder(word_size);
+    builder.reserve(333);
+    unialgo::utils::WordVector expected(333, word_size);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      uint64_t value = (static_cast<uint64_t>(gen()) << 32) | gen();
+      value &= unialgo::utils::lower_bits_set[word_size];
+      builder.push_back(value);
+      expected[i] = value;
+    }
+    unialgo::utils::WordVector wv = builder.build();
+    ASSERT_EQ(wv.size(), expected.size());
+    EXPECT_EQ(wv.getWordSize(), word_size);
+    for (std::size_t i = 0; i < wv.size(); ++i) EXPECT_EQ(wv[i], expected[i]);
+  }
+}
+
+// ============ Testing FixedWordVector ============
+
+// Sets random values and checks them against a WordVector of the same width
+template <uint8_t W>
+void checkFixedWordVector(std::size_t size) {
+  std::mt19937 gen(W);
+  unialgo::utils::FixedWordVector<W> fwv(size);
+  unialgo::utils::WordVector wv(size, W);
+  for (std::size_t i = 0; i < size; ++i) {
+    uint64_t value = (static_cast<uint64_t>(gen()) << 32) | gen();
+    fwv[i] = value;
+    wv[i] = value & unialgo::utils::lower_bits_set[W];
+  }
+  ASSERT_EQ(fwv.size(), size);
+  for (std::size_t i = 0; i < size; ++i) ASSERT_EQ(fwv[i], wv[i]);
+
+  std::size_t i = 0;
+  fwv.for_each([&](std::size_t value) { EXPECT_EQ(value, wv[i++]); });
+  EXPECT_EQ(i, size);
+  EXPECT_EQ(std::vector<std::size_t>(fwv.begin(), fwv.end()),
+            std::vector<std::size_t>(unialgo::utils::WordVectorView(wv).begin(),
+                                     unialgo::utils::WordVectorView(wv).end()));
+
+  // conversions keep the packed layout
+  unialgo::utils::FixedWordVector<W> from_wv(wv);
+  unialgo::utils::WordVector to_wv = fwv.toWordVector();
+  for (std::size_t j = 0; j < size; ++j) {
+    EXPECT_EQ(from_wv[j], wv[j]);
+    EXPECT_EQ(to_wv[j], wv[j]);
+  }
+  // overwriting keeps the other words
+  fwv[size / 2] = 0;
+  EXPECT_EQ(fwv[size / 2], 0);
+  for (std::size_t j = 0; j < size; ++j) {
+    if (j != size / 2) {
+      ASSERT_EQ(fwv[j], wv[j]);
+    }
+  }
+}
+
+// Testing aligned (power of two) and straddling widths
+TEST(TestFixedWordVector, AccessAndScan) {
+  checkFixedWordVector<1>(200);
+  checkFixedWordVector<2>(1001);
+  checkFixedWordVector<4>(77);
+  checkFixedWordVector<8>(130);
+  checkFixedWordVector<16>(65);
+  checkFixedWordVector<32>(9);
+  checkFixedWordVector<64>(5);
+  checkFixedWordVector<3>(333);
+  checkFixedWordVector<13>(150);
+  checkFixedWordVector<63>(40);
+
+  unialgo::utils::FixedWordVector<2> dna(100);
+  for (std::size_t i = 0; i < dna.size(); ++i) dna[i] = i % 4;
+  EXPECT_EQ(dna.count(3), 25);
+  dna[5] = dna[3];
+  EXPECT_EQ(dna[5], 3);
+}
+
+// Testing decode / encode of ranges at every alignment against operator[]
+TEST(TestingWordVector, DecodeEncode) {
+  for (uint8_t word_size : {1, 2, 5, 8, 11, 16, 23, 32, 40, 64}) {
+    std::mt19937 gen(word_size);
+    unialgo::utils::WordVector wv(300, word_size);
+    for (std::size_t i = 0; i < wv.size(); ++i)
+      wv[i] = ((static_cast<uint64_t>(gen()) << 32) | gen()) &
+              unialgo::utils::lower_bits_set[word_size];
+
+    for (std::size_t start : {0, 1, 3, 64, 99}) {
+      std::size_t count = wv.size() - start - start / 3;
+      std::vector<uint64_t> out64(count);
+      wv.decode(start, count, out64.data());
+      for (std::size_t i = 0; i < count; ++i)
+        ASSERT_EQ(out64[i], wv[start + i]);
+      if (word_size <= 32) {
+        std::vector<uint32_t> out32(count);
+        wv.decode(start, count, out32.data());
+        for (std::size_t i = 0; i < count; ++i)
+          ASSERT_EQ(out32[i], wv[start + i]);
+      }
+
+      // encode new values in the range, words outside stay the same
+      unialgo::utils::WordVector copy = wv;
+      std::vector<uint64_t> in(count);
+      for (auto& value : in)
+        value = (static_cast<uint64_t>(gen()) << 32) | gen();
+      copy.encode(start, in.data(), count);
+      for (std::size_t i = 0; i < wv.size(); ++i) {
+        if (i >= start && i < start + count)
+          ASSERT_EQ(copy[i], in[i - start] &
+                                 unialgo::utils::lower_bits_set[word_size]);
+        else
+          ASSERT_EQ(copy[i], wv[i]);
+      }
+      if (word_size <= 32) {
+        std::vector<uint32_t> in32(in.begin(), in.end());
+        copy.encode(start, in32.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+          ASSERT_EQ(copy[start + i],
+                    in32[i] & unialgo::utils::lower_bits_set[word_size]);
+      }
+    }
+  }
+}
+
+// ============ Testing sort ============
+
+// Testing the iterators satisfy random access algorithms through proxies
+TEST(TestingWordVector, RandomAccessIterators) {
+  unialgo::utils::WordVector wv(200, 9);
+  std::mt19937 gen(12);
+  for (std::size_t i = 0; i < wv.size(); ++i) wv[i] = gen() % 512;
+  std::vector<std::size_t> expected(wv.cbegin(), wv.cend());
+
+  auto it = wv.begin();
+  EXPECT_EQ(it[17], expected[17]);
+  EXPECT_EQ((it + 5).index(), 5);
+  EXPECT_EQ(it.container(), &wv);
+  unialgo::utils::WordVector::Iterator def;
+  def = it + 3;
+  EXPECT_EQ(*def, expected[3]);
+
+  std::sort(wv.begin(), wv.end());
+  std::sort(expected.begin(), expected.end());
+  for (std::size_t i = 0; i < wv.size(); ++i) EXPECT_EQ(wv[i], expected[i]);
+}
+
+// Testing sort_words (radix and comparison) against std::sort
+TEST(TestingWordVector, SortWords) {
+  for (uint8_t word_size : {3, 12, 31, 33, 64}) {
+    for (std::size_t size : {0, 1, 100, 5000}) {
+      std::mt19937 gen(word_size + size);
+      unialgo::utils::WordVector wv(size, word_size);
+      for (std::size_t i = 0; i < size; ++i)
+        wv[i] = ((static_cast<uint64_t>(gen()) << 32) | gen()) &
+                unialgo::utils::lower_bits_set[word_size];
+      std::vector<uint64_t> expected(size);
+      for (std::size_t i = 0; i < size; ++i) expected[i] = wv[i];
+
+      unialgo::utils::WordVector by_value = wv;
+      unialgo::utils::sort_words(by_value);
+      std::sort(expected.begin(), expected.end());
+      for (std::size_t i = 0; i < size; ++i)
+        ASSERT_EQ(by_value[i], expected[i]);
+
+      unialgo::utils::sort_words(wv, std::greater<uint64_t>());
+      std::reverse(expected.begin(), expected.end());
+      for (std::size_t i = 0; i < size; ++i) ASSERT_EQ(wv[i], expected[i]);
+    }
+  }
+
+  // sorting a sub range leaves the rest untouched
+  unialgo::utils::WordVector wv(10, 4);
+  for (std::size_t i = 0; i < wv.size(); ++i) wv[i] = 10 - i;
+  unialgo::utils::sort_words(wv.begin() + 2, wv.begin() + 6);
+  std::vector<std::size_t> values(wv.cbegin(), wv.cend());
+  EXPECT_EQ(values, std::vector<std::size_t>({10, 9, 5, 6, 7, 8, 4, 3, 2, 1}));
+}
+
+TEST(TestingWordVector, RadixSortWithValues) {
+  const std::size_t size = 100000;
+  for (uint8_t word_size : {5, 20, 64}) {
+    for (std::size_t threads : {1, 4}) {
+      std::mt19937 gen(word_size + threads);
+      unialgo::utils::WordVector keys(size, word_size);
+      unialgo::utils::WordVector values(size, 17);
+      std::vector<std::pair<uint64_t, uint64_t>> expected(size);
+      for (std::size_t i = 0; i < size; ++i) {
+        keys[i] = ((static_cast<uint64_t>(gen()) << 32) | gen()) &
+                  unialgo::utils::lower_bits_set[word_size];
+        values[i] = i;
+        expected[i] = {keys[i], i};
+      }
+      unialgo::utils::WordVector only_keys = keys;
+
+      unialgo::utils::radix_sort_words(keys, values, threads);
+      std::stable_sort(
+          expected.begin(), expected.end(),
+          [](const auto& a, const auto& b) { return a.first < b.first; });
+      for (std::size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(keys[i], expected[i].first);
+        ASSERT_EQ(values[i], expected[i].second);  // stable
+      }
+
+      unialgo::utils::radix_sort_words(only_keys, threads);
+      for (std::size_t i = 0; i < size; ++i)
+        ASSERT_EQ(only_keys[i], expected[i].first);
+    }
+  }
+
+  // a sorter is reused between calls of different sizes
+  unialgo::utils::RadixSorter<uint32_t> sorter(2);
+  for (std::size_t size : {50000, 10, 0, 70000}) {
+    std::mt19937 gen(size);
+    std::vector<uint32_t> data(size);
+    for (auto& value : data) value = gen() & 0xffffff;
+    std::vector<uint32_t> expected = data;
+    std::sort(expected.begin(), expected.end());
+    sorter.sort(data.data(), size, 24);
+    EXPECT_EQ(data, expected);
+  }
+}
+
+template <typename Compressed>
+void checkCompressed(std::size_t size, double density) {
+  std::mt19937 gen(size);
+  std::bernoulli_distribution bit(density);
+  unialgo::utils::Bitvector bv(size);
+  for (std::size_t i = 0; i < size; ++i) bv[i] = bit(gen);
+  std::vector<std::size_t> ones, zeros;
+  for (std::size_t i = 0; i < size; ++i)
+    (bv.GetBit(i) ? ones : zeros).push_back(i);
+
+  Compressed compressed(bv);
+  ASSERT_EQ(compressed.size(), size);
+  ASSERT_EQ(compressed.GetTotal(true), ones.size());
+  ASSERT_EQ(compressed.GetTotal(false), zeros.size());
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    count += bv.GetBit(i);
+    ASSERT_EQ(compressed.GetBit(i), bv.GetBit(i));
+    ASSERT_EQ(compressed.rank(i), count);
+    ASSERT_EQ(compressed.rank(i, false), i + 1 - count);
+  }
+  for (std::size_t i = 0; i < ones.size(); ++i)
+    ASSERT_EQ(compressed.select(i + 1, true), ones[i]);
+  for (std::size_t i = 0; i < zeros.size(); ++i)
+    ASSERT_EQ(compressed.select(i + 1, false), zeros[i]);
+  EXPECT_EQ(compressed.select(ones.size() + 1, true), std::size_t(-1));
+  EXPECT_EQ(compressed.select(0, false), std::size_t(-1));
+}
+
+TEST(TestCompressed, RRRAndEliasFano) {
+  for (std::size_t size : {1, 63, 64, 1000, 20000}) {
+    for (double density : {0.0, 0.01, 0.5, 0.99, 1.0}) {
+      checkCompressed<unialgo::utils::RRRBitvector>(size, density);
+      checkCompressed<unialgo::utils::EliasFanoBitvector>(size, density);
+      checkCompressed<unialgo::utils::HybridBitvector>(size, density);
+    }
+  }
+
+  // sparse bitvectors take less than a bit per bit
+  const std::size_t size = 1 << 16;
+  std::mt19937 gen(7);
+  unialgo::utils::Bitvector sparse(size);
+  for (std::size_t i = 0; i < size / 100; ++i) sparse[gen() % size] = 1;
+  unialgo::utils::RRRBitvector rrr(sparse);
+  unialgo::utils::EliasFanoBitvector elias_fano(sparse);
+  EXPECT_LT(rrr.GetSizeInBits(), size / 2);
+  EXPECT_LT(elias_fano.GetSizeInBits(), size / 2);
+
+  // dense bitvectors too for RRR
+  unialgo::utils::Bitvector dense(size);
+  for (std::size_t i = 0; i < size; ++i) dense[i] = 1;
+  for (std::size_t i = 0; i < size / 100; ++i) dense[gen() % size] = 0;
+  EXPECT_LT(unialgo::utils::RRRBitvector(dense).GetSizeInBits(), size / 2);
+}
+
+// Testing HybridBitvector keeps the smallest encoding
+TEST(TestCompressed, Hybrid) {
+  using Encoding = unialgo::utils::HybridBitvector::Encoding;
+  const std::size_t size = 1 << 16;
+  std::mt19937 gen(13);
+  for (double density : {0.001, 0.05, 0.5}) {
+    std::bernoulli_distribution bit(density);
+    unialgo::utils::Bitvector bv(size);
+    for (std::size_t i = 0; i < size; ++i) bv[i] = bit(gen);
+
+    std::size_t sizes[] = {
+        unialgo::utils::InterleavedRankHelper(bv).GetSizeInBits(),
+        unialgo::utils::RRRBitvector(bv).GetSizeInBits(),
+        unialgo::utils::EliasFanoBitvector(bv).GetSizeInBits()};
+    unialgo::utils::HybridBitvector hybrid(bv);
+    EXPECT_EQ(hybrid.GetSizeInBits(), *std::min_element(sizes, sizes + 3));
+    EXPECT_EQ(hybrid.GetSizeInBits(),
+              sizes[static_cast<std::size_t>(hybrid.encoding())]);
+  }
+
+  // very sparse bits are Elias-Fano, a copy keeps the encoding
+  unialgo::utils::Bitvector sparse(size);
+  for (std::size_t i = 0; i < size; i += 1000) sparse.SetBit(i);
+  unialgo::utils::HybridBitvector hybrid(sparse);
+  EXPECT_EQ(hybrid.encoding(), Encoding::kEliasFano);
+  unialgo::utils::HybridBitvector copy = hybrid;
+  EXPECT_EQ(copy.encoding(), Encoding::kEliasFano);
+  EXPECT_EQ(copy.select(3, true), 2000);
+  EXPECT_EQ(copy.rank(2000), 3);
+}
+
+TEST(TestHash, BitsAndWords) {
+  // same scalar and AVX2 paths: long vectors hash the same as their copies
+  for (std::size_t size : {0, 1, 64, 200, 2048, 2048 + 64 * 37 + 5}) {
+    std::mt19937 gen(size);
+    unialgo::utils::Bitvector bv(size);
+    for (std::size_t i = 0; i < size; ++i) bv[i] = gen() & 1;
+    unialgo::utils::Bitvector copy = bv;
+    EXPECT_EQ(std::hash<unialgo::utils::Bitvector>{}(bv),
+              std::hash<unialgo::utils::Bitvector>{}(copy));
+    // every single bit flip changes the hash
+    for (std::size_t i = 0; i < size; i += 7) {
+      copy[i] = !copy.GetBit(i);
+      EXPECT_NE(std::hash<unialgo::utils::Bitvector>{}(bv),
+                std::hash<unialgo::utils::Bitvector>{}(copy));
+      copy[i] = !copy.GetBit(i);
+    }
+  }
+
+  // high bits of the words are hashed too
+  std::vector<uint64_t> words(40, 0);
+  uint64_t hash = unialgo::utils::hash_words(words.data(), words.size());
+  for (std::size_t i = 0; i < words.size(); ++i) {
+    words[i] = 1ULL << 63;
+    EXPECT_NE(unialgo::utils::hash_words(words.data(), words.size()), hash);
+    words[i] = 0;
+  }
+
+  // words are hashed with their position: moving or swapping them changes
+  // the hash, both in the blocks and in the stripes after them
+  for (std::size_t size : {8, 40, 64 + 8}) {
+    unialgo::utils::Bitvector first(size * 64);
+    unialgo::utils::Bitvector moved(size * 64);
+    first[0] = true;
+    moved[256] = true;
+    EXPECT_NE(std::hash<unialgo::utils::Bitvector>{}(first),
+              std::hash<unialgo::utils::Bitvector>{}(moved));
+  }
+  for (std::size_t size : {8, 40, 72}) {
+    std::vector<uint64_t> order(size);
+    for (std::size_t i = 0; i < size; ++i) order[i] = i + 1;
+    hash = unialgo::utils::hash_words(order.data(), order.size());
+    for (std::size_t i = 4; i < size; i += 4) {
+      std::swap(order[0], order[i]);
+      EXPECT_NE(unialgo::utils::hash_words(order.data(), order.size()), hash);
+      std::swap(order[0], order[i]);
+      std::swap(order[i - 4], order[i]);
+      EXPECT_NE(unialgo::utils::hash_words(order.data(), order.size()), hash);
+      std::swap(order[i - 4], order[i]);
+    }
+  }
+
+  // WordVector: same values same hash, word size is part of the hash
+  unialgo::utils::WordVector wv(100, 5);
+  for (std::size_t i = 0; i < wv.size(); ++i) wv[i] = i % 32;
+  unialgo::utils::WordVector same(100, 5);
+  for (std::size_t i = 0; i < same.size(); ++i) same[i] = i % 32;
+  EXPECT_EQ(wv, same);
+  EXPECT_EQ(std::hash<unialgo::utils::WordVector>{}(wv),
+            std::hash<unialgo::utils::WordVector>{}(same));
+  same[99] = 0;
+  EXPECT_NE(wv, same);
+  EXPECT_NE(std::hash<unialgo::utils::WordVector>{}(wv),
+            std::hash<unialgo::utils::WordVector>{}(same));
+  EXPECT_NE(std::hash<unialgo::utils::WordVector>{}(
+                unialgo::utils::WordVector(10, 4)),
+            std::hash<unialgo::utils::WordVector>{}(
+                unialgo::utils::WordVector(8, 5)));
+
+  // usable as unordered_set keys
+  std::unordered_set<unialgo::utils::WordVector> seen;
+  seen.insert(wv);
+  EXPECT_EQ(seen.count(wv), 1);
+  EXPECT_EQ(seen.count(same), 0);
+}
+
+TEST(TestConcurrentBitvector, ParallelWritesAndFreeze) {
+  const std::size_t size = 100000;
+  const std::size_t num_threads = 4;
+  unialgo::utils::ConcurrentBitvector marks(size);
+  std::vector<std::size_t> won(num_threads, 0);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&marks, &won, t]() {
+      // interleaved bits: every word is written by every thread
+      for (std::size_t i = t; i < size; i += num_threads)
+        if (i % 3 == 0) marks.SetBit(i);
+      // every thread tries every multiple of 5, a single one wins it
+      for (std::size_t i = 0; i < size; i += 5) won[t] += !marks.TestAndSet(i);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  std::size_t total_won = 0;
+  for (std::size_t w : won) total_won += w;
+  std::size_t expected = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    bool bit = i % 3 == 0 || i % 5 == 0;
+    ASSERT_EQ(marks.GetBit(i), bit);
+    expected += bit;
+  }
+  // multiples of 15 may have been set by SetBit first
+  EXPECT_LE(total_won, size / 5);
+  EXPECT_GE(total_won, size / 5 - size / 15 - 1);
+
+  std::vector<std::thread> clearers;
+  for (std::size_t t = 0; t < num_threads; ++t) {
+    clearers.emplace_back([&marks, t]() {
+      for (std::size_t i = t; i < size; i += num_threads)
+        if (i % 2 == 1) marks.ClearBit(i);
+    });
+  }
+  for (auto& thread : clearers) thread.join();
+  for (std::size_t i = 1; i < size; i += 2)
+    if (i % 3 == 0 || i % 5 == 0) --expected;
+
+  unialgo::utils::Bitvector bv = std::move(marks).freeze();
+  EXPECT_EQ(marks.size(), 0);
+  ASSERT_EQ(bv.size(), size);
+  EXPECT_EQ(bv.count(), expected);
+  unialgo::utils::RankHelper rank(
+      std::make_shared<unialgo::utils::Bitvector>(std::move(bv)));
+  EXPECT_EQ(rank.rank(size - 1), expected);
+  EXPECT_EQ(rank.select(1, true), 0);
+  EXPECT_EQ(rank.select(2, true), 6);  // 0, 6, 10, 12, ...
+
+  // thawing a bitvector keeps its bits
+  unialgo::utils::Bitvector small(70);
+  small[3] = 1;
+  small[69] = 1;
+  unialgo::utils::ConcurrentBitvector thawed(small);
+  EXPECT_TRUE(thawed.TestAndClear(69));
+  EXPECT_FALSE(thawed.TestAndClear(69));
+  thawed.OrWord(0, 0b11);
+  unialgo::utils::Bitvector refrozen = std::move(thawed).freeze();
+  EXPECT_EQ(refrozen.count(), 3);
+  EXPECT_TRUE(refrozen.GetBit(0) && refrozen.GetBit(1) && refrozen.GetBit(3));
+}
+
+// counts the allocations going to the default resource
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+
+TEST(TestArena, ContainersOnArena) {
+  CountingResource upstream;
+  {
+    unialgo::utils::Arena arena(1 << 16, &upstream);
+    EXPECT_EQ(upstream.allocations, 1);
+
+    auto bv = std::make_shared<unialgo::utils::Bitvector>(10000, &arena);
+    for (std::size_t i = 0; i < bv->size(); i += 3) bv->SetBit(i);
+    EXPECT_EQ(bv->getResource(), &arena);
+    unialgo::utils::RankHelper rank(bv, 1, &arena);
+    EXPECT_EQ(rank.rank(9999), 3334);
+    EXPECT_EQ(rank.select(10, true), 27);
+
+    unialgo::utils::WordVectorBuilder builder(7, &arena);
+    for (std::size_t i = 0; i < 1000; ++i) builder.push_back(i % 128);
+    unialgo::utils::WordVector wv = builder.build();
+    EXPECT_EQ(wv.getResource(), &arena);
+    EXPECT_EQ(wv[999], 999 % 128);
+
+    // moves keep the arena, copies go to the default resource
+    unialgo::utils::WordVector moved;
+    moved = std::move(wv);
+    EXPECT_EQ(moved.getResource(), &arena);
+    unialgo::utils::WordVector copy = moved;
+    EXPECT_EQ(copy.getResource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copy, moved);
+
+    // everything fit in the reserved chunk
+    EXPECT_EQ(upstream.allocations, 1);
+    EXPECT_EQ(arena.numChunks(), 1);
+    EXPECT_GT(arena.used(), 10000 / 8);
+    EXPECT_EQ(upstream.deallocations, 0);
+  }
+  // a single free at teardown
+  EXPECT_EQ(upstream.deallocations, 1);
+
+  // arena grows with new chunks when not reserved
+  unialgo::utils::Arena arena(0, &upstream);
+  std::vector<unialgo::utils::Bitvector> many;
+  for (std::size_t i = 0; i < 100; ++i) many.emplace_back(10000, &arena);
+  EXPECT_GT(arena.numChunks(), 1);
+  EXPECT_LT(arena.numChunks(), 10);
+  EXPECT_GE(arena.capacity(), arena.used());
+  many.clear();
+  arena.release();
+  EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+// ============ Testing DynamicBitvector ============
+
+// checks every query of bv against the bits in expected
+void checkDynamic(const unialgo::utils::DynamicBitvector& bv,
+                  const std::vector<char>& expected) {
+  ASSERT_EQ(bv.size(), expected.size());
+  std::size_t ones = 0;
+  std::size_t zeros = 0;
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(bv[i], static_cast<bool>(expected[i]));
+    expected[i] ? ++ones : ++zeros;
+    EXPECT_EQ(bv.rank(i), ones);
+    EXPECT_EQ(bv.rank(i, false), zeros);
+    if (expected[i])
+      EXPECT_EQ(bv.select(ones), i);
+    else
+      EXPECT_EQ(bv.select(zeros, false), i);
+  }
+  EXPECT_EQ(bv.countOnes(), ones);
+  EXPECT_EQ(bv.select(ones + 1), static_cast<std::size_t>(-1));
+}
+
+TEST(TestDynamicBitvector, InsertEraseSet) {
+  std::mt19937 gen(24);
+  unialgo::utils::DynamicBitvector bv;
+  std::vector<char> expected;
+  EXPECT_EQ(bv.size(), 0);
+  EXPECT_EQ(bv.height(), 1);
+
+  // grows over many leaves and a few levels
+  for (std::size_t i = 0; i < 60000; ++i) {
+    std::size_t pos = gen() % (expected.size() + 1);
+    bool bit = gen() % 3 == 0;
+    bv.insert(pos, bit);
+    expected.insert(expected.begin() + pos, bit);
+  }
+  EXPECT_GE(bv.height(), 3);
+  checkDynamic(bv, expected);
+
+  // updates and erases down to a single leaf (merging nodes on the way)
+  for (std::size_t i = 0; i < 5000; ++i) {
+    std::size_t pos = gen() % expected.size();
+    bool bit = gen() % 2;
+    bv.set(pos, bit);
+    expected[pos] = bit;
+  }
+  while (expected.size() > 500) {
+    std::size_t pos = gen() % expected.size();
+    EXPECT_EQ(bv.erase(pos), static_cast<bool>(expected[pos]));
+    expected.erase(expected.begin() + pos);
+  }
+  EXPECT_EQ(bv.height(), 1);
+  checkDynamic(bv, expected);
+
+  // copies are deep
+  unialgo::utils::DynamicBitvector copy(bv);
+  bv.push_back(true);
+  bv.erase(0);
+  checkDynamic(copy, expected);
+}
+
+TEST(TestDynamicBitvector, FromBitvector) {
+  std::mt19937 gen(25);
+  unialgo::utils::Bitvector bits(100000);
+  std::vector<char> expected(bits.size());
+  for (std::size_t i = 0; i < bits.size(); ++i) {
+    if (gen() % 5 == 0) {
+      bits.SetBit(i);
+      expected[i] = true;
+    }
+  }
+  unialgo::utils::DynamicBitvector bv(bits);
+  checkDynamic(bv, expected);
+  for (std::size_t i = 0; i < 2000; ++i) {
+    std::size_t pos = gen() % expected.size();
+    if (i % 2) {
+      bv.insert(pos, true);
+      expected.insert(expected.begin() + pos, true);
+    } else {
+      bv.erase(pos);
+      expected.erase(expected.begin() + pos);
+    }
+  }
+  checkDynamic(bv, expected);
+  EXPECT_EQ(unialgo::utils::DynamicBitvector(unialgo::utils::Bitvector())
+                .size(),
+            0);
+}
+
+}  // namespace
@@ -0,0 +1,152 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_WORDBUFFER_
+#define UNIALGO_UTILS_BITVECTOR_WORDBUFFER_
+
+#include <stdint.h>  // uint64_t
+
+#include <algorithm>        // std::equal
+#include <memory>           // std::shared_ptr, std::construct_at
+#include <memory_resource>  // std::pmr::memory_resource
+#include <utility>          // std::move
+#include <vector>           // std::pmr::vector
+
+/**
+ * @file This file contains the word storage used by Bitvector and WordVector
+ *
+ * A WordBuffer either owns its words or views words owned by someone else
+ * (e.g. a memory-mapped file), the owner is kept alive by a shared_ptr.
+ * Owned words come from a std::pmr::memory_resource (the default resource
+ * unless one is given, see arena.hpp), moves carry the resource along and
+ * copies allocate from the default resource.
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+class WordBuffer {
+ public:
+  using Type = uint64_t;                  // type of a word
+  using Storage = std::pmr::vector<Type>;  // owned words
+
+  /**
+   * @brief Construct an empty buffer
+   */
+  WordBuffer() : data_(nullptr), size_(0) {}
+
+  /**
+   * @brief Construct an owning buffer of num_words words set to 0
+   *
+   * @param num_words # of words
+   * @param resource memory resource the words are allocated from
+   */
+  explicit WordBuffer(
+      std::size_t num_words,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : owned_(num_words, 0, resource),
+        data_(owned_.data()),
+        size_(num_words) {}
+
+  /**
+   * @brief Construct an owning buffer taking the words of a vector
+   *
+   * @param words words to own (moved with their resource, no copy)
+   */
+  explicit WordBuffer(Storage&& words)
+      : owned_(std::move(words)), data_(owned_.data()), size_(owned_.size()) {}
+
+  /**
+   * @brief Construct a buffer viewing words owned by owner
+   *
+   * Writes go to the viewed words: owner must hand out memory that can be
+   * written (e.g. a MAP_PRIVATE mapping)
+   *
+   * @param data first word viewed
+   * @param num_words # of words viewed
+   * @param owner keeps data alive while the buffer (or a move of it) exists
+   */
+  WordBuffer(Type* data, std::size_t num_words, std::shared_ptr<void> owner)
+      : data_(data), size_(num_words), owner_(std::move(owner)) {}
+
+  ~WordBuffer() = default;
+
+  /**
+   * @brief Copies are always owning (a view is copied to memory)
+   */
+  WordBuffer(const WordBuffer& other)
+      : owned_(other.begin(), other.end()),
+        data_(owned_.data()),
+        size_(other.size_) {}
+
+  WordBuffer(WordBuffer&& other) noexcept
+      : owned_(std::move(other.owned_)),
+        data_(other.data_),
+        size_(other.size_),
+        owner_(std::move(other.owner_)) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  WordBuffer& operator=(const WordBuffer& other) {
+    if (this != &other) *this = WordBuffer(other);
+    return *this;
+  }
+
+  WordBuffer& operator=(WordBuffer&& other) noexcept {
+    if (this != &other) {
+      // pmr vectors keep their resource on assignment: rebuild owned_ to
+      // take other's words and resource instead of copying them
+      std::destroy_at(&owned_);
+      std::construct_at(&owned_, std::move(other.owned_));
+      data_ = other.data_;
+      size_ = other.size_;
+      owner_ = std::move(other.owner_);
+      other.data_ = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  Type& operator[](std::size_t pos) { return data_[pos]; }
+  const Type& operator[](std::size_t pos) const { return data_[pos]; }
+
+  Type* data() { return data_; }
+  const Type* data() const { return data_; }
+
+  Type& back() { return data_[size_ - 1]; }
+  const Type& back() const { return data_[size_ - 1]; }
+
+  Type* begin() { return data_; }
+  Type* end() { return data_ + size_; }
+  const Type* begin() const { return data_; }
+  const Type* end() const { return data_ + size_; }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * @brief true if the words are viewed and not owned
+   */
+  bool isView() const { return owner_ != nullptr; }
+
+  /**
+   * @brief Memory resource of the owned words
+   */
+  std::pmr::memory_resource* resource() const {
+    return owned_.get_allocator().resource();
+  }
+
+  friend bool operator==(const WordBuffer& a, const WordBuffer& b) {
+    return a.size_ == b.size_ && std::equal(a.begin(), a.end(), b.begin());
+  }
+
+ private:
+  Storage owned_;                // words when the buffer owns them
+  Type* data_;                   // first word (owned_ or viewed memory)
+  std::size_t size_;             // # of words
+  std::shared_ptr<void> owner_;  // keeps viewed memory alive
+};
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_WORDBUFFER_
@@ -1,15 +1,94 @@
 #include "unialgo/utils/bitvector/wordVector.hpp"
 
+#include <algorithm>  // std::fill, std::equal
+
+#if defined(__BMI2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "unialgo/utils/bitvector/serialize.hpp"
+
 namespace unialgo {
 namespace utils {
+
+namespace {
+
+#if defined(__BMI2__)
+/**
+ * @brief Stores the 64 / L lanes of L bits of spread to out
+ */
+template <unsigned L, typename T>
+inline void store_lanes(uint64_t spread, T* out) {
+#if defined(__AVX2__)
+  if constexpr (L == 8 && sizeof(T) == 4) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                        _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(spread)));
+    return;
+  }
+  if constexpr (L == 8 && sizeof(T) == 8) {
+    __m128i lanes = _mm_cvtsi64_si128(spread);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                        _mm256_cvtepu8_epi64(lanes));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4),
+                        _mm256_cvtepu8_epi64(_mm_srli_si128(lanes, 4)));
+    return;
+  }
+  if constexpr (L == 16 && sizeof(T) == 4) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_cvtepu16_epi32(_mm_cvtsi64_si128(spread)));
+    return;
+  }
+  if constexpr (L == 16 && sizeof(T) == 8) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                        _mm256_cvtepu16_epi64(_mm_cvtsi64_si128(spread)));
+    return;
+  }
+#endif
+  for (unsigned k = 0; k < 64 / L; ++k)
+    out[k] = (spread >> (k * L)) & lower_bits_set[L];
+}
+
+/**
+ * @brief Unpacks groups of 64 / L words of word_size <= L bits with a pdep
+ * per group
+ *
+ * @return std::size_t # of words unpacked (multiple of 64 / L)
+ */
+template <unsigned L, typename T>
+std::size_t decode_pdep(const uint64_t* words, std::size_t bit,
+                        std::size_t count, uint8_t word_size, T* out) {
+  const unsigned group = 64 / L;
+  const uint8_t group_bits = group * word_size;
+  uint64_t lane_mask = 0;  // word_size low bits of every lane
+  for (unsigned k = 0; k < group; ++k)
+    lane_mask |= lower_bits_set[word_size] << (k * L);
+
+  std::size_t i = 0;
+  for (; i + group <= count; i += group, bit += group_bits) {
+    uint64_t chunk = read_bits(words + bit / 64, bit % 64, group_bits);
+    store_lanes<L>(_pdep_u64(chunk, lane_mask), out + i);
+  }
+  return i;
+}
+#endif
+
+}  // namespace
 // ============ Implementation WordVector ============
 
 WordVector::WordVector() : num_words_(0), word_size_(2), bits_(0) {}
 
-WordVector::WordVector(std::size_t num_words, uint8_t wordSize)
+WordVector::WordVector(std::size_t num_words, uint8_t wordSize,
+                       std::pmr::memory_resource* resource)
     : num_words_(num_words),
       word_size_(wordSize),
-      bits_((num_words * wordSize + type_size - 1) / type_size) {}
+      bits_((num_words * wordSize + type_size - 1) / type_size, resource) {}
+
+WordVector::WordVector(WordBuffer words, std::size_t num_words,
+                       uint8_t wordSize)
+    : bits_(std::move(words)), word_size_(wordSize), num_words_(num_words) {
+  assert(bits_.size() == (num_words * wordSize + type_size - 1) / type_size &&
+         "number of words not matching num_words * wordSize");
+}
 
 std::size_t WordVector::getNumBits() const { return num_words_ * word_size_; }
 
@@ -17,6 +96,45 @@ std::size_t WordVector::size() const { return num_words_; }
 
 uint8_t WordVector::getWordSize() const { return word_size_; }
 
+bool WordVector::operator==(const WordVector& other) const {
+  if (word_size_ != other.word_size_ || num_words_ != other.num_words_)
+    return false;
+  // bits past the last word are not compared
+  std::size_t num_bits = getNumBits();
+  std::size_t full = num_bits / type_size;
+  if (!std::equal(bits_.data(), bits_.data() + full, other.bits_.data()))
+    return false;
+  if (num_bits % type_size == 0) return true;
+  Type mask = lower_bits_set[num_bits % type_size];
+  return (bits_[full] & mask) == (other.bits_[full] & mask);
+}
+
+bool WordVector::operator!=(const WordVector& other) const {
+  return !(*this == other);
+}
+
+void WordVector::write(SerialWriter& out) const {
+  out.header(serial::Tag::kWordVector);
+  out.value(num_words_);
+  out.value(word_size_);
+  out.words(bits_.data(), bits_.size());
+}
+
+WordVector WordVector::read(SerialReader& in) {
+  in.header(serial::Tag::kWordVector);
+  WordVector wv;
+  wv.num_words_ = in.value();
+  uint64_t word_size = in.value();
+  if (word_size > type_size)
+    throw std::runtime_error("unialgo: corrupted serialized WordVector");
+  wv.word_size_ = word_size;
+  wv.bits_ = in.words();
+  if (wv.bits_.size() !=
+      (wv.num_words_ * wv.word_size_ + type_size - 1) / type_size)
+    throw std::runtime_error("unialgo: corrupted serialized WordVector");
+  return wv;
+}
+
 WordVector::Reference WordVector::operator[](std::size_t pos) {
   return WordVectorRef(&bits_[(pos * word_size_) / type_size],
                        ((pos * word_size_) % type_size), word_size_);
@@ -37,6 +155,59 @@ WordVector::ConstReference WordVector::at(std::size_t pos) const {
   return this->operator[](pos);
 }
 
+template <typename T>
+void WordVector::decode(std::size_t start, std::size_t count, T* out) const {
+  assert((sizeof(T) == 8 || word_size_ <= 32) && "words do not fit in T");
+  assert(start + count <= num_words_ && "Wordvector decode out of bounds");
+  if (word_size_ == 0) return std::fill(out, out + count, 0);
+
+  const Type* words = bits_.data();
+  std::size_t bit = start * word_size_;
+  std::size_t i = 0;
+#if defined(__BMI2__)
+  if (word_size_ <= 8)
+    i = decode_pdep<8>(words, bit, count, word_size_, out);
+  else if (word_size_ <= 16)
+    i = decode_pdep<16>(words, bit, count, word_size_, out);
+  else if (word_size_ <= 32)
+    i = decode_pdep<32>(words, bit, count, word_size_, out);
+  bit += i * word_size_;
+#endif
+  for (; i < count; ++i, bit += word_size_)
+    out[i] = read_bits(words + bit / type_size, bit % type_size, word_size_);
+}
+
+template <typename T>
+void WordVector::encode(std::size_t start, const T* in, std::size_t count) {
+  assert(start + count <= num_words_ && "Wordvector encode out of bounds");
+  if (word_size_ == 0 || count == 0) return;
+
+  Type* words = bits_.data();
+  std::size_t bit = start * word_size_;
+  std::size_t w = bit / type_size;
+  std::size_t used = bit % type_size;           // bits filled in acc
+  Type acc = words[w] & lower_bits_set[used];  // keeps words before start
+  const Type mask = lower_bits_set[word_size_];
+  for (std::size_t i = 0; i < count; ++i) {
+    Type value = in[i] & mask;
+    acc |= value << used;
+    used += word_size_;
+    if (used >= type_size) {
+      words[w++] = acc;
+      used -= type_size;
+      // bits of value that did not fit in the stored word
+      acc = used ? value >> (word_size_ - used) : 0;
+    }
+  }
+  // keeps words after start + count
+  if (used) words[w] = (words[w] & ~lower_bits_set[used]) | acc;
+}
+
+template void WordVector::decode(std::size_t, std::size_t, uint32_t*) const;
+template void WordVector::decode(std::size_t, std::size_t, uint64_t*) const;
+template void WordVector::encode(std::size_t, const uint32_t*, std::size_t);
+template void WordVector::encode(std::size_t, const uint64_t*, std::size_t);
+
 std::ostream& operator<<(std::ostream& os, const WordVector& wv) {
   for (std::size_t i = wv.size() - 1; i > 0; --i) os << wv[i];
   os << wv[0];
@@ -7,12 +7,14 @@
 #include <cmath>       // std::ceil, std::floor
 #include <functional>  // std::hash
 #include <iostream>
-#include <ostream>      // ostream
-#include <type_traits>  // std::enable_if, std::is_arithmetic
-#include <utility>      // std::swap
+#include <memory_resource>  // std::pmr::memory_resource
+#include <ostream>          // ostream
+#include <type_traits>      // std::enable_if, std::is_arithmetic
+#include <utility>          // std::swap
 #include <vector>
 
 #include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/wordBuffer.hpp"
 
 // TODO: review all members of WordVectorRef (possibly templated members are not
 // needed)
@@ -25,6 +27,8 @@ namespace utils {
 // forward decleration
 template <typename Reference_type>
 class WordVectorRef;
+class SerialWriter;
+class SerialReader;
 
 // defined at end of file:
 // using WordVectorReference = WordVector::Reference;
@@ -52,8 +56,11 @@ class WordVector {
    *
    * @param num_words num words to store in vector
    * @param wordSize size of a word (default = 2)
+   * @param resource memory resource the words are allocated from
    */
-  WordVector(std::size_t num_words, uint8_t wordSize = 2);
+  WordVector(
+      std::size_t num_words, uint8_t wordSize = 2,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
   /**
    * @brief Construct a new Word Vector object
@@ -62,6 +69,17 @@ class WordVector {
    */
   WordVector();
 
+  /**
+   * @brief Construct a new Word Vector object on already packed words
+   *
+   * Important: words must have ceil(num_words * wordSize / 64) words
+   *
+   * @param words words containing the values
+   * @param num_words num words stored in words
+   * @param wordSize size of a word
+   */
+  WordVector(WordBuffer words, std::size_t num_words, uint8_t wordSize);
+
   /**
    * @brief copy
    *
@@ -72,6 +90,25 @@ class WordVector {
         word_size_(other.word_size_),
         bits_(other.bits_) {}
 
+  WordVector(WordVector&& other) noexcept
+      : bits_(std::move(other.bits_)),
+        word_size_(other.word_size_),
+        num_words_(other.num_words_) {
+    other.num_words_ = 0;
+  }
+
+  WordVector& operator=(const WordVector& other) = default;
+
+  WordVector& operator=(WordVector&& other) noexcept {
+    if (this != &other) {
+      bits_ = std::move(other.bits_);
+      word_size_ = other.word_size_;
+      num_words_ = other.num_words_;
+      other.num_words_ = 0;
+    }
+    return *this;
+  }
+
   /**
    * @brief Accessing word in WordVector
    *
@@ -135,6 +172,89 @@ class WordVector {
    */
   uint8_t getWordSize() const;
 
+  /**
+   * @brief Unpack words [start, start + count) to out
+   *
+   * Unpacks a 64-bit chunk at a time (pdep + widening stores when BMI2 /
+   * AVX2 are available) instead of a read_bits per word
+   *
+   * @tparam T uint32_t or uint64_t (uint32_t needs word size <= 32)
+   * @param start position of first word
+   * @param count number of words to unpack
+   * @param out destination of count values
+   */
+  template <typename T>
+  void decode(std::size_t start, std::size_t count, T* out) const;
+
+  /**
+   * @brief Pack count values of in to words [start, start + count)
+   *
+   * Values are accumulated in a register and whole 64-bit words are stored,
+   * only the first and last word are read back. Bits past the word size of
+   * the values are ignored
+   *
+   * @tparam T uint32_t or uint64_t
+   * @param start position of first word
+   * @param in values to pack
+   * @param count number of values
+   */
+  template <typename T>
+  void encode(std::size_t start, const T* in, std::size_t count);
+
+  /**
+   * @brief Direct access to underlying word array
+   *
+   * @return const Type* pointer to first word
+   */
+  const Type* data() const { return bits_.data(); }
+
+  /**
+   * @brief Starts loading in cache the word holding the indx-th value (a
+   * hint, the value is not read)
+   */
+  void prefetch(std::size_t indx) const {
+    __builtin_prefetch(bits_.data() + indx * word_size_ / type_size);
+  }
+
+  /**
+   * @brief Memory resource the words are allocated from
+   */
+  std::pmr::memory_resource* getResource() const { return bits_.resource(); }
+
+  /**
+   * @brief Compare wordVectors
+   *
+   * @param other wordVector to compare this with
+   * @return true vectors are the same (word size, size and values)
+   * @return false vectors are not the same
+   */
+  bool operator==(const WordVector& other) const;
+
+  /**
+   * @brief Compare wordVectors
+   *
+   * @param other wordVector to compare this with
+   * @return true vectors are not the same
+   * @return false vectors are the same (word size, size and values)
+   */
+  bool operator!=(const WordVector& other) const;
+
+  /**
+   * @brief Writes the vector in the binary format (see serialize.hpp)
+   *
+   * @param out writer to the destination
+   */
+  void write(SerialWriter& out) const;
+
+  /**
+   * @brief Reads a vector written by write, on a mapped file the words are
+   * viewed in place
+   *
+   * @param in reader on the source
+   * @return WordVector read
+   */
+  static WordVector read(SerialReader& in);
+
   /**
    * @brief Output to the steam bits inside wordvector from left to right
    * (101....) wv[size]wv[size-1]...wv[0]
@@ -155,9 +275,9 @@ class WordVector {
   ConstIterator cend() const;
 
  private:
-  std::vector<Type> bits_;  // vector of bits
-  uint8_t word_size_;       // size of a single word to store
-  std::size_t num_words_;   // number of words in bits_
+  WordBuffer bits_;        // words containing the packed values
+  uint8_t word_size_;      // size of a single word to store
+  std::size_t num_words_;  // number of words in bits_
 };
 
 template <typename Reference_type>
@@ -442,28 +562,53 @@ class WordVector::TempIterator {
   using pointer = Ref_iterator*;
   using reference = Ref_iterator&;
 
+  TempIterator() : bit_pos_(0), wv_(nullptr) {}
+
+  // the reference is bound when dereferencing: end() and iterators of empty
+  // vectors never touch the words
   TempIterator(std::size_t bit_pos, Wordvector_pointer bv)
-      : bit_pos_(bit_pos), wv_(bv), ref_to_((*bv)[bit_pos]) {}
+      : bit_pos_(bit_pos), wv_(bv) {}
+
+  TempIterator(const TempIterator& other) = default;
 
   TempIterator& operator=(const TempIterator& other) {
     bit_pos_ = other.bit_pos_;
     wv_ = other.wv_;
-    ref_to_.changeReference((*other.wv_)[other.bit_pos_]);
     return *this;
   }
 
   // check this may be optimized
-  void resetReference() { ref_to_.changeReference((*wv_)[bit_pos_]); }
+  void resetReference() const { ref_to_.changeReference((*wv_)[bit_pos_]); }
 
-  reference operator*() {
+  reference operator*() const {
     resetReference();
     return ref_to_;
   }
-  pointer operator->() {
+  pointer operator->() const {
     resetReference();
     return &ref_to_;
   }
 
+  /**
+   * @brief Reference to the word n positions after the iterator
+   *
+   * Returned by value: a proxy stays valid when the iterator moves
+   */
+  Ref_iterator operator[](difference_type n) const {
+    return (*wv_)[bit_pos_ + n];
+  }
+
+  /**
+   * @brief Position of the word pointed in the vector
+   */
+  std::size_t index() const { return bit_pos_; }
+
+  /**
+   * @brief Vector iterated, with index() gives bulk access to a range
+   * (WordVector::decode / encode)
+   */
+  Wordvector_pointer container() const { return wv_; }
+
   TempIterator& operator++() {
     bit_pos_++;
     return *this;
@@ -544,10 +689,9 @@ class WordVector::TempIterator {
   }
 
  private:
-  std::size_t bit_pos_;    // position of bit in bv
-  Wordvector_pointer wv_;  // pointer to wv for iterator
-                           // WordVector::Reference
-  Ref_iterator ref_to_;    // reference object of value pointer by iterator
+  std::size_t bit_pos_;          // position of bit in bv
+  Wordvector_pointer wv_;        // pointer to wv for iterator
+  mutable Ref_iterator ref_to_;  // reference object of value pointer by it
 };
 
 inline WordVector::Iterator WordVector::begin() {
@@ -587,15 +731,27 @@ using WordVectorConstReference = WordVector::ConstReference;
 namespace std {
 
 /**
- * @brief Hashing function for reference to wordVector
+ * @brief Hashing function for reference to wordVector (full width mix of the
+ * value, see utils::hash_word)
  */
 template <typename Reference_type>
 struct hash<unialgo::utils::WordVectorRef<Reference_type>> {
   // for Reference
   std::size_t operator()(
       const unialgo::utils::WordVectorRef<Reference_type>& ref) const {
-    return std::hash<unialgo::utils::WordVector::reference_type>()(
-        ref.getValue());
+    return unialgo::utils::hash_word(ref.getValue());
+  }
+};
+
+/**
+ * @brief Hashing function for wordVector, words are read in place (see
+ * utils::hash_bits)
+ */
+template <>
+struct hash<unialgo::utils::WordVector> {
+  std::size_t operator()(const unialgo::utils::WordVector& wv) const {
+    return unialgo::utils::hash_bits(wv.data(), wv.getNumBits(),
+                                     wv.getWordSize());
   }
 };
 
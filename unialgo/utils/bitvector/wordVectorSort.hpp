@@ -0,0 +1,341 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_WORDVECTORSORT_
+#define UNIALGO_UTILS_BITVECTOR_WORDVECTORSORT_
+
+#include <stdint.h>  // uint64_t, uint32_t
+
+#include <algorithm>    // std::sort, std::copy, std::copy_n
+#include <array>        // std::array
+#include <cassert>      // assert
+#include <thread>       // std::thread
+#include <type_traits>  // std::remove_pointer_t
+#include <utility>      // std::swap
+#include <vector>       // std::vector
+
+#include "unialgo/utils/bitvector/wordVector.hpp"
+
+/**
+ * @file This file contains sorting of packed words
+ *
+ * std::sort on WordVector iterators works but every comparison and swap goes
+ * through WordVectorRef proxies and read_bits / write_bits. sort_words
+ * unpacks the range once (WordVector::decode), sorts plain integers and packs
+ * them back (WordVector::encode):
+ *
+ *   utils::sort_words(wv);                      // radix sort on the values
+ *   utils::sort_words(wv.begin(), wv.end(), cmp);  // comparison sort
+ *
+ * RadixSorter is the stable, multi-threaded radix sort underneath, it can
+ * carry a satellite array (e.g. positions sorted by key):
+ *
+ *   utils::radix_sort_words(keys, positions, num_threads);
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+/**
+ * @brief Class RadixSorter
+ * stable LSD radix sort of integer keys, optionally moving a satellite array
+ * with the keys, 8 bits per pass
+ *
+ * Every pass counts digits with per-thread histograms, then every thread
+ * scatters its chunk through per-digit buffers of a cache line, so the
+ * destination is written a line at a time. Passes where every key has the
+ * same digit are skipped. Buffers are kept between passes and between calls.
+ *
+ * @tparam Key unsigned integer type of keys
+ * @tparam Value type of satellite values
+ */
+template <typename Key, typename Value = Key>
+class RadixSorter {
+ public:
+  static const std::size_t digit_bits = 8;            // bits sorted per pass
+  static const std::size_t radix = 1 << digit_bits;   // values of a digit
+  static const std::size_t min_per_thread = 1 << 14;  // keys for a thread
+  static const std::size_t line =
+      64 / sizeof(Key) ? 64 / sizeof(Key) : 1;  // keys in a scatter buffer
+
+  /**
+   * @brief Construct a new Radix Sorter object
+   *
+   * @param num_threads max number of threads used (less are used when there
+   * are less than min_per_thread keys per thread)
+   */
+  explicit RadixSorter(std::size_t num_threads = 1)
+      : num_threads_(std::max<std::size_t>(1, num_threads)) {}
+
+  /**
+   * @brief Sort n keys of key_bits bits (keys must be < 2^key_bits)
+   */
+  void sort(Key* keys, std::size_t n, uint8_t key_bits) {
+    run<false>(keys, nullptr, n, key_bits);
+  }
+
+  /**
+   * @brief Sort n keys of key_bits bits, values[i] follows keys[i]
+   */
+  void sort(Key* keys, Value* values, std::size_t n, uint8_t key_bits) {
+    run<true>(keys, values, n, key_bits);
+  }
+
+ private:
+  // per-thread scatter buffers, a line of keys (and values) per digit
+  struct Scratch {
+    std::vector<Key> keys = std::vector<Key>(radix * line);
+    std::vector<Value> values;
+    std::array<std::size_t, radix> fill;
+  };
+
+  template <bool with_values>
+  void run(Key* keys, Value* values, std::size_t n, uint8_t key_bits) {
+    if (n < 2 || key_bits == 0) return;
+    std::size_t threads =
+        std::min(num_threads_, std::max<std::size_t>(1, n / min_per_thread));
+    if (key_tmp_.size() < n) key_tmp_.resize(n);
+    if (with_values && value_tmp_.size() < n) value_tmp_.resize(n);
+    counts_.resize(threads);
+    scratch_.resize(threads);
+    if (with_values)
+      for (auto& scratch : scratch_) scratch.values.resize(radix * line);
+
+    std::size_t chunk = (n + threads - 1) / threads;
+    Key* src_keys = keys;
+    Key* dst_keys = key_tmp_.data();
+    Value* src_values = values;
+    Value* dst_values = value_tmp_.data();
+    for (std::size_t shift = 0; shift < key_bits; shift += digit_bits) {
+      parallelFor(threads, [&](std::size_t t) {
+        std::array<std::size_t, radix>& count = counts_[t];
+        count.fill(0);
+        for (std::size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); ++i)
+          ++count[(src_keys[i] >> shift) & (radix - 1)];
+      });
+      if (!computeOffsets(n)) continue;  // every key has the same digit
+
+      parallelFor(threads, [&](std::size_t t) {
+        scatter<with_values>(src_keys, src_values, dst_keys, dst_values,
+                             t * chunk, std::min(n, (t + 1) * chunk), shift,
+                             counts_[t], scratch_[t]);
+      });
+      std::swap(src_keys, dst_keys);
+      std::swap(src_values, dst_values);
+    }
+    if (src_keys != keys) {
+      std::copy(src_keys, src_keys + n, keys);
+      if (with_values) std::copy(src_values, src_values + n, values);
+    }
+  }
+
+  /**
+   * @brief Turns the histograms in the first position of every digit of
+   * every thread
+   *
+   * @return false if the pass can be skipped (a single digit)
+   */
+  bool computeOffsets(std::size_t n) {
+    for (std::size_t d = 0; d < radix; ++d) {
+      std::size_t total = 0;
+      for (auto& count : counts_) total += count[d];
+      if (total == n) return false;
+      if (total) break;
+    }
+    std::size_t sum = 0;
+    for (std::size_t d = 0; d < radix; ++d) {
+      for (auto& count : counts_) {
+        std::size_t c = count[d];
+        count[d] = sum;
+        sum += c;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Moves keys [begin, end) of src to dst at their digit offsets
+   */
+  template <bool with_values>
+  void scatter(const Key* src_keys, const Value* src_values, Key* dst_keys,
+               Value* dst_values, std::size_t begin, std::size_t end,
+               std::size_t shift, std::array<std::size_t, radix>& offset,
+               Scratch& scratch) {
+    scratch.fill.fill(0);
+    auto flush = [&](std::size_t d, std::size_t len) {
+      std::copy_n(scratch.keys.data() + d * line, len,
+                  dst_keys + offset[d]);
+      if (with_values)
+        std::copy_n(scratch.values.data() + d * line, len,
+                    dst_values + offset[d]);
+      offset[d] += len;
+    };
+    for (std::size_t i = begin; i < end; ++i) {
+      std::size_t d = (src_keys[i] >> shift) & (radix - 1);
+      std::size_t f = scratch.fill[d]++;
+      scratch.keys[d * line + f] = src_keys[i];
+      if (with_values) scratch.values[d * line + f] = src_values[i];
+      if (f + 1 == line) {
+        flush(d, line);
+        scratch.fill[d] = 0;
+      }
+    }
+    for (std::size_t d = 0; d < radix; ++d)
+      if (scratch.fill[d]) flush(d, scratch.fill[d]);
+  }
+
+  /**
+   * @brief Runs f(t) for t in [0, threads), on threads - 1 new threads and
+   * the caller
+   */
+  template <typename F>
+  static void parallelFor(std::size_t threads, F f) {
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < threads; ++t) workers.emplace_back(f, t);
+    f(0);
+    for (auto& worker : workers) worker.join();
+  }
+
+  std::size_t num_threads_;                         // max threads used
+  std::vector<Key> key_tmp_;                        // second buffer of keys
+  std::vector<Value> value_tmp_;                    // second buffer of values
+  std::vector<std::array<std::size_t, radix>> counts_;  // per-thread counts
+  std::vector<Scratch> scratch_;  // per-thread scatter buffers
+};
+
+/**
+ * @brief LSD radix sort of n keys of key_bits bits (keys must be
+ * < 2^key_bits)
+ *
+ * @param data keys to sort
+ * @param n number of keys
+ * @param key_bits number of low bits of the keys to sort on
+ * @param num_threads max number of threads used
+ */
+template <typename T>
+void radix_sort(T* data, std::size_t n, uint8_t key_bits,
+                std::size_t num_threads = 1) {
+  RadixSorter<T>(num_threads).sort(data, n, key_bits);
+}
+
+namespace detail {
+/**
+ * @brief Unpacks [first, last) in a buffer of T, calls sort(buffer, n) and
+ * packs the result back
+ */
+template <typename T, typename Sort>
+void sort_unpacked(WordVector::Iterator first, WordVector::Iterator last,
+                   Sort sort) {
+  WordVector& wv = *first.container();
+  std::size_t n = last - first;
+  std::vector<T> buffer(n);
+  wv.decode(first.index(), n, buffer.data());
+  sort(buffer.data(), n);
+  wv.encode(first.index(), buffer.data(), n);
+}
+}  // namespace detail
+
+/**
+ * @brief Sort words in [first, last) by value (radix sort on the unpacked
+ * words, std::sort for small ranges)
+ *
+ * @param first iterator to first word
+ * @param last iterator past last word (same vector of first)
+ */
+inline void sort_words(WordVector::Iterator first, WordVector::Iterator last) {
+  if (last - first < 2) return;
+  uint8_t word_size = first.container()->getWordSize();
+  auto sort = [word_size](auto* data, std::size_t n) {
+    if (n < 256)
+      std::sort(data, data + n);
+    else
+      radix_sort(data, n, word_size);
+  };
+  if (word_size <= 32)
+    detail::sort_unpacked<uint32_t>(first, last, sort);
+  else
+    detail::sort_unpacked<uint64_t>(first, last, sort);
+}
+
+/**
+ * @brief Sort words in [first, last) with cmp on the unpacked words
+ *
+ * @param first iterator to first word
+ * @param last iterator past last word (same vector of first)
+ * @param cmp comparator on WordVector::value_type
+ */
+template <typename Compare>
+void sort_words(WordVector::Iterator first, WordVector::Iterator last,
+                Compare cmp) {
+  if (last - first < 2) return;
+  auto sort = [&cmp](auto* data, std::size_t n) {
+    std::sort(data, data + n, cmp);
+  };
+  if (first.container()->getWordSize() <= 32)
+    detail::sort_unpacked<uint32_t>(first, last, sort);
+  else
+    detail::sort_unpacked<uint64_t>(first, last, sort);
+}
+
+/**
+ * @brief Radix sort of the words of keys, using up to num_threads threads
+ */
+inline void radix_sort_words(WordVector& keys, std::size_t num_threads = 1) {
+  std::size_t n = keys.size();
+  uint8_t word_size = keys.getWordSize();
+  auto sort = [n, word_size, num_threads](auto* data) {
+    using T = std::remove_pointer_t<decltype(data)>;
+    RadixSorter<T>(num_threads).sort(data, n, word_size);
+  };
+  if (word_size <= 32) {
+    std::vector<uint32_t> buffer(n);
+    keys.decode(0, n, buffer.data());
+    sort(buffer.data());
+    keys.encode(0, buffer.data(), n);
+  } else {
+    std::vector<uint64_t> buffer(n);
+    keys.decode(0, n, buffer.data());
+    sort(buffer.data());
+    keys.encode(0, buffer.data(), n);
+  }
+}
+
+/**
+ * @brief Stable radix sort of the words of keys, values[i] is moved with
+ * keys[i]
+ *
+ * Important: values.size() must be keys.size()
+ *
+ * @param keys words to sort
+ * @param values satellite words
+ * @param num_threads max number of threads used
+ */
+inline void radix_sort_words(WordVector& keys, WordVector& values,
+                             std::size_t num_threads = 1) {
+  assert(keys.size() == values.size() && "keys and values not matching");
+  std::size_t n = keys.size();
+  std::vector<uint64_t> key_buffer(n);
+  std::vector<uint64_t> value_buffer(n);
+  keys.decode(0, n, key_buffer.data());
+  values.decode(0, n, value_buffer.data());
+  RadixSorter<uint64_t>(num_threads)
+      .sort(key_buffer.data(), value_buffer.data(), n, keys.getWordSize());
+  keys.encode(0, key_buffer.data(), n);
+  values.encode(0, value_buffer.data(), n);
+}
+
+/**
+ * @brief Sort all the words of wv by value
+ */
+inline void sort_words(WordVector& wv) { sort_words(wv.begin(), wv.end()); }
+
+/**
+ * @brief Sort all the words of wv with cmp
+ */
+template <typename Compare>
+void sort_words(WordVector& wv, Compare cmp) {
+  sort_words(wv.begin(), wv.end(), cmp);
+}
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_WORDVECTORSORT_
@@ -0,0 +1,227 @@
+#ifndef UNIALGO_UTILS_BITVECTOR_WORDVECTORVIEW_
+#define UNIALGO_UTILS_BITVECTOR_WORDVECTORVIEW_
+
+#include <stdint.h>  // uint64_t
+
+#include <cassert>   // assert
+#include <cstddef>   // std::ptrdiff_t
+#include <iterator>  // std::random_access_iterator_tag
+
+#include "unialgo/utils/bitvector/bitMaps.hpp"
+#include "unialgo/utils/bitvector/wordVector.hpp"
+
+/**
+ * @file This file contains a read-only view on packed words owned by someone
+ * else (same layout of WordVector), the viewed words must outlive the view
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+/**
+ * @brief Class WordVectorView
+ * non-owning read-only view on num_words words of word_size bits
+ */
+class WordVectorView {
+ public:
+  using Type = uint64_t;                                  // type of memory
+  using value_type = std::size_t;                         // type of a word
+  static const std::size_t type_size = sizeof(Type) * 8;  // size of Type
+
+  /**
+   * @brief Construct an empty view
+   */
+  WordVectorView()
+      : words_(nullptr), offset_(0), num_words_(0), word_size_(2) {}
+
+  /**
+   * @brief Construct a view on num_words words starting at bit offset
+   *
+   * @param words first word of the memory viewed
+   * @param num_words number of words in the view
+   * @param word_size size of a single word in bits
+   * @param offset position in bits of the first word of the view
+   */
+  WordVectorView(const Type* words, std::size_t num_words, uint8_t word_size,
+                 std::size_t offset = 0)
+      : words_(words + offset / type_size),
+        offset_(offset % type_size),
+        num_words_(num_words),
+        word_size_(word_size) {}
+
+  /**
+   * @brief Construct a view on all the words of wv
+   */
+  WordVectorView(const WordVector& wv)
+      : WordVectorView(wv.data(), wv.size(), wv.getWordSize()) {}
+
+  /**
+   * @brief Value of word at pos (unchecked)
+   */
+  value_type operator[](std::size_t pos) const {
+    std::size_t bit = offset_ + pos * word_size_;
+    return read_bits(words_ + bit / type_size, bit % type_size, word_size_);
+  }
+
+  /**
+   * @brief Value of word at pos
+   *
+   * This checks the access (pos < size())
+   */
+  value_type at(std::size_t pos) const {
+    assert(pos < num_words_ && "WordVectorView access out of bounds");
+    return this->operator[](pos);
+  }
+
+  /**
+   * @brief View on words [start, end] of this view (no copy)
+   *
+   * Important: must satisfy: start <= end < size()
+   */
+  WordVectorView slice(std::size_t start, std::size_t end) const {
+    return WordVectorView(words_, end - start + 1, word_size_,
+                          offset_ + start * word_size_);
+  }
+
+  std::size_t size() const { return num_words_; }
+  std::size_t getNumBits() const { return num_words_ * word_size_; }
+  uint8_t getWordSize() const { return word_size_; }
+
+  // iterators keep a copy of the view (a pointer and three sizes): they stay
+  // valid after a temporary view, as v.slice(a, b).begin(), is gone
+  class ConstIterator;
+
+  ConstIterator begin() const;
+  ConstIterator end() const;
+  ConstIterator cbegin() const;
+  ConstIterator cend() const;
+
+ private:
+  const Type* words_;      // word containing the first bit of the view
+  std::size_t offset_;     // position of the first bit in words_[0]
+  std::size_t num_words_;  // number of words in the view
+  uint8_t word_size_;      // size of a single word
+};
+
+/**
+ * @brief Random access iterator on the values of the view
+ */
+class WordVectorView::ConstIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using value_type = WordVectorView::value_type;
+  using pointer = const value_type*;
+  using reference = value_type;
+
+  ConstIterator() : pos_(0), view_() {}
+  ConstIterator(std::size_t pos, const WordVectorView& view)
+      : pos_(pos), view_(view) {}
+
+  reference operator*() const { return view_[pos_]; }
+  reference operator[](difference_type n) const { return view_[pos_ + n]; }
+
+  ConstIterator& operator++() {
+    ++pos_;
+    return *this;
+  }
+
+  ConstIterator operator++(int) {
+    ConstIterator tmp = *this;
+    ++pos_;
+    return tmp;
+  }
+
+  ConstIterator& operator--() {
+    --pos_;
+    return *this;
+  }
+
+  ConstIterator operator--(int) {
+    ConstIterator tmp = *this;
+    --pos_;
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type n) {
+    pos_ += n;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type n) {
+    pos_ -= n;
+    return *this;
+  }
+
+  friend ConstIterator operator+(ConstIterator it, difference_type n) {
+    return it += n;
+  }
+
+  friend ConstIterator operator+(difference_type n, ConstIterator it) {
+    return it += n;
+  }
+
+  friend ConstIterator operator-(ConstIterator it, difference_type n) {
+    return it -= n;
+  }
+
+  friend difference_type operator-(const ConstIterator& a,
+                                   const ConstIterator& b) {
+    return a.pos_ - b.pos_;
+  }
+
+  friend bool operator==(const ConstIterator& a, const ConstIterator& b) {
+    return a.sameView(b) && a.pos_ == b.pos_;
+  }
+
+  friend bool operator!=(const ConstIterator& a, const ConstIterator& b) {
+    return !(a == b);
+  }
+
+  friend bool operator<(const ConstIterator& a, const ConstIterator& b) {
+    return a.pos_ < b.pos_;
+  }
+
+  friend bool operator>(const ConstIterator& a, const ConstIterator& b) {
+    return b < a;
+  }
+
+  friend bool operator<=(const ConstIterator& a, const ConstIterator& b) {
+    return !(b < a);
+  }
+
+  friend bool operator>=(const ConstIterator& a, const ConstIterator& b) {
+    return !(a < b);
+  }
+
+ private:
+  bool sameView(const ConstIterator& other) const {
+    return view_.words_ == other.view_.words_ &&
+           view_.offset_ == other.view_.offset_;
+  }
+
+  std::size_t pos_;      // position of word in view
+  WordVectorView view_;  // view iterated
+};
+
+inline WordVectorView::ConstIterator WordVectorView::begin() const {
+  return ConstIterator(0, *this);
+}
+
+inline WordVectorView::ConstIterator WordVectorView::end() const {
+  return ConstIterator(num_words_, *this);
+}
+
+inline WordVectorView::ConstIterator WordVectorView::cbegin() const {
+  return begin();
+}
+
+inline WordVectorView::ConstIterator WordVectorView::cend() const {
+  return end();
+}
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_BITVECTOR_WORDVECTORVIEW_
@@ -0,0 +1,171 @@
+#include "unialgo/utils/dynamicWaveletMatrix.hpp"
+
+#include <cassert>  // assert
+#include <utility>  // std::swap
+
+#include "unialgo/utils/bitvector/builders.hpp"
+
+namespace unialgo {
+namespace utils {
+
+DynamicWaveletMatrix::DynamicWaveletMatrix(uint8_t word_size)
+    : string_size_(0),
+      matrix_depth_(word_size),
+      levels_(word_size),
+      Zs_(word_size, 0) {
+  assert(word_size > 0 && word_size <= 64 && "word size must be in [1, 64]");
+}
+
+DynamicWaveletMatrix::DynamicWaveletMatrix(const utils::WordVector& string)
+    : string_size_(string.size()), matrix_depth_(string.getWordSize()) {
+  const std::size_t n = string_size_;
+  // values in the order of the current layer and of the next one
+  std::vector<uint64_t> order(n);
+  std::vector<uint64_t> next(n);
+  string.decode(0, n, order.data());
+  for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+    unialgo::utils::BitvectorBuilder bits;
+    bits.reserve(n);
+    std::size_t zero_pos = 0;
+    for (uint64_t value : order) {
+      bool bit = bitOf(value, layer);
+      bits.push_back(bit);
+      if (!bit) next[zero_pos++] = value;
+    }
+    Zs_.push_back(zero_pos);
+    levels_.emplace_back(bits.build());
+    // the 1s go after the 0s, in the same order
+    std::size_t one_pos = zero_pos;
+    for (uint64_t value : order)
+      if (bitOf(value, layer)) next[one_pos++] = value;
+    std::swap(order, next);
+  }
+}
+
+bool DynamicWaveletMatrix::bitOf(uint64_t character,
+                                 std::size_t layer) const {
+  return (character >> (matrix_depth_ - 1 - layer)) & 1;
+}
+
+std::size_t DynamicWaveletMatrix::rankLevel(std::size_t layer,
+                                            std::size_t pos,
+                                            bool value) const {
+  if (pos == 0) return 0;
+  return levels_[layer].rank(pos - 1, value);
+}
+
+std::size_t DynamicWaveletMatrix::getStringSize() const {
+  return string_size_;
+}
+
+std::size_t DynamicWaveletMatrix::getMatrixDepth() const {
+  return matrix_depth_;
+}
+
+uint64_t DynamicWaveletMatrix::acces(std::size_t indx) const {
+  assert(indx < string_size_ && "acces out of range");
+  uint64_t res = 0;
+  std::size_t pos = indx;
+  for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+    bool value = levels_[layer].GetBit(pos);
+    res = res << 1 | value;
+    pos = value ? Zs_[layer] + rankLevel(layer, pos, true)
+                : rankLevel(layer, pos, false);
+  }
+  return res;
+}
+
+std::size_t DynamicWaveletMatrix::rank(const uint64_t character,
+                                       std::size_t pos) const {
+  assert(pos < string_size_ && "rank out of range");
+  if (matrix_depth_ < 64 && (character >> matrix_depth_)) return 0;
+  // [start, end) = values equal to character in [0, pos] below layer
+  std::size_t start = 0;
+  std::size_t end = pos + 1;
+  for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+    bool value = bitOf(character, layer);
+    std::size_t zeros = value ? Zs_[layer] : 0;
+    start = zeros + rankLevel(layer, start, value);
+    end = zeros + rankLevel(layer, end, value);
+    if (start == end) return 0;
+  }
+  return end - start;
+}
+
+std::size_t DynamicWaveletMatrix::rank(
+    const unialgo::utils::WordVectorConstReference character,
+    std::size_t pos) const {
+  return rank(character.getValue(), pos);
+}
+
+std::size_t DynamicWaveletMatrix::rank(
+    const unialgo::utils::WordVectorReference character,
+    std::size_t pos) const {
+  return rank(character.getValue(), pos);
+}
+
+std::size_t DynamicWaveletMatrix::select(const uint64_t character,
+                                         std::size_t count) const {
+  if (string_size_ == 0 || count == 0) return -1;
+  if (matrix_depth_ < 64 && (character >> matrix_depth_)) return -1;
+
+  std::size_t start = 0;
+  std::size_t end = string_size_;
+  for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+    bool value = bitOf(character, layer);
+    std::size_t zeros = value ? Zs_[layer] : 0;
+    start = zeros + rankLevel(layer, start, value);
+    end = zeros + rankLevel(layer, end, value);
+  }
+  if (end - start < count) return -1;
+
+  // back up: the position in a layer is the select of the bit that moved it
+  std::size_t pos = start + count - 1;
+  for (std::size_t layer = matrix_depth_; layer-- > 0;) {
+    bool value = bitOf(character, layer);
+    std::size_t nth = value ? pos - Zs_[layer] : pos;  // among value bits
+    pos = levels_[layer].select(nth + 1, value);
+  }
+  return pos;
+}
+
+void DynamicWaveletMatrix::insert(std::size_t pos, const uint64_t character) {
+  assert(pos <= string_size_ && "insert out of range");
+  assert((matrix_depth_ == 64 || !(character >> matrix_depth_)) &&
+         "character wider than the word size");
+  for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+    bool value = bitOf(character, layer);
+    levels_[layer].insert(pos, value);
+    if (!value) ++Zs_[layer];
+    // the value goes after the values with the same bit before it
+    pos = value ? Zs_[layer] + rankLevel(layer, pos, true)
+                : rankLevel(layer, pos, false);
+  }
+  ++string_size_;
+}
+
+uint64_t DynamicWaveletMatrix::erase(std::size_t pos) {
+  assert(pos < string_size_ && "erase out of range");
+  uint64_t res = 0;
+  for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+    bool value = levels_[layer].GetBit(pos);
+    res = res << 1 | value;
+    // position in the next layer, taken before the bit is removed
+    std::size_t next = value ? Zs_[layer] + rankLevel(layer, pos, true)
+                             : rankLevel(layer, pos, false);
+    levels_[layer].erase(pos);
+    if (!value) --Zs_[layer];
+    pos = next;
+  }
+  --string_size_;
+  return res;
+}
+
+void DynamicWaveletMatrix::set(std::size_t pos, const uint64_t character) {
+  assert(pos < string_size_ && "set out of range");
+  erase(pos);
+  insert(pos, character);
+}
+
+}  // namespace utils
+}  // namespace unialgo
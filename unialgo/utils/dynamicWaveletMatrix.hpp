@@ -0,0 +1,109 @@
+#ifndef UNIALGO_UTILS_DYNAMIC_WAVELET_MATRIX_
+#define UNIALGO_UTILS_DYNAMIC_WAVELET_MATRIX_
+
+#include <stdint.h>  // uint8_t, uint64_t
+
+#include <vector>  // std::vector
+
+#include "unialgo/utils/bitvector/dynamicBitvector.hpp"
+#include "unialgo/utils/bitvector/wordVector.hpp"
+
+namespace unialgo {
+namespace utils {
+
+/**
+ * @brief Wavelet matrix supporting insert, erase and set of values
+ *
+ * Same levels of BasicWaveletMatrix, every level is a DynamicBitvector: an
+ * update goes down the levels inserting (or erasing) a bit per level, at
+ * the position the value takes in that level. Queries and updates are
+ * O(word size * log(n)).
+ *
+ * Values have word size bits, fixed at construction
+ */
+class DynamicWaveletMatrix {
+ public:
+  DynamicWaveletMatrix() : string_size_(0), matrix_depth_(0) {}
+
+  /**
+   * @brief Construct an empty Dynamic Wavelet Matrix object
+   *
+   * @param word_size bits of the values (1 to 64)
+   */
+  explicit DynamicWaveletMatrix(uint8_t word_size);
+
+  /**
+   * @brief Construct a new Dynamic Wavelet Matrix object
+   *
+   * @param string initial string (its word size is the one of the values)
+   */
+  explicit DynamicWaveletMatrix(const unialgo::utils::WordVector& string);
+
+  /**
+   * @brief Access value in string, O(word size * log(n))
+   *
+   * @param indx value to access
+   * @return uint64_t string[indx]
+   */
+  uint64_t acces(std::size_t indx) const;
+
+  /**
+   * @brief Rank of charachter up to position
+   *
+   * @param character character to count occurrences
+   * @param pos position to end count (included)
+   * @return std::size_t # of occ in [0, pos]
+   */
+  std::size_t rank(const uint64_t character, std::size_t pos) const;
+  std::size_t rank(const unialgo::utils::WordVectorConstReference character,
+                   std::size_t pos) const;
+  std::size_t rank(const unialgo::utils::WordVectorReference character,
+                   std::size_t pos) const;
+
+  /**
+   * @brief Position of the count-th occurrence of character
+   *
+   * @param character character to search
+   * @param count i-th occurrence searched (starting from 1)
+   * @return std::size_t position of the occurrence, -1 if not present
+   */
+  std::size_t select(const uint64_t character, std::size_t count) const;
+
+  /**
+   * @brief Inserts character before position pos (pos == size appends)
+   */
+  void insert(std::size_t pos, const uint64_t character);
+  void push_back(const uint64_t character) {
+    insert(string_size_, character);
+  }
+
+  /**
+   * @brief Removes the value in position pos
+   *
+   * @return uint64_t value removed
+   */
+  uint64_t erase(std::size_t pos);
+
+  /**
+   * @brief Replaces the value in position pos with character
+   */
+  void set(std::size_t pos, const uint64_t character);
+
+  std::size_t getStringSize() const;
+  std::size_t getMatrixDepth() const;
+
+ private:
+  // # of bits set to value in the first pos bits of layer
+  std::size_t rankLevel(std::size_t layer, std::size_t pos, bool value) const;
+  bool bitOf(uint64_t character, std::size_t layer) const;
+
+  std::size_t string_size_;                               // size of the string
+  std::size_t matrix_depth_;                              // depth of the matrix
+  std::vector<unialgo::utils::DynamicBitvector> levels_;  // bits of the levels
+  std::vector<std::size_t> Zs_;                           // #0s in layers
+};  // class DynamicWaveletMatrix
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_DYNAMIC_WAVELET_MATRIX_
@@ -0,0 +1,299 @@
+#include "unialgo/utils/huffmanWaveletMatrix.hpp"
+
+#include <algorithm>        // std::sort, std::lower_bound, std::max
+#include <cassert>          // assert
+#include <functional>       // std::greater
+#include <memory>           // std::shared_ptr, std::allocate_shared
+#include <memory_resource>  // std::pmr::polymorphic_allocator
+#include <queue>            // std::priority_queue
+#include <utility>          // std::swap, std::move
+
+#include "unialgo/utils/bitvector/builders.hpp"
+
+namespace unialgo {
+namespace utils {
+
+namespace {
+/**
+ * @brief Huffman code length of values with the given counts (at least 1)
+ */
+std::vector<uint8_t> huffman_lengths(const std::vector<std::size_t>& counts) {
+  std::size_t m = counts.size();
+  if (m == 1) return {1};
+  // nodes [0, m) are the values, every merge adds a node
+  std::vector<std::size_t> parent(2 * m - 1);
+  using Item = std::pair<std::size_t, std::size_t>;  // weight, node
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  for (std::size_t i = 0; i < m; ++i) queue.push({counts[i], i});
+  for (std::size_t node = m; node < 2 * m - 1; ++node) {
+    Item a = queue.top();
+    queue.pop();
+    Item b = queue.top();
+    queue.pop();
+    parent[a.second] = parent[b.second] = node;
+    queue.push({a.first + b.first, node});
+  }
+  // parents are created after their children, the root is the last node
+  std::vector<std::size_t> depth(2 * m - 1, 0);
+  for (std::size_t node = 2 * m - 2; node-- > 0;)
+    depth[node] = depth[parent[node]] + 1;
+  std::vector<uint8_t> res(m);
+  for (std::size_t i = 0; i < m; ++i) {
+    assert(depth[i] <= 64 && "Huffman code longer than 64 bits");
+    res[i] = depth[i];
+  }
+  return res;
+}
+}  // namespace
+
+template <typename RankSupport>
+BasicHuffmanWaveletMatrix<RankSupport>::BasicHuffmanWaveletMatrix(
+    const utils::WordVector& string, std::pmr::memory_resource* resource)
+    : string_size_(string.size()),
+      word_size_(string.getWordSize()),
+      level_offsets_(resource),
+      level_sizes_(resource),
+      Zs_(resource),
+      codes_(resource),
+      leaves_(resource) {
+  const std::size_t n = string_size_;
+  if (n == 0) return;
+  std::vector<uint64_t> values(n);
+  string.decode(0, n, values.data());
+
+  // distinct values by value and their code lengths
+  std::unordered_map<uint64_t, std::size_t> occurrences;
+  for (uint64_t value : values) ++occurrences[value];
+  std::vector<std::pair<uint64_t, std::size_t>> symbols(occurrences.begin(),
+                                                        occurrences.end());
+  std::sort(symbols.begin(), symbols.end());
+  std::vector<std::size_t> counts(symbols.size());
+  for (std::size_t i = 0; i < symbols.size(); ++i)
+    counts[i] = symbols[i].second;
+  std::vector<uint8_t> lengths = huffman_lengths(counts);
+  std::size_t max_length = *std::max_element(lengths.begin(), lengths.end());
+  std::vector<std::vector<uint64_t>> by_length(max_length + 1);
+  for (std::size_t i = 0; i < symbols.size(); ++i)
+    by_length[lengths[i]].push_back(symbols[i].first);
+
+  // codes: at every depth the leaves are the nodes coming last in the order
+  // of the level, the nodes with the biggest code (bit l = level l)
+  leaves_.resize(max_length + 1);
+  codes_.reserve(symbols.size());
+  std::vector<uint64_t> internal = {0};
+  for (std::size_t depth = 1; depth <= max_length; ++depth) {
+    std::vector<uint64_t> nodes;
+    for (uint64_t prefix : internal) {
+      nodes.push_back(prefix);
+      nodes.push_back(prefix | uint64_t{1} << (depth - 1));
+    }
+    std::sort(nodes.begin(), nodes.end());
+    std::size_t first_leaf = nodes.size() - by_length[depth].size();
+    leaves_[depth].reserve(by_length[depth].size());
+    for (std::size_t j = 0; j < by_length[depth].size(); ++j) {
+      uint64_t code = nodes[first_leaf + j];
+      codes_[by_length[depth][j]] = {code, static_cast<uint8_t>(depth)};
+      leaves_[depth].push_back({code, by_length[depth][j]});
+    }
+    nodes.resize(first_leaf);
+    internal = std::move(nodes);
+  }
+
+  // levels: stable partition of the codes still going down
+  std::vector<Code> order(n);
+  std::vector<Code> next(n);
+  for (std::size_t i = 0; i < n; ++i) order[i] = codes_.at(values[i]);
+  // scratch when the helper keeps its own copy of the bits: not on resource
+  std::pmr::memory_resource* bits_resource =
+      RankSupport::stores_bits ? std::pmr::get_default_resource() : resource;
+  unialgo::utils::BitvectorBuilder bits(bits_resource);
+  // every value takes a bit per level of its code
+  std::size_t total_bits = 0;
+  for (std::size_t i = 0; i < symbols.size(); ++i)
+    total_bits += counts[i] * lengths[i];
+  bits.reserve(total_bits);
+  level_offsets_.reserve(max_length);
+  level_sizes_.reserve(max_length);
+  Zs_.reserve(max_length);
+  std::size_t size = n;
+  for (std::size_t layer = 0; layer < max_length; ++layer) {
+    level_offsets_.push_back(bits.size());
+    level_sizes_.push_back(size);
+    std::size_t zero_count = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      bool bit = (order[i].bits >> layer) & 1;
+      bits.push_back(bit);
+      zero_count += !bit;
+    }
+    Zs_.push_back(zero_count);
+
+    std::size_t zero_pos = 0;
+    std::size_t one_pos = zero_count;
+    std::size_t next_size = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      if ((order[i].bits >> layer) & 1)
+        next[one_pos++] = order[i];
+      else
+        next[zero_pos++] = order[i];
+      next_size += order[i].length > layer + 1;
+    }
+    std::swap(order, next);
+    size = next_size;  // codes ending here are the last ones
+  }
+
+  // the control block is allocated next to the bits, on their resource
+  matrix_ = std::allocate_shared<utils::Bitvector>(
+      std::pmr::polymorphic_allocator<utils::Bitvector>(bits_resource),
+      bits.build());
+  initHelper();
+}
+
+template <typename RankSupport>
+void BasicHuffmanWaveletMatrix<RankSupport>::initHelper() {
+  helper_.reset();
+  if (!matrix_ || matrix_->size() == 0) return;
+  // the helper allocates from the resource of the matrix
+  helper_.emplace(matrix_, 1, Zs_.get_allocator().resource());
+  if constexpr (RankSupport::stores_bits) matrix_.reset();
+}
+
+template <typename RankSupport>
+void BasicHuffmanWaveletMatrix<RankSupport>::initHelper(
+    const BasicHuffmanWaveletMatrix& other) {
+  if constexpr (RankSupport::stores_bits)
+    helper_ = other.helper_;
+  else
+    initHelper();
+}
+
+template <typename RankSupport>
+BasicHuffmanWaveletMatrix<RankSupport>::BasicHuffmanWaveletMatrix(
+    const BasicHuffmanWaveletMatrix& other)
+    : string_size_(other.string_size_),
+      word_size_(other.word_size_),
+      matrix_(other.matrix_ ? std::make_shared<utils::Bitvector>(*other.matrix_)
+                            : nullptr),
+      level_offsets_(other.level_offsets_),
+      level_sizes_(other.level_sizes_),
+      Zs_(other.Zs_),
+      codes_(other.codes_),
+      leaves_(other.leaves_) {
+  initHelper(other);
+}
+
+template <typename RankSupport>
+BasicHuffmanWaveletMatrix<RankSupport>&
+BasicHuffmanWaveletMatrix<RankSupport>::operator=(
+    const BasicHuffmanWaveletMatrix& other) {
+  if (this != &other) {
+    string_size_ = other.string_size_;
+    word_size_ = other.word_size_;
+    matrix_ = other.matrix_
+                  ? std::make_shared<utils::Bitvector>(*other.matrix_)
+                  : nullptr;
+    level_offsets_ = other.level_offsets_;
+    level_sizes_ = other.level_sizes_;
+    Zs_ = other.Zs_;
+    codes_ = other.codes_;
+    leaves_ = other.leaves_;
+    initHelper(other);
+  }
+  return *this;
+}
+
+template <typename RankSupport>
+std::size_t BasicHuffmanWaveletMatrix<RankSupport>::rankLevel(
+    std::size_t layer, std::size_t pos, bool value) const {
+  if (pos == 0) return 0;
+  std::size_t lo = level_offsets_[layer];
+  return helper_->rank(lo, lo + pos - 1, value);
+}
+
+template <typename RankSupport>
+uint64_t BasicHuffmanWaveletMatrix<RankSupport>::acces(
+    std::size_t indx) const {
+  uint64_t code = 0;
+  std::size_t pos = indx;  // this is relative to layers and not bv
+  for (std::size_t layer = 0;; ++layer) {
+    bool value = helper_->GetBit(level_offsets_[layer] + pos);
+    code |= uint64_t{value} << layer;
+    pos = value ? Zs_[layer] + rankLevel(layer, pos, true)
+                : rankLevel(layer, pos, false);
+    // past the values of the next level: the code ends here
+    std::size_t next_size =
+        layer + 1 < level_sizes_.size() ? level_sizes_[layer + 1] : 0;
+    if (pos >= next_size) {
+      const auto& leaves = leaves_[layer + 1];
+      auto leaf = std::lower_bound(leaves.begin(), leaves.end(),
+                                   std::make_pair(code, uint64_t{0}));
+      return leaf->second;
+    }
+  }
+}
+
+template <typename RankSupport>
+std::size_t BasicHuffmanWaveletMatrix<RankSupport>::rank(
+    const uint64_t character, std::size_t pos) const {
+  auto code = codes_.find(character);
+  if (code == codes_.end()) return 0;
+  // [start, end) = values equal to character in [0, pos] below layer
+  std::size_t start = 0;
+  std::size_t end = pos + 1;
+  for (std::size_t layer = 0; layer < code->second.length; ++layer) {
+    bool value = (code->second.bits >> layer) & 1;
+    std::size_t zeros = value ? Zs_[layer] : 0;
+    start = zeros + rankLevel(layer, start, value);
+    end = zeros + rankLevel(layer, end, value);
+    if (start == end) return 0;
+  }
+  return end - start;
+}
+
+template <typename RankSupport>
+std::size_t BasicHuffmanWaveletMatrix<RankSupport>::rank(
+    const unialgo::utils::WordVectorConstReference character,
+    std::size_t pos) const {
+  return rank(character.getValue(), pos);
+}
+
+template <typename RankSupport>
+std::size_t BasicHuffmanWaveletMatrix<RankSupport>::rank(
+    const unialgo::utils::WordVectorReference character,
+    std::size_t pos) const {
+  return rank(character.getValue(), pos);
+}
+
+template <typename RankSupport>
+std::size_t BasicHuffmanWaveletMatrix<RankSupport>::getStringSize() const {
+  return string_size_;
+}
+
+template <typename RankSupport>
+std::size_t BasicHuffmanWaveletMatrix<RankSupport>::getMatrixDepth() const {
+  return word_size_;
+}
+
+template <typename RankSupport>
+std::size_t BasicHuffmanWaveletMatrix<RankSupport>::getNumLevels() const {
+  return level_sizes_.size();
+}
+
+template <typename RankSupport>
+std::size_t BasicHuffmanWaveletMatrix<RankSupport>::getNumBits() const {
+  if (level_sizes_.empty()) return 0;
+  return level_offsets_.back() + level_sizes_.back();
+}
+
+template <typename RankSupport>
+std::size_t BasicHuffmanWaveletMatrix<RankSupport>::getCodeLength(
+    const uint64_t character) const {
+  auto code = codes_.find(character);
+  return code == codes_.end() ? 0 : code->second.length;
+}
+
+// instantiations for the available rank helpers
+template class BasicHuffmanWaveletMatrix<utils::RankHelper>;
+template class BasicHuffmanWaveletMatrix<utils::InterleavedRankHelper>;
+
+}  // namespace utils
+}  // namespace unialgo
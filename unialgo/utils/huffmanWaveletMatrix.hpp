@@ -0,0 +1,156 @@
+#ifndef UNIALGO_UTILS_HUFFMAN_WAVELET_MATRIX_
+#define UNIALGO_UTILS_HUFFMAN_WAVELET_MATRIX_
+
+#include <stdint.h>  // uint64_t
+
+#include <memory>           // std::shared_ptr
+#include <memory_resource>  // std::pmr::memory_resource
+#include <optional>         // std::optional
+#include <type_traits>      // std::is_constructible_v
+#include <unordered_map>    // std::pmr::unordered_map
+#include <utility>          // std::pair
+#include <vector>           // std::pmr::vector
+
+#include "unialgo/utils/bitvector/bitvector.hpp"
+#include "unialgo/utils/bitvector/rankHelper.hpp"
+#include "unialgo/utils/bitvector/rankInterleaved.hpp"
+#include "unialgo/utils/bitvector/wordVector.hpp"
+
+namespace unialgo {
+namespace utils {
+
+/**
+ * @brief Huffman-shaped wavelet matrix over a WordVector
+ *
+ * Every value is indexed with its Huffman code instead of its word size
+ * bits: level l holds a bit for the values with a code longer than l, so
+ * frequent values go through few levels and the matrix takes about
+ * n * (H0 + 1) bits instead of n * word size.
+ *
+ * A level orders its values by their code bits read from the last level up
+ * (the order of a wavelet matrix). The codes are chosen so that at every
+ * level the codes ending there come last in that order: the next level is
+ * the first part of the partitioned values, and a value ends where its
+ * position falls past the size of the next level.
+ *
+ * Same rank / acces interface of BasicWaveletMatrix (usable as Occ of
+ * pattern::BasicBwt)
+ *
+ * @tparam RankSupport rank/select structure built on the matrix bits (see
+ * BasicWaveletMatrix)
+ */
+template <typename RankSupport>
+class BasicHuffmanWaveletMatrix {
+  static_assert(std::is_constructible_v<RankSupport,
+                                        std::shared_ptr<utils::Bitvector>,
+                                        std::size_t,
+                                        std::pmr::memory_resource*>,
+                "RankSupport must take the memory resource of the matrix");
+
+ public:
+  BasicHuffmanWaveletMatrix() : string_size_(0), word_size_(0) {}
+
+  /**
+   * @brief Construct a new Basic Huffman Wavelet Matrix object
+   *
+   * @param string string to index
+   * @param resource memory resource of the matrix bits, rank support, levels
+   * and codes
+   */
+  BasicHuffmanWaveletMatrix(
+      const unialgo::utils::WordVector& string,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  ~BasicHuffmanWaveletMatrix() = default;
+
+  BasicHuffmanWaveletMatrix(const BasicHuffmanWaveletMatrix& other);
+  BasicHuffmanWaveletMatrix(BasicHuffmanWaveletMatrix&& other) noexcept =
+      default;
+
+  BasicHuffmanWaveletMatrix& operator=(const BasicHuffmanWaveletMatrix& other);
+  BasicHuffmanWaveletMatrix& operator=(BasicHuffmanWaveletMatrix&& other) =
+      default;
+
+  /**
+   * @brief Access value in string
+   *
+   * This is O(length of the code of string[indx])
+   *
+   * @param indx value to access
+   * @return uint64_t string[indx]
+   */
+  uint64_t acces(std::size_t indx) const;
+
+  /**
+   * @brief Rank of charachter up to position
+   *
+   * This is O(length of the code of character)
+   *
+   * @param character character to count occurrences
+   * @param pos position to end count (included)
+   * @return std::size_t # of occ in [0, pos] (0 if not in the string)
+   */
+  std::size_t rank(const uint64_t character, std::size_t pos) const;
+  std::size_t rank(const unialgo::utils::WordVectorConstReference character,
+                   std::size_t pos) const;
+  std::size_t rank(const unialgo::utils::WordVectorReference character,
+                   std::size_t pos) const;
+
+  std::size_t getStringSize() const;
+
+  /**
+   * @brief Bits of the values indexed (word size of the string), as
+   * BasicWaveletMatrix::getMatrixDepth
+   */
+  std::size_t getMatrixDepth() const;
+
+  /**
+   * @brief Number of levels (length of the longest code)
+   */
+  std::size_t getNumLevels() const;
+
+  /**
+   * @brief Bits stored in the levels (sum of the code lengths of the values)
+   */
+  std::size_t getNumBits() const;
+
+  /**
+   * @brief Length of the code of character (0 if not in the string)
+   */
+  std::size_t getCodeLength(const uint64_t character) const;
+
+ private:
+  struct Code {
+    uint64_t bits;   // bit l = bit of level l
+    uint8_t length;  // # of levels of the value
+  };
+
+  void initHelper();  // builds helper_ from matrix_ (or copies other's)
+  void initHelper(const BasicHuffmanWaveletMatrix& other);
+
+  // # of bits set to value in the first pos bits of layer
+  std::size_t rankLevel(std::size_t layer, std::size_t pos, bool value) const;
+
+  std::size_t string_size_;  // size of the string
+  std::size_t word_size_;    // bits of the values indexed
+  // levels one after the other, shared with the helper (moves keep it valid)
+  std::shared_ptr<unialgo::utils::Bitvector> matrix_;
+  // rank support of matrix_, built in place on its resource (none if empty)
+  std::optional<RankSupport> helper_;
+  std::pmr::vector<std::size_t> level_offsets_;  // first bit of every level
+  std::pmr::vector<std::size_t> level_sizes_;    // # of values in levels
+  std::pmr::vector<std::size_t> Zs_;             // #0s in layers
+  std::pmr::unordered_map<uint64_t, Code> codes_;  // code of every value
+  std::pmr::vector<std::pmr::vector<std::pair<uint64_t, uint64_t>>>
+      leaves_;  // leaves_[len]: (code, value) sorted by code
+};  // class BasicHuffmanWaveletMatrix
+
+using HuffmanWaveletMatrix =
+    BasicHuffmanWaveletMatrix<unialgo::utils::RankHelper>;
+using InterleavedHuffmanWaveletMatrix =
+    BasicHuffmanWaveletMatrix<unialgo::utils::InterleavedRankHelper>;
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_HUFFMAN_WAVELET_MATRIX_
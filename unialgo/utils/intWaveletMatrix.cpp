@@ -0,0 +1,134 @@
+#include "unialgo/utils/intWaveletMatrix.hpp"
+
+#include <algorithm>  // std::sort, std::unique, std::lower_bound
+#include <cassert>    // assert
+
+#include "unialgo/utils/bitvector/builders.hpp"
+
+namespace unialgo {
+namespace utils {
+
+namespace {
+/**
+ * @brief Sorted distinct values of string (the code of a value is its
+ * position)
+ */
+std::pmr::vector<uint32_t> distinct_values(const std::vector<uint32_t>& string,
+                                           std::pmr::memory_resource* resource) {
+  // sorted off resource, only the distinct values are copied on it
+  std::vector<uint32_t> res(string.begin(), string.end());
+  std::sort(res.begin(), res.end());
+  res.erase(std::unique(res.begin(), res.end()), res.end());
+  return std::pmr::vector<uint32_t>(res.begin(), res.end(), resource);
+}
+
+/**
+ * @brief Bits of a code among sigma values, ceil(log(sigma))
+ */
+std::size_t code_bits(std::size_t sigma) {
+  std::size_t res = 0;
+  while ((uint64_t{1} << res) < sigma) ++res;
+  return res;
+}
+}  // namespace
+
+template <typename RankSupport>
+BasicIntWaveletMatrix<RankSupport>::BasicIntWaveletMatrix(
+    const std::vector<uint32_t>& string, std::pmr::memory_resource* resource)
+    : string_size_(string.size()),
+      alphabet_(distinct_values(string, resource)),
+      depth_(code_bits(alphabet_.size())),
+      matrix_(encode(string), resource) {}
+
+template <typename RankSupport>
+WordVector BasicIntWaveletMatrix<RankSupport>::encode(
+    const std::vector<uint32_t>& string) const {
+  // no level to index: the matrix is left empty (still on the resource)
+  if (depth_ == 0) return WordVector(0, 1);
+  WordVectorBuilder codes(depth_);
+  codes.reserve(string.size());
+  for (uint32_t value : string) codes.push_back(code(value));
+  return codes.build();
+}
+
+template <typename RankSupport>
+std::size_t BasicIntWaveletMatrix<RankSupport>::code(
+    const uint32_t character) const {
+  auto it = std::lower_bound(alphabet_.begin(), alphabet_.end(), character);
+  if (it == alphabet_.end() || *it != character) return alphabet_.size();
+  return it - alphabet_.begin();
+}
+
+template <typename RankSupport>
+uint32_t BasicIntWaveletMatrix<RankSupport>::acces(std::size_t indx) const {
+  assert(indx < string_size_ && "acces out of range");
+  if (depth_ == 0) return alphabet_[0];
+  return alphabet_[matrix_.acces(indx)];
+}
+
+template <typename RankSupport>
+std::size_t BasicIntWaveletMatrix<RankSupport>::rank(const uint32_t character,
+                                                     std::size_t pos) const {
+  assert(pos < string_size_ && "rank out of range");
+  std::size_t c = code(character);
+  if (c == alphabet_.size()) return 0;
+  if (depth_ == 0) return pos + 1;
+  return matrix_.rank(c, pos);
+}
+
+template <typename RankSupport>
+std::size_t BasicIntWaveletMatrix<RankSupport>::select(
+    const uint32_t character, std::size_t count) const {
+  std::size_t c = code(character);
+  if (count == 0 || c == alphabet_.size()) return -1;
+  if (depth_ == 0) return count <= string_size_ ? count - 1 : -1;
+  return matrix_.select(c, count);
+}
+
+template <typename RankSupport>
+uint32_t BasicIntWaveletMatrix<RankSupport>::quantile(std::size_t start,
+                                                      std::size_t end,
+                                                      std::size_t k) const {
+  assert(start <= end && end < string_size_ && k <= end - start &&
+         "quantile out of range");
+  if (depth_ == 0) return alphabet_[0];
+  return alphabet_[matrix_.quantile(start, end, k)];
+}
+
+template <typename RankSupport>
+std::size_t BasicIntWaveletMatrix<RankSupport>::range_freq(
+    std::size_t start, std::size_t end, uint32_t low, uint32_t high) const {
+  if (start > end || low > high) return 0;
+  // [low, high] is the range of codes [low_code, high_code)
+  std::size_t low_code =
+      std::lower_bound(alphabet_.begin(), alphabet_.end(), low) -
+      alphabet_.begin();
+  std::size_t high_code =
+      std::upper_bound(alphabet_.begin(), alphabet_.end(), high) -
+      alphabet_.begin();
+  if (low_code >= high_code) return 0;
+  if (depth_ == 0) return end + 1 - start;
+  return matrix_.range_freq(start, end, low_code, high_code - 1);
+}
+
+template <typename RankSupport>
+std::size_t BasicIntWaveletMatrix<RankSupport>::getStringSize() const {
+  return string_size_;
+}
+
+template <typename RankSupport>
+std::size_t BasicIntWaveletMatrix<RankSupport>::getMatrixDepth() const {
+  return depth_;
+}
+
+template <typename RankSupport>
+std::size_t BasicIntWaveletMatrix<RankSupport>::getAlphabetSize() const {
+  return alphabet_.size();
+}
+
+// instantiations for the available rank helpers
+template class BasicIntWaveletMatrix<utils::RankHelper>;
+template class BasicIntWaveletMatrix<utils::InterleavedRankHelper>;
+
+}  // namespace utils
+}  // namespace unialgo
@@ -0,0 +1,144 @@
+#ifndef UNIALGO_UTILS_INT_WAVELET_MATRIX_
+#define UNIALGO_UTILS_INT_WAVELET_MATRIX_
+
+#include <stdint.h>  // uint32_t, uint64_t
+
+#include <memory_resource>  // std::pmr::memory_resource
+#include <vector>           // std::vector, std::pmr::vector
+
+#include "unialgo/utils/bitvector/rankHelper.hpp"
+#include "unialgo/utils/bitvector/rankInterleaved.hpp"
+#include "unialgo/utils/bitvector/wordVector.hpp"
+#include "unialgo/utils/waveletMatrix.hpp"
+
+namespace unialgo {
+namespace utils {
+
+/**
+ * @brief Wavelet matrix over a sequence of 32-bit integers (word ids,
+ * document ids, ...)
+ *
+ * The values are remapped to their rank among the distinct values of the
+ * sequence, so the matrix has ceil(log(sigma)) levels for sigma distinct
+ * values whatever their magnitude (ids up to 2^32 - 1 with 1000 distinct
+ * values take 10 levels). The remapping keeps the order of the values, the
+ * order based queries (quantile, range_freq) work on the codes.
+ *
+ * The codes are indexed by a BasicWaveletMatrix with ceil(log(sigma)) bits
+ * per value, values are translated with a binary search in the alphabet on
+ * the way in and alphabet[code] on the way out
+ *
+ * @tparam RankSupport rank/select structure built on every level (see
+ * BasicWaveletMatrix)
+ */
+template <typename RankSupport>
+class BasicIntWaveletMatrix {
+ public:
+  BasicIntWaveletMatrix() : string_size_(0), depth_(0) {}
+
+  /**
+   * @brief Construct a new Basic Int Wavelet Matrix object
+   *
+   * @param string sequence to index
+   * @param resource memory resource of the levels, their rank support and
+   * the alphabet
+   */
+  BasicIntWaveletMatrix(
+      const std::vector<uint32_t>& string,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  ~BasicIntWaveletMatrix() = default;
+
+  BasicIntWaveletMatrix(const BasicIntWaveletMatrix& other) = default;
+  BasicIntWaveletMatrix(BasicIntWaveletMatrix&& other) noexcept = default;
+
+  BasicIntWaveletMatrix& operator=(const BasicIntWaveletMatrix& other) =
+      default;
+  BasicIntWaveletMatrix& operator=(BasicIntWaveletMatrix&& other) = default;
+
+  /**
+   * @brief Access value in string
+   *
+   * This is O(log(sigma))
+   *
+   * @param indx value to access
+   * @return uint32_t string[indx]
+   */
+  uint32_t acces(std::size_t indx) const;
+
+  /**
+   * @brief Rank of charachter up to position
+   *
+   * This is O(log(sigma)) (plus a binary search in the alphabet)
+   *
+   * @param character character to count occurrences
+   * @param pos position to end count (included)
+   * @return std::size_t # of occ in [0, pos] (0 if not in the string)
+   */
+  std::size_t rank(const uint32_t character, std::size_t pos) const;
+
+  /**
+   * @brief Position of the count-th occurrence of character
+   *
+   * @param character character to search
+   * @param count i-th occurrence searched (starting from 1)
+   * @return std::size_t position of the occurrence, -1 if not present
+   */
+  std::size_t select(const uint32_t character, std::size_t count) const;
+
+  /**
+   * @brief k-th smallest value in string[start, end]
+   *
+   * @param start first position of the range
+   * @param end last position of the range (included)
+   * @param k rank of the value (0 = minimum, must be <= end - start)
+   * @return uint32_t k-th smallest value
+   */
+  uint32_t quantile(std::size_t start, std::size_t end, std::size_t k) const;
+
+  /**
+   * @brief Number of values in [low, high] in string[start, end]
+   *
+   * @param start first position of the range
+   * @param end last position of the range (included)
+   * @param low smallest value counted
+   * @param high biggest value counted
+   * @return std::size_t # of positions i in [start, end] with
+   * low <= string[i] <= high
+   */
+  std::size_t range_freq(std::size_t start, std::size_t end, uint32_t low,
+                         uint32_t high) const;
+
+  std::size_t getStringSize() const;
+
+  /**
+   * @brief Number of levels, ceil(log(sigma)) (0 for a single value)
+   */
+  std::size_t getMatrixDepth() const;
+
+  /**
+   * @brief Number of distinct values (sigma)
+   */
+  std::size_t getAlphabetSize() const;
+
+ private:
+  // codes of the values of string, ceil(log(sigma)) bits each
+  unialgo::utils::WordVector encode(const std::vector<uint32_t>& string) const;
+  // code of character, alphabet_.size() if not in the string
+  std::size_t code(const uint32_t character) const;
+
+  std::size_t string_size_;              // size of the string
+  std::pmr::vector<uint32_t> alphabet_;  // sorted values
+  std::size_t depth_;                    // number of levels
+  // matrix of the codes (empty if depth_ == 0, every value is alphabet_[0])
+  BasicWaveletMatrix<RankSupport> matrix_;
+};  // class BasicIntWaveletMatrix
+
+using IntWaveletMatrix = BasicIntWaveletMatrix<unialgo::utils::RankHelper>;
+using InterleavedIntWaveletMatrix =
+    BasicIntWaveletMatrix<unialgo::utils::InterleavedRankHelper>;
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_INT_WAVELET_MATRIX_
@@ -0,0 +1,124 @@
+#ifndef UNIALGO_UTILS_QUERY_EXECUTOR_
+#define UNIALGO_UTILS_QUERY_EXECUTOR_
+
+#include <stdint.h>  // uint64_t
+
+#include <algorithm>  // std::min
+#include <vector>     // std::vector
+
+#include "unialgo/utils/bitvector/wordVector.hpp"
+#include "unialgo/utils/threadPool.hpp"
+
+/**
+ * @file This file contains an executor of query batches on a ThreadPool
+ *
+ * A single rank is latency bound, a batch of independent queries is split in
+ * tasks of grain queries and the tasks are run by the workers of the pool
+ * (stealing from each other when the tasks take different times). Results
+ * are written at the index of their query, so they are in submission order:
+ *
+ *   utils::ThreadPool pool(8);
+ *   utils::QueryExecutor<utils::WaveletMatrix> executor(wm, pool);
+ *   executor.rank(chars, positions, n, out);
+ *
+ *   utils::QueryExecutor<pattern::Bwt> fm(bwt, pool);
+ *   std::vector<std::size_t> counts = fm.count(patterns);
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+/**
+ * @brief Class QueryExecutor
+ * runs batches of access / rank / count queries on an index with a pool
+ *
+ * @tparam Index queried structure (ex: utils::WaveletMatrix, pattern::Bwt).
+ * access uses Index::access_batch, Index::acces or Index::operator[], rank
+ * uses Index::rank_batch or Index::rank, count uses Index::count
+ */
+template <typename Index>
+class QueryExecutor {
+ public:
+  static constexpr std::size_t grain = 2048;     // access / rank per task
+  static constexpr std::size_t count_grain = 16;  // patterns per task
+
+  /**
+   * @brief Construct a new Query Executor object
+   *
+   * Important: index and pool must outlive the executor
+   */
+  QueryExecutor(const Index& index, ThreadPool& pool)
+      : index_(index), pool_(pool) {}
+
+  /**
+   * @brief out[i] = index[pos[i]] for i in [0, n)
+   */
+  void access(const std::size_t* pos, std::size_t n, uint64_t* out) const {
+    forChunks(n, grain, [&](std::size_t begin, std::size_t end) {
+      if constexpr (requires { index_.access_batch(pos, n, out); }) {
+        index_.access_batch(pos + begin, end - begin, out + begin);
+      } else {
+        for (std::size_t i = begin; i < end; ++i) {
+          if constexpr (requires { index_.acces(pos[i]); })
+            out[i] = index_.acces(pos[i]);
+          else
+            out[i] = index_[pos[i]];
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief out[i] = rank of chars[i] up to pos[i] (included) for i in [0, n)
+   */
+  void rank(const uint64_t* chars, const std::size_t* pos, std::size_t n,
+            std::size_t* out) const {
+    forChunks(n, grain, [&](std::size_t begin, std::size_t end) {
+      if constexpr (requires { index_.rank_batch(chars, pos, n, out); }) {
+        index_.rank_batch(chars + begin, pos + begin, end - begin,
+                          out + begin);
+      } else {
+        for (std::size_t i = begin; i < end; ++i)
+          out[i] = index_.rank(chars[i], pos[i]);
+      }
+    });
+  }
+
+  /**
+   * @brief Occurrences of every pattern (res[i] = index.count(patterns[i]))
+   */
+  std::vector<std::size_t> count(
+      const std::vector<unialgo::utils::WordVector>& patterns) const {
+    std::vector<std::size_t> res(patterns.size());
+    forChunks(patterns.size(), count_grain,
+              [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                  res[i] = index_.count(patterns[i]);
+              });
+    return res;
+  }
+
+ private:
+  /**
+   * @brief Runs f(begin, end) on chunks of chunk queries of [0, n)
+   */
+  template <typename F>
+  void forChunks(std::size_t n, std::size_t chunk, F f) const {
+    if (n <= chunk) {
+      if (n) f(0, n);
+      return;
+    }
+    pool_.parallel_for((n + chunk - 1) / chunk, [&](std::size_t task) {
+      f(task * chunk, std::min(n, (task + 1) * chunk));
+    });
+  }
+
+  const Index& index_;  // queried structure
+  ThreadPool& pool_;    // workers running the tasks
+};
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_QUERY_EXECUTOR_
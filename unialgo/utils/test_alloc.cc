@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>  // std::uintptr_t
+#include <vector>   // std::pmr::vector
+
+#include "unialgo/utils/alignedAlloc.h"
+#include "unialgo/utils/bitvector/arena.hpp"
+
+namespace {
+
+using unialgo::utils::AllocOptions;
+using unialgo::utils::NumaPolicy;
+using unialgo::utils::PagePolicy;
+
+TEST(TestingAlloc, Policies) {
+  // every policy gives usable memory (hints fall back to normal pages)
+  for (auto pages : {PagePolicy::standard, PagePolicy::transparent_huge,
+                     PagePolicy::huge_tlb}) {
+    for (auto numa :
+         {NumaPolicy::local, NumaPolicy::bind, NumaPolicy::interleave}) {
+      AllocOptions options{pages, numa, 0};
+      std::size_t n = 3000;
+      auto* data = static_cast<uint64_t*>(
+          unialgo::utils::aligned_alloc(64, n * sizeof(uint64_t), options));
+      ASSERT_NE(data, nullptr);
+      EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % 64, 0);
+      if (pages != PagePolicy::standard) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) %
+                      unialgo::utils::huge_page_size,
+                  0);
+      }
+      for (std::size_t i = 0; i < n; ++i) data[i] = i * i;
+      for (std::size_t i = 0; i < n; ++i) EXPECT_EQ(data[i], i * i);
+      unialgo::utils::aligned_free(data, n * sizeof(uint64_t), options);
+    }
+  }
+}
+
+TEST(TestingAlloc, AlignmentOverPageSize) {
+  // alignments above the page size are kept for every policy
+  for (auto pages : {PagePolicy::standard, PagePolicy::transparent_huge,
+                     PagePolicy::huge_tlb}) {
+    AllocOptions options{pages, NumaPolicy::bind, 0};
+    std::size_t alignment = 2 * unialgo::utils::huge_page_size;
+    std::size_t bytes = 10000;
+    auto* data = static_cast<unsigned char*>(
+        unialgo::utils::aligned_alloc(alignment, bytes, options));
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % alignment, 0);
+    for (std::size_t i = 0; i < bytes; ++i) data[i] = i % 251;
+    for (std::size_t i = 0; i < bytes; ++i) EXPECT_EQ(data[i], i % 251);
+    unialgo::utils::aligned_free(data, bytes, options);
+  }
+
+  unialgo::utils::PageResource resource({PagePolicy::standard,
+                                         NumaPolicy::interleave});
+  void* ptr = resource.allocate(100, 8192);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % 8192, 0);
+  resource.deallocate(ptr, 100, 8192);
+}
+
+TEST(TestingAlloc, PageResource) {
+  unialgo::utils::PageResource huge(
+      {PagePolicy::transparent_huge, NumaPolicy::interleave});
+  EXPECT_EQ(huge.options().pages, PagePolicy::transparent_huge);
+  EXPECT_TRUE(huge.is_equal(huge));
+  EXPECT_FALSE(huge.is_equal(*std::pmr::get_default_resource()));
+
+  // allocations are mapped on their own, aligned to huge pages
+  std::size_t bytes = 5000;
+  auto* first = static_cast<unsigned char*>(huge.allocate(bytes, 64));
+  auto* second = static_cast<unsigned char*>(huge.allocate(bytes, 64));
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) %
+                unialgo::utils::huge_page_size,
+            0);
+  for (std::size_t i = 0; i < bytes; ++i) first[i] = second[i] = i % 251;
+  for (std::size_t i = 0; i < bytes; ++i) EXPECT_EQ(first[i], i % 251);
+  huge.deallocate(first, bytes, 64);
+  huge.deallocate(second, bytes, 64);
+
+  // as upstream of an Arena
+  unialgo::utils::Arena arena(0, &huge);
+  std::pmr::vector<uint64_t> values(1000, 7, &arena);
+  EXPECT_GT(arena.used(), 0);
+  for (uint64_t value : values) EXPECT_EQ(value, 7);
+}
+
+}  // namespace
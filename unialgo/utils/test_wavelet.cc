@@ -1,12 +1,26 @@
 #include <gtest/gtest.h>
 
-#include <algorithm>  // std::sort
+#include <algorithm>        // std::sort
 #include <cmath>
-#include <memory>   // std::shared_ptr
-#include <utility>  // std::swap
+#include <cstdint>          // uint64_t
+#include <map>              // std::map
+#include <memory>           // std::shared_ptr
+#include <memory_resource>  // std::pmr::memory_resource
+#include <random>           // std::mt19937
+#include <set>              // std::set
+#include <typeinfo>         // typeid
+#include <utility>          // std::swap
+#include <vector>           // std::vector
 
 #include "unialgo/pattern/wordVecMatching.hpp"
+#include "unialgo/utils/alignedAlloc.h"
+#include "unialgo/utils/bitvector/arena.hpp"
 #include "unialgo/utils/bitvector/bitVectors.hpp"
+#include "unialgo/utils/dynamicWaveletMatrix.hpp"
+#include "unialgo/utils/huffmanWaveletMatrix.hpp"
+#include "unialgo/utils/intWaveletMatrix.hpp"
+#include "unialgo/utils/queryExecutor.hpp"
+#include "unialgo/utils/threadPool.hpp"
 #include "unialgo/utils/waveletMatrix.hpp"
 
 namespace {
@@ -240,4 +254,627 @@ TEST(TestingWavelet, CopyIntoVector) {
   }
 }
 
-}  // namespace
\ No newline at end of file
+TEST(TestingWavelet, InterleavedRank) {
+  std::string s =
+      "abcdegfaedcfbgeafdcebgafdecgabfcdegabfcdegabcdegfabcdegfabcfedgabcfdegbc"
+      "degaedcfba";
+
+  auto alph = unialgo::pattern::GetAlphabet(s);
+  auto wv = unialgo::pattern::StringToBitVector(s, alph);
+
+  unialgo::utils::InterleavedWaveletMatrix mat(wv);
+  unialgo::utils::WaveletMatrix expected(wv);
+  EXPECT_EQ(mat.getStringSize(), wv.size());
+
+  for (std::size_t i = 0; i < wv.size(); ++i)
+    EXPECT_EQ(mat.acces(i), wv[i].getValue());
+  for (auto c : alph) {
+    for (std::size_t i = 0; i < wv.size(); ++i)
+      EXPECT_EQ(mat.rank(c.second, i), expected.rank(c.second, i));
+  }
+
+  // copies keep their own lines
+  unialgo::utils::InterleavedWaveletMatrix copy(mat);
+  mat = unialgo::utils::InterleavedWaveletMatrix();
+  for (std::size_t i = 0; i < wv.size(); ++i)
+    EXPECT_EQ(copy.acces(i), wv[i].getValue());
+}
+
+TEST(TestingWavelet, CompressedRank) {
+  std::string s =
+      "aaaaaaaaaaaaaaaaaaaabaaaaaaaaaaaaaaaaaaacaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaadaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa";
+
+  auto alph = unialgo::pattern::GetAlphabet(s);
+  auto wv = unialgo::pattern::StringToBitVector(s, alph);
+
+  unialgo::utils::WaveletMatrix expected(wv);
+  unialgo::utils::RRRWaveletMatrix rrr(wv);
+  unialgo::utils::EliasFanoWaveletMatrix elias_fano(wv);
+  for (std::size_t i = 0; i < wv.size(); ++i) {
+    EXPECT_EQ(rrr.acces(i), wv[i].getValue());
+    EXPECT_EQ(elias_fano.acces(i), wv[i].getValue());
+  }
+  for (auto c : alph) {
+    for (std::size_t i = 0; i < wv.size(); ++i) {
+      EXPECT_EQ(rrr.rank(c.second, i), expected.rank(c.second, i));
+      EXPECT_EQ(elias_fano.rank(c.second, i), expected.rank(c.second, i));
+    }
+  }
+
+  // copies keep their own compressed bits
+  unialgo::utils::RRRWaveletMatrix copy(rrr);
+  rrr = unialgo::utils::RRRWaveletMatrix();
+  for (std::size_t i = 0; i < wv.size(); ++i)
+    EXPECT_EQ(copy.acces(i), wv[i].getValue());
+}
+
+// Testing every level of HybridWaveletMatrix takes its smallest encoding
+TEST(TestingWavelet, HybridLevels) {
+  // values almost always < 16: the 4 high levels are almost all 0s
+  // (Elias-Fano), the 4 low ones are random bits (RRR or plain)
+  std::mt19937 gen(13);
+  std::size_t n = 1 << 16;
+  unialgo::utils::WordVector wv(n, 8);
+  for (std::size_t i = 0; i < n; ++i)
+    wv[i] = gen() % 200 == 0 ? gen() % 256 : gen() % 16;
+
+  unialgo::utils::HybridWaveletMatrix hybrid(wv);
+  unialgo::utils::InterleavedWaveletMatrix plain(wv);
+  unialgo::utils::RRRWaveletMatrix rrr(wv);
+  unialgo::utils::EliasFanoWaveletMatrix elias_fano(wv);
+  EXPECT_LT(hybrid.GetSizeInBits(), plain.GetSizeInBits());
+  EXPECT_LT(hybrid.GetSizeInBits(), rrr.GetSizeInBits());
+  EXPECT_LT(hybrid.GetSizeInBits(), elias_fano.GetSizeInBits());
+
+  for (std::size_t i = 0; i < n; i += 7) {
+    ASSERT_EQ(hybrid.acces(i), wv[i].getValue());
+    ASSERT_EQ(hybrid.rank(wv[i], i), plain.rank(wv[i], i));
+  }
+  for (uint64_t c : {0, 9, 15, 100, 255})
+    for (std::size_t count = 1; count < 50; count += 3)
+      ASSERT_EQ(hybrid.select(c, count), plain.select(c, count));
+}
+
+TEST(TestingWavelet, OnArena) {
+  std::string s = "476532101417476532101417";
+
+  auto alph = unialgo::pattern::GetAlphabet(s);
+  auto wv = unialgo::pattern::StringToBitVector(s, alph);
+
+  unialgo::utils::Arena arena(1 << 12);
+  unialgo::utils::WaveletMatrix expected(wv);
+  unialgo::utils::WaveletMatrix mat(wv, &arena);
+  EXPECT_EQ(arena.numChunks(), 1);
+  EXPECT_GT(arena.used(), 0);
+  for (std::size_t i = 0; i < wv.size(); ++i) {
+    EXPECT_EQ(mat.acces(i), wv[i].getValue());
+    for (auto c : alph)
+      EXPECT_EQ(mat.rank(c.second, i), expected.rank(c.second, i));
+  }
+}
+
+// counts the bytes allocated and not yet freed
+class LiveResource : public std::pmr::memory_resource {
+ public:
+  std::size_t live = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    live += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    live -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+
+// builds and moves a Matrix on an arena: nothing is left on the default
+// resource (construction buffers are freed) and moves between matrices on
+// the arena take the buffers over without allocating
+template <typename Matrix, typename String>
+void checkOnArena(const String& string, const std::vector<uint64_t>& values) {
+  unialgo::utils::Arena arena;
+  LiveResource heap;
+  std::pmr::memory_resource* previous = std::pmr::set_default_resource(&heap);
+  {
+    Matrix assigned(String(), &arena);
+    Matrix mat(string, &arena);
+    EXPECT_EQ(heap.live, 0);
+    std::size_t used = arena.used();
+    Matrix moved(std::move(mat));
+    EXPECT_EQ(arena.used(), used);
+    assigned = std::move(moved);
+    EXPECT_EQ(arena.used(), used);
+    EXPECT_EQ(heap.live, 0);
+    std::pmr::set_default_resource(previous);
+    for (std::size_t i = 0; i < values.size(); ++i)
+      EXPECT_EQ(assigned.acces(i), values[i]);
+
+    // onto a matrix of another resource
+    Matrix on_heap;
+    on_heap = std::move(assigned);
+    for (std::size_t i = 0; i < values.size(); ++i)
+      EXPECT_EQ(on_heap.acces(i), values[i]);
+  }
+  std::pmr::set_default_resource(previous);
+}
+
+TEST(TestingWavelet, EverythingOnArena) {
+  std::mt19937 gen(16);
+  std::size_t n = 3000;
+  unialgo::utils::WordVector wv(n, 6);
+  std::vector<uint32_t> ids(n);
+  std::vector<uint64_t> values(n);
+  std::vector<uint64_t> id_values(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    // skewed, so that the hybrid levels are not all plain
+    values[i] = gen() % 8 ? gen() % 4 : gen() % 64;
+    wv[i] = values[i];
+    ids[i] = id_values[i] = gen() % 100 * 1000;
+  }
+  checkOnArena<unialgo::utils::WaveletMatrix>(wv, values);
+  checkOnArena<unialgo::utils::InterleavedWaveletMatrix>(wv, values);
+  checkOnArena<unialgo::utils::RRRWaveletMatrix>(wv, values);
+  checkOnArena<unialgo::utils::EliasFanoWaveletMatrix>(wv, values);
+  checkOnArena<unialgo::utils::HybridWaveletMatrix>(wv, values);
+  checkOnArena<unialgo::utils::HuffmanWaveletMatrix>(wv, values);
+  checkOnArena<unialgo::utils::InterleavedHuffmanWaveletMatrix>(wv, values);
+  checkOnArena<unialgo::utils::IntWaveletMatrix>(ids, id_values);
+  checkOnArena<unialgo::utils::InterleavedIntWaveletMatrix>(ids, id_values);
+}
+
+// an Arena holds what a Matrix keeps alive after its construction (plus
+// alignment padding): temporaries are built off the arena
+template <typename Matrix, typename String>
+void checkArenaUsage(const String& string) {
+  LiveResource live;
+  unialgo::utils::Arena arena;
+  Matrix on_live(string, &live);
+  Matrix on_arena(string, &arena);
+  EXPECT_GT(live.live, 0);
+  EXPECT_LE(arena.used(), live.live + 1024) << typeid(Matrix).name();
+}
+
+TEST(TestingWavelet, ArenaHoldsOnlyLiveBytes) {
+  std::mt19937 gen(17);
+  std::size_t n = 100000;
+  unialgo::utils::WordVector wv(n, 8);
+  for (std::size_t i = 0; i < n; ++i) {
+    // skewed, so that the hybrid levels are not all plain
+    wv[i] = gen() % 8 ? gen() % 4 : gen() % 256;
+  }
+  checkArenaUsage<unialgo::utils::WaveletMatrix>(wv);
+  checkArenaUsage<unialgo::utils::InterleavedWaveletMatrix>(wv);
+  checkArenaUsage<unialgo::utils::RRRWaveletMatrix>(wv);
+  checkArenaUsage<unialgo::utils::EliasFanoWaveletMatrix>(wv);
+  checkArenaUsage<unialgo::utils::HybridWaveletMatrix>(wv);
+  checkArenaUsage<unialgo::utils::HuffmanWaveletMatrix>(wv);
+  checkArenaUsage<unialgo::utils::InterleavedHuffmanWaveletMatrix>(wv);
+
+  std::vector<uint32_t> ids(n);
+  for (auto& id : ids) id = gen() % 1000 * 1000;
+  checkArenaUsage<unialgo::utils::IntWaveletMatrix>(ids);
+  checkArenaUsage<unialgo::utils::InterleavedIntWaveletMatrix>(ids);
+}
+
+TEST(TestingWavelet, OnHugePages) {
+  using unialgo::utils::NumaPolicy;
+  using unialgo::utils::PagePolicy;
+
+  std::string s = "476532101417476532101417";
+  auto alph = unialgo::pattern::GetAlphabet(s);
+  auto wv = unialgo::pattern::StringToBitVector(s, alph);
+
+  unialgo::utils::PageResource huge(
+      {PagePolicy::transparent_huge, NumaPolicy::interleave});
+  unialgo::utils::Arena arena(0, &huge);
+  unialgo::utils::WaveletMatrix expected(wv);
+  unialgo::utils::WaveletMatrix direct(wv, &huge);
+  unialgo::utils::WaveletMatrix pooled(wv, &arena);
+  for (std::size_t i = 0; i < wv.size(); ++i) {
+    EXPECT_EQ(direct.acces(i), wv[i].getValue());
+    EXPECT_EQ(pooled.acces(i), wv[i].getValue());
+    for (auto c : alph) {
+      EXPECT_EQ(direct.rank(c.second, i), expected.rank(c.second, i));
+      EXPECT_EQ(pooled.rank(c.second, i), expected.rank(c.second, i));
+    }
+  }
+}
+
+template <typename Matrix>
+void checkBatches(const unialgo::utils::WordVector& wv) {
+  Matrix mat(wv);
+  std::mt19937 gen(3);
+  // more queries than a batch and a partial last batch
+  std::size_t n = Matrix::batch_size * 3 + 7;
+  std::vector<std::size_t> pos(n);
+  std::vector<uint64_t> chars(n);
+  for (std::size_t q = 0; q < n; ++q) {
+    pos[q] = gen() % wv.size();
+    chars[q] = gen() % (uint64_t{1} << wv.getWordSize());
+  }
+
+  std::vector<uint64_t> values(n);
+  mat.access_batch(pos.data(), n, values.data());
+  std::vector<std::size_t> ranks(n);
+  mat.rank_batch(chars.data(), pos.data(), n, ranks.data());
+  for (std::size_t q = 0; q < n; ++q) {
+    EXPECT_EQ(values[q], wv[pos[q]].getValue());
+    EXPECT_EQ(ranks[q], mat.rank(chars[q], pos[q]));
+  }
+}
+
+TEST(TestingWavelet, Batches) {
+  std::mt19937 gen(5);
+  std::string s;
+  for (std::size_t i = 0; i < 5000; ++i) s.push_back('a' + gen() % 20);
+  auto alph = unialgo::pattern::GetAlphabet(s);
+  auto wv = unialgo::pattern::StringToBitVector(s, alph);
+
+  checkBatches<unialgo::utils::WaveletMatrix>(wv);
+  checkBatches<unialgo::utils::InterleavedWaveletMatrix>(wv);
+  checkBatches<unialgo::utils::RRRWaveletMatrix>(wv);
+  checkBatches<unialgo::utils::EliasFanoWaveletMatrix>(wv);
+  checkBatches<unialgo::utils::HybridWaveletMatrix>(wv);
+}
+
+TEST(TestingWavelet, ParallelConstruction) {
+  // chunks of several threads, the last one partial
+  std::size_t n = unialgo::utils::WaveletMatrix::min_per_thread * 3 + 1234;
+  unialgo::utils::WordVector wv(n, 7);
+  std::mt19937 gen(9);
+  for (std::size_t i = 0; i < n; ++i) wv[i] = gen() % 100;
+
+  unialgo::utils::WaveletMatrix single(wv);
+  unialgo::utils::WaveletMatrix parallel(
+      wv, std::pmr::get_default_resource(), 4);
+  EXPECT_EQ(parallel.getStringSize(), n);
+  for (std::size_t i = 0; i < n; ++i)
+    EXPECT_EQ(parallel.acces(i), wv[i].getValue());
+  for (std::size_t q = 0; q < 2000; ++q) {
+    uint64_t c = gen() % 128;
+    std::size_t pos = gen() % n;
+    EXPECT_EQ(parallel.rank(c, pos), single.rank(c, pos));
+  }
+  // values straddling the words of the packed buffers, and whole words
+  for (uint8_t word_size : {13, 64}) {
+    unialgo::utils::WordVector wide(n, word_size);
+    std::mt19937_64 gen64(word_size);
+    for (std::size_t i = 0; i < n; ++i) wide[i] = gen64();
+    unialgo::utils::WaveletMatrix mat(
+        wide, std::pmr::get_default_resource(), 3);
+    for (std::size_t i = 0; i < n; i += 97)
+      EXPECT_EQ(mat.acces(i), wide[i].getValue());
+  }
+  // a single value per level, n < 64 and n = 0
+  for (std::size_t size : {0, 1, 5, 63, 64, 65}) {
+    unialgo::utils::WordVector small(size, 3);
+    for (std::size_t i = 0; i < size; ++i) small[i] = i % 3 == 0 ? 5 : 2;
+    unialgo::utils::WaveletMatrix mat(small);
+    for (std::size_t i = 0; i < size; ++i)
+      EXPECT_EQ(mat.acces(i), small[i].getValue());
+  }
+}
+
+template <typename Matrix>
+void checkRangeQueries(const unialgo::utils::WordVector& wv) {
+  using ValueCount = typename Matrix::ValueCount;
+  Matrix mat(wv);
+  std::size_t n = wv.size();
+  uint64_t sigma = uint64_t{1} << wv.getWordSize();
+
+  // select against a scan
+  for (uint64_t c = 0; c < sigma; ++c) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      if (wv[i].getValue() == c) {
+        EXPECT_EQ(mat.select(c, ++count), i);
+      }
+    }
+    EXPECT_EQ(mat.select(c, count + 1), static_cast<std::size_t>(-1));
+  }
+  EXPECT_EQ(mat.select(sigma, 1), static_cast<std::size_t>(-1));
+  EXPECT_EQ(mat.select(0, 0), static_cast<std::size_t>(-1));
+
+  std::mt19937 gen(13);
+  for (std::size_t q = 0; q < 200; ++q) {
+    std::size_t start = gen() % n;
+    std::size_t end = start + gen() % (n - start);
+    std::vector<uint64_t> values;
+    for (std::size_t i = start; i <= end; ++i)
+      values.push_back(wv[i].getValue());
+    std::vector<uint64_t> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::size_t k = gen() % sorted.size();
+    EXPECT_EQ(mat.quantile(start, end, k), sorted[k]);
+
+    uint64_t low = gen() % sigma;
+    uint64_t high = low + gen() % (sigma - low);
+    std::size_t freq = 0;
+    for (uint64_t v : values) freq += low <= v && v <= high;
+    EXPECT_EQ(mat.range_freq(start, end, low, high), freq);
+
+    std::map<uint64_t, std::size_t> counts;
+    for (uint64_t v : values) ++counts[v];
+    std::vector<ValueCount> list;
+    for (auto& [v, c] : counts)
+      if (low <= v && v <= high) list.emplace_back(v, c);
+    EXPECT_EQ(mat.range_list(start, end, low, high), list);
+
+    std::vector<ValueCount> by_count(counts.begin(), counts.end());
+    std::sort(by_count.begin(), by_count.end(),
+              [](const ValueCount& a, const ValueCount& b) {
+                return a.second != b.second ? a.second > b.second
+                                            : a.first < b.first;
+              });
+    std::size_t top = 1 + gen() % 5;
+    if (by_count.size() > top) by_count.resize(top);
+    EXPECT_EQ(mat.top_k(start, end, top), by_count);
+  }
+  EXPECT_EQ(mat.range_freq(0, n - 1, 0, static_cast<uint64_t>(-1)), n);
+  EXPECT_EQ(mat.range_list(0, n - 1).size(), mat.top_k(0, n - 1, n).size());
+  EXPECT_TRUE(mat.range_list(0, n - 1, sigma, sigma + 10).empty());
+}
+
+TEST(TestingWavelet, RangeQueries) {
+  std::mt19937 gen(17);
+  unialgo::utils::WordVector wv(700, 4);
+  // skewed values: frequencies differ for top_k
+  for (std::size_t i = 0; i < wv.size(); ++i)
+    wv[i] = (gen() % 16) * (gen() % 2);
+
+  checkRangeQueries<unialgo::utils::WaveletMatrix>(wv);
+  checkRangeQueries<unialgo::utils::InterleavedWaveletMatrix>(wv);
+  checkRangeQueries<unialgo::utils::RRRWaveletMatrix>(wv);
+  checkRangeQueries<unialgo::utils::EliasFanoWaveletMatrix>(wv);
+  checkRangeQueries<unialgo::utils::HybridWaveletMatrix>(wv);
+}
+
+TEST(TestingWavelet, HuffmanShaped) {
+  std::mt19937 gen(21);
+  // geometric frequencies: value v appears about n / 2^(v + 1) times
+  std::size_t n = 5000;
+  unialgo::utils::WordVector wv(n, 5);
+  for (std::size_t i = 0; i < n; ++i) {
+    uint64_t v = 0;
+    while (v < 31 && gen() % 2) ++v;
+    wv[i] = v;
+  }
+  std::map<uint64_t, std::size_t> counts;
+  for (std::size_t i = 0; i < n; ++i) ++counts[wv[i].getValue()];
+  double h0 = 0;
+  for (auto& [v, c] : counts) h0 -= c * std::log2(static_cast<double>(c) / n);
+
+  unialgo::utils::HuffmanWaveletMatrix huffman(wv);
+  unialgo::utils::WaveletMatrix expected(wv);
+  EXPECT_EQ(huffman.getStringSize(), n);
+  EXPECT_EQ(huffman.getMatrixDepth(), 5);
+  // about H0 bits per value (Huffman is within 1 bit of H0)
+  EXPECT_LT(huffman.getNumBits(), n * 5);
+  EXPECT_LE(huffman.getNumBits(), h0 + n);
+  EXPECT_GE(huffman.getNumBits(), h0);
+  EXPECT_LT(huffman.getCodeLength(0), huffman.getCodeLength(5));
+  EXPECT_EQ(huffman.getCodeLength(31), 0);
+
+  for (std::size_t i = 0; i < n; ++i)
+    EXPECT_EQ(huffman.acces(i), wv[i].getValue());
+  for (uint64_t c = 0; c < 32; ++c)
+    for (std::size_t i = 0; i < n; i += 7)
+      EXPECT_EQ(huffman.rank(c, i), expected.rank(c, i));
+
+  // copies rebuild their rank support, interleaved keeps its own bits
+  unialgo::utils::HuffmanWaveletMatrix copy(huffman);
+  huffman = unialgo::utils::HuffmanWaveletMatrix();
+  unialgo::utils::InterleavedHuffmanWaveletMatrix interleaved(wv);
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(copy.acces(i), wv[i].getValue());
+    EXPECT_EQ(interleaved.acces(i), wv[i].getValue());
+    EXPECT_EQ(copy.rank(wv[i], i), expected.rank(wv[i], i));
+  }
+
+  // a single distinct value still takes a level
+  unialgo::utils::WordVector same(10, 3);
+  for (std::size_t i = 0; i < same.size(); ++i) same[i] = 6;
+  unialgo::utils::HuffmanWaveletMatrix single(same);
+  EXPECT_EQ(single.getNumLevels(), 1);
+  for (std::size_t i = 0; i < same.size(); ++i) {
+    EXPECT_EQ(single.acces(i), 6);
+    EXPECT_EQ(single.rank(6, i), i + 1);
+  }
+}
+
+TEST(TestingWavelet, QueryExecutor) {
+  std::mt19937 gen(22);
+  std::size_t n = 20000;
+  unialgo::utils::WordVector wv(n, 6);
+  for (std::size_t i = 0; i < n; ++i) wv[i] = gen() % 64;
+  unialgo::utils::WaveletMatrix mat(wv);
+  unialgo::utils::HuffmanWaveletMatrix huffman(wv);
+
+  // several tasks per worker and a partial last task
+  std::size_t q = unialgo::utils::WaveletMatrix::batch_size * 200 + 13;
+  std::vector<std::size_t> pos(q);
+  std::vector<uint64_t> chars(q);
+  for (std::size_t i = 0; i < q; ++i) {
+    pos[i] = gen() % n;
+    chars[i] = gen() % 64;
+  }
+
+  unialgo::utils::ThreadPool pool(4);
+  EXPECT_EQ(pool.size(), 4);
+  unialgo::utils::QueryExecutor<unialgo::utils::WaveletMatrix> executor(mat,
+                                                                        pool);
+  unialgo::utils::QueryExecutor<unialgo::utils::HuffmanWaveletMatrix>
+      huffman_executor(huffman, pool);
+  std::vector<uint64_t> values(q), huffman_values(q);
+  std::vector<std::size_t> ranks(q), huffman_ranks(q);
+  executor.access(pos.data(), q, values.data());
+  executor.rank(chars.data(), pos.data(), q, ranks.data());
+  huffman_executor.access(pos.data(), q, huffman_values.data());
+  huffman_executor.rank(chars.data(), pos.data(), q, huffman_ranks.data());
+  for (std::size_t i = 0; i < q; ++i) {
+    EXPECT_EQ(values[i], wv[pos[i]].getValue());
+    EXPECT_EQ(huffman_values[i], values[i]);
+    EXPECT_EQ(ranks[i], mat.rank(chars[i], pos[i]));
+    EXPECT_EQ(huffman_ranks[i], ranks[i]);
+  }
+}
+
+TEST(TestingWavelet, WideValues) {
+  // values past 32 bits need the level masks to be 64-bit wide
+  std::mt19937_64 gen(23);
+  std::size_t n = 3000;
+  unialgo::utils::WordVector wv(n, 40);
+  for (std::size_t i = 0; i < n; ++i)
+    wv[i] = (gen() % 8) << 36 | (gen() & 0xff);
+  unialgo::utils::WaveletMatrix mat(wv);
+  std::map<uint64_t, std::size_t> counts;
+  for (std::size_t i = 0; i < n; ++i) {
+    uint64_t value = wv[i].getValue();
+    EXPECT_EQ(mat.acces(i), value);
+    EXPECT_EQ(mat.rank(value, i), ++counts[value]);
+  }
+}
+
+template <typename Matrix>
+void checkIntSequence(const std::vector<uint32_t>& seq, std::size_t depth) {
+  Matrix mat(seq);
+  std::size_t n = seq.size();
+  EXPECT_EQ(mat.getStringSize(), n);
+  EXPECT_EQ(mat.getMatrixDepth(), depth);
+
+  std::map<uint32_t, std::vector<std::size_t>> positions;
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(mat.acces(i), seq[i]);
+    positions[seq[i]].push_back(i);
+    EXPECT_EQ(mat.rank(seq[i], i), positions[seq[i]].size());
+  }
+  EXPECT_EQ(mat.getAlphabetSize(), positions.size());
+  for (auto& [value, pos] : positions) {
+    for (std::size_t k = 0; k < pos.size(); ++k)
+      EXPECT_EQ(mat.select(value, k + 1), pos[k]);
+    EXPECT_EQ(mat.select(value, pos.size() + 1), static_cast<std::size_t>(-1));
+  }
+
+  std::mt19937 gen(24);
+  for (std::size_t q = 0; q < 200; ++q) {
+    std::size_t start = gen() % n;
+    std::size_t end = start + gen() % (n - start);
+    std::vector<uint32_t> sorted(seq.begin() + start, seq.begin() + end + 1);
+    std::sort(sorted.begin(), sorted.end());
+    std::size_t k = gen() % sorted.size();
+    EXPECT_EQ(mat.quantile(start, end, k), sorted[k]);
+    uint32_t low = seq[gen() % n];
+    uint32_t high = low + gen() % (uint32_t{1} << 30);
+    if (high < low) high = -1;
+    std::size_t expected = std::count_if(
+        sorted.begin(), sorted.end(),
+        [&](uint32_t v) { return low <= v && v <= high; });
+    EXPECT_EQ(mat.range_freq(start, end, low, high), expected);
+  }
+}
+
+TEST(TestingWavelet, IntSequence) {
+  // 1000 ids spread over the 32 bits: 10 levels after the remap
+  std::mt19937 gen(25);
+  std::vector<uint32_t> ids(1000);
+  for (auto& id : ids) id = gen();
+  ids.back() = static_cast<uint32_t>(-1);
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  ASSERT_EQ(ids.size(), 1000);
+  std::vector<uint32_t> seq(5000);
+  for (auto& v : seq) v = ids[gen() % ids.size()];
+  for (uint32_t id : ids) seq[gen() % seq.size()] = id;
+  std::size_t sigma = std::set<uint32_t>(seq.begin(), seq.end()).size();
+  std::size_t depth = 0;
+  while ((std::size_t{1} << depth) < sigma) ++depth;
+  EXPECT_LE(depth, 10);
+
+  checkIntSequence<unialgo::utils::IntWaveletMatrix>(seq, depth);
+  checkIntSequence<unialgo::utils::InterleavedIntWaveletMatrix>(seq, depth);
+
+  // a single distinct value takes no level
+  checkIntSequence<unialgo::utils::IntWaveletMatrix>(
+      std::vector<uint32_t>(100, 123456789), 0);
+
+  unialgo::utils::IntWaveletMatrix mat(seq);
+  uint32_t missing = ids[0] + 1;
+  while (std::binary_search(ids.begin(), ids.end(), missing)) ++missing;
+  EXPECT_EQ(mat.rank(missing, seq.size() - 1), 0);
+  EXPECT_EQ(mat.select(missing, 1), static_cast<std::size_t>(-1));
+  unialgo::utils::IntWaveletMatrix copy(mat);
+  unialgo::utils::InterleavedIntWaveletMatrix interleaved(seq);
+  unialgo::utils::InterleavedIntWaveletMatrix moved(std::move(interleaved));
+  mat = unialgo::utils::IntWaveletMatrix();
+  EXPECT_EQ(mat.getStringSize(), 0);
+  for (std::size_t i = 0; i < seq.size(); ++i) {
+    EXPECT_EQ(copy.acces(i), seq[i]);
+    EXPECT_EQ(moved.acces(i), seq[i]);
+  }
+}
+
+// checks acces, rank and select of mat against the values in expected
+void checkDynamicMatrix(const unialgo::utils::DynamicWaveletMatrix& mat,
+                        const std::vector<uint64_t>& expected) {
+  ASSERT_EQ(mat.getStringSize(), expected.size());
+  std::map<uint64_t, std::size_t> counts;
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    uint64_t value = expected[i];
+    ASSERT_EQ(mat.acces(i), value);
+    EXPECT_EQ(mat.rank(value, i), ++counts[value]);
+    EXPECT_EQ(mat.select(value, counts[value]), i);
+  }
+  for (auto& [value, count] : counts)
+    EXPECT_EQ(mat.select(value, count + 1), static_cast<std::size_t>(-1));
+}
+
+TEST(TestingWavelet, Dynamic) {
+  std::mt19937 gen(26);
+  std::size_t n = 3000;
+  unialgo::utils::WordVector wv(n, 6);
+  std::vector<uint64_t> expected(n);
+  for (std::size_t i = 0; i < n; ++i) wv[i] = expected[i] = gen() % 50;
+
+  // same levels of the static matrix
+  unialgo::utils::DynamicWaveletMatrix mat(wv);
+  unialgo::utils::WaveletMatrix fixed(wv);
+  EXPECT_EQ(mat.getMatrixDepth(), 6);
+  for (std::size_t i = 0; i < n; i += 11)
+    EXPECT_EQ(mat.rank(i % 50, i), fixed.rank(i % 50, i));
+  checkDynamicMatrix(mat, expected);
+
+  for (std::size_t op = 0; op < 3000; ++op) {
+    std::size_t pos = gen() % (expected.size() + 1);
+    uint64_t value = gen() % 64;
+    if (op % 3 == 0) {
+      mat.insert(pos, value);
+      expected.insert(expected.begin() + pos, value);
+    } else if (pos == expected.size()) {
+      mat.push_back(value);
+      expected.push_back(value);
+    } else if (op % 3 == 1) {
+      EXPECT_EQ(mat.erase(pos), expected[pos]);
+      expected.erase(expected.begin() + pos);
+    } else {
+      mat.set(pos, value);
+      expected[pos] = value;
+    }
+  }
+  checkDynamicMatrix(mat, expected);
+
+  // built by appends only
+  unialgo::utils::DynamicWaveletMatrix appended(6);
+  for (uint64_t value : expected) appended.push_back(value);
+  checkDynamicMatrix(appended, expected);
+}
+
+}  // namespace
@@ -0,0 +1,168 @@
+#ifndef UNIALGO_UTILS_THREAD_POOL_
+#define UNIALGO_UTILS_THREAD_POOL_
+
+#include <algorithm>           // std::max
+#include <atomic>              // std::atomic
+#include <condition_variable>  // std::condition_variable
+#include <deque>               // std::deque
+#include <functional>          // std::function
+#include <mutex>               // std::mutex, std::lock_guard
+#include <thread>              // std::thread
+#include <vector>              // std::vector
+
+/**
+ * @file This file contains a work-stealing thread pool
+ *
+ * Every worker owns a deque of tasks: it takes its own tasks from the back
+ * and, when it runs out, steals from the front of the other deques, so
+ * workers finishing early take over the tasks of the slow ones.
+ * parallel_for deals the tasks round-robin and the calling thread runs tasks
+ * too while it waits:
+ *
+ *   utils::ThreadPool pool(8);
+ *   pool.parallel_for(num_chunks, [&](std::size_t chunk) { ... });
+ *
+ */
+
+namespace unialgo {
+namespace utils {
+
+class ThreadPool {
+ public:
+  /**
+   * @brief Construct a new Thread Pool object
+   *
+   * @param num_threads number of workers (at least 1)
+   */
+  explicit ThreadPool(
+      std::size_t num_threads = std::thread::hardware_concurrency())
+      : queues_(std::max<std::size_t>(1, num_threads)),
+        pending_(0),
+        stop_(false) {
+    for (std::size_t t = 0; t < queues_.size(); ++t)
+      workers_.emplace_back([this, t]() { work(t); });
+  }
+
+  /**
+   * @brief Runs the tasks left and joins the workers
+   */
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Number of workers
+   */
+  std::size_t size() const { return workers_.size(); }
+
+  /**
+   * @brief Runs f(i) for i in [0, num_tasks) on the workers and returns
+   * when every task is done (the caller runs tasks while waiting)
+   *
+   * @param num_tasks number of tasks
+   * @param f task, called once per index (concurrently)
+   */
+  template <typename F>
+  void parallel_for(std::size_t num_tasks, F f) {
+    if (num_tasks == 0) return;
+    Job job;
+    job.remaining = num_tasks;
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+      push(i % queues_.size(), [&job, &f, i]() {
+        f(i);
+        // the caller leaves (destroying job) only after this unlock
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (--job.remaining == 0) job.done.notify_all();
+      });
+    }
+    std::function<void()> task;
+    while (pop(0, task)) task();
+    std::unique_lock<std::mutex> lock(job.mutex);
+    job.done.wait(lock, [&job]() { return job.remaining == 0; });
+  }
+
+ private:
+  // tasks of a worker, the owner pops the back, thieves the front
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  // tasks of a parallel_for still running
+  struct Job {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t remaining;
+  };
+
+  void push(std::size_t queue, std::function<void()> task) {
+    {
+      // counted under the queue lock: a pop of the task (and its decrement)
+      // can not happen before the increment
+      std::lock_guard<std::mutex> lock(queues_[queue].mutex);
+      ++pending_;
+      queues_[queue].tasks.push_back(std::move(task));
+    }
+    // empty critical section: a worker checking pending_ is either before
+    // the check (and sees it) or already waiting (and gets notified)
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    wake_.notify_one();
+  }
+
+  /**
+   * @brief Takes a task from the back of queue self or steals one from the
+   * front of the others
+   *
+   * @return bool false if every queue is empty
+   */
+  bool pop(std::size_t self, std::function<void()>& task) {
+    for (std::size_t i = 0; i < queues_.size(); ++i) {
+      Queue& queue = queues_[(self + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty()) continue;
+      if (i == 0) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      --pending_;
+      return true;
+    }
+    return false;
+  }
+
+  void work(std::size_t self) {
+    std::function<void()> task;
+    while (true) {
+      if (pop(self, task)) {
+        task();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+      if (stop_ && pending_ == 0) return;
+    }
+  }
+
+  std::vector<Queue> queues_;         // a deque of tasks per worker
+  std::vector<std::thread> workers_;  // threads of the pool
+  std::atomic<std::size_t> pending_;  // tasks in the queues
+  std::mutex mutex_;                  // guards stop_ and the waits on wake_
+  std::condition_variable wake_;      // notified on new tasks and on stop
+  bool stop_;                         // set by the destructor
+};
+
+}  // namespace utils
+}  // namespace unialgo
+
+#endif  // UNIALGO_UTILS_THREAD_POOL_
@@ -1,160 +1,585 @@
 #include "unialgo/utils/waveletMatrix.hpp"
 
-#include <cmath>    // std::ceil
-#include <memory>   // std::shared_ptr
-#include <vector>   // std::vector
+#include <algorithm>        // std::min, std::clamp, std::copy_n, std::fill_n
+#include <cassert>          // assert
+#include <memory>           // std::shared_ptr
+#include <memory_resource>  // std::pmr::polymorphic_allocator
+#include <queue>            // std::priority_queue
+#include <thread>           // std::thread
+#include <utility>          // std::swap, std::move, std::pair
+#include <vector>           // std::vector
 
 namespace unialgo {
 namespace utils {
 
-WaveletMatrix::WaveletMatrix(const utils::WordVector& string)
-    : string_size_(string.size()) {
+namespace {
+/**
+ * @brief Runs f(t) for t in [0, threads), on threads - 1 new threads and the
+ * caller
+ */
+template <typename F>
+void run_threads(std::size_t threads, F f) {
+  std::vector<std::thread> workers;
+  for (std::size_t t = 1; t < threads; ++t) workers.emplace_back(f, t);
+  f(0);
+  for (auto& worker : workers) worker.join();
+}
+
+/**
+ * @brief Buffered writer of the values [start, end) of a packed vector that
+ * other threads write around
+ *
+ * Values falling in words inside [start, end) are encoded a block at a
+ * time, the ones in the first and last word (shared with the ranges next to
+ * it) go to edges and are written once the threads joined
+ */
+class RangeWriter {
+ public:
+  static constexpr std::size_t block = 256;  // values encoded at a time
+
+  RangeWriter(WordVector& out, std::size_t start, std::size_t end,
+              std::vector<std::pair<std::size_t, uint64_t>>& edges)
+      : out_(out), pos_(start), edges_(edges) {
+    const std::size_t word_size = out.getWordSize();
+    const std::size_t type_size = WordVector::type_size;
+    // first value starting after the first word, last ending in the last
+    std::size_t first_word = (start * word_size + type_size - 1) / type_size;
+    own_begin_ = (first_word * type_size + word_size - 1) / word_size;
+    own_end_ = end * word_size / type_size * type_size / word_size;
+  }
+
+  ~RangeWriter() { flush(); }
+
+  void push_back(uint64_t value) {
+    buffer_[count_++] = value;
+    if (count_ == block) flush();
+  }
+
+ private:
+  void flush() {
+    const std::size_t end = pos_ + count_;
+    std::size_t lo = std::clamp(own_begin_, pos_, end);
+    std::size_t hi = std::clamp(own_end_, lo, end);
+    for (std::size_t i = pos_; i < lo; ++i)
+      edges_.emplace_back(i, buffer_[i - pos_]);
+    out_.encode(lo, buffer_ + (lo - pos_), hi - lo);
+    for (std::size_t i = hi; i < end; ++i)
+      edges_.emplace_back(i, buffer_[i - pos_]);
+    pos_ = end;
+    count_ = 0;
+  }
+
+  WordVector& out_;
+  std::size_t pos_;        // position of buffer_[0]
+  std::size_t own_begin_;  // values in [own_begin_, own_end_) are encoded
+  std::size_t own_end_;
+  std::vector<std::pair<std::size_t, uint64_t>>& edges_;
+  uint64_t buffer_[block];
+  std::size_t count_ = 0;
+};
+}  // namespace
+
+template <typename RankSupport>
+BasicWaveletMatrix<RankSupport>::BasicWaveletMatrix(
+    const utils::WordVector& string, std::pmr::memory_resource* resource,
+    std::size_t num_threads)
+    : string_size_(string.size()), levels_(resource), helpers_(resource) {
   // matrix_depth_ = len_alphabet, assume len alphabet is wordSize
   matrix_depth_ = string.getWordSize();
-
-  matrix_ = unialgo::utils::Bitvector(string.size() * matrix_depth_);
+  // a count of 0s is at most n (at least a bit for strings of 0 or 1 values)
   Zs_ = WordVector(matrix_depth_,
-                   std::ceil(std::log(string.size()) / std::log(2)));
+                   std::max<std::size_t>(1, get_log_2(string.size() + 1)),
+                   resource);
+
+  const std::size_t n = string_size_;
+  const std::size_t type_size = Bitvector::type_size;
+  const std::size_t num_words = (n + type_size - 1) / type_size;
+
+  // values in the order of the current layer and of the next one, packed
+  // as the string (blocks are decoded and encoded when needed)
+  WordVector order = string;
+  WordVector next(n, matrix_depth_);
 
-  utils::WordVector::Type bit_to_check = 1 << (matrix_depth_ - 1);
-  utils::WordVector layer_order = string;
+  // chunks are whole words of the level, threads never share a word
+  std::size_t threads = std::min(std::max<std::size_t>(1, num_threads),
+                                 std::max<std::size_t>(1, n / min_per_thread));
+  std::size_t chunk_words = (num_words + threads - 1) / threads;
+  std::vector<std::size_t> zeros(threads);  // # of 0s in every chunk
+  // values of next in words shared by two threads
+  std::vector<std::vector<std::pair<std::size_t, uint64_t>>> edges(threads);
 
+  levels_.reserve(matrix_depth_);
   for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
-    utils::WordVector backet(string.size(), string.getWordSize());
-    std::size_t zero_count = 0;
+    const uint8_t shift = matrix_depth_ - 1 - layer;
+    // bits of the layer, word k holds the bits of values [64k, 64k + 64)
+    // (scratch when the helpers keep their own copy: not on resource)
+    WordBuffer bits(num_words, RankSupport::stores_bits
+                                   ? std::pmr::get_default_resource()
+                                   : resource);
+    uint64_t* layer_bits = bits.data();
 
-    for (std::size_t i = 0; i < string.size(); ++i) {
-      if (layer_order[i].getValue() & bit_to_check) {
-        matrix_[i + string.size() * layer] = 1;
-        backet[string.size() - 1 - (i - zero_count)] = layer_order[i];
-      } else {
-        backet[zero_count] = layer_order[i];
-        ++zero_count;
+    // pack the bits of the layer and count the 0s of every chunk
+    run_threads(threads, [&](std::size_t t) {
+      std::size_t w_end = std::min(num_words, (t + 1) * chunk_words);
+      std::size_t ones = 0;
+      uint64_t values[type_size];
+      for (std::size_t w = t * chunk_words; w < w_end; ++w) {
+        std::size_t begin = w * type_size;
+        std::size_t end = std::min(n, begin + type_size);
+        order.decode(begin, end - begin, values);
+        uint64_t word = 0;
+        for (std::size_t i = 0; i < end - begin; ++i)
+          word |= ((values[i] >> shift) & 1) << i;
+        layer_bits[w] = word;
+        ones += __builtin_popcountll(word);
       }
-    }
+      std::size_t begin = std::min(n, t * chunk_words * type_size);
+      std::size_t end = std::min(n, w_end * type_size);
+      zeros[t] = end - begin - ones;
+    });
+
+    std::size_t zero_count = 0;
+    for (std::size_t z : zeros) zero_count += z;
     // store the zero_count of layer
     Zs_[layer] = zero_count;
-    // reverse the 1s in backet
-    for (std::size_t i = zero_count;
-         i < (string.size() - zero_count) / 2 + zero_count; ++i) {
-      auto a = backet[i].getValue();
-      backet[i] = backet[string.size() - 1 - (i - zero_count)];
-      backet[string.size() - 1 - (i - zero_count)] = a;
-    }
-    layer_order = backet;
 
-    bit_to_check = bit_to_check >> 1;
+    if (layer + 1 < matrix_depth_) {
+      // stable partition: 0s of chunk t go after the 0s of the chunks
+      // before, 1s after every 0 and the 1s of the chunks before
+      run_threads(threads, [&](std::size_t t) {
+        std::size_t begin = std::min(n, t * chunk_words * type_size);
+        std::size_t end = std::min(n, (t + 1) * chunk_words * type_size);
+        std::size_t zero_pos = 0;
+        for (std::size_t c = 0; c < t; ++c) zero_pos += zeros[c];
+        std::size_t one_pos = zero_count + begin - zero_pos;
+        RangeWriter zeros_out(next, zero_pos, zero_pos + zeros[t], edges[t]);
+        RangeWriter ones_out(next, one_pos, one_pos + end - begin - zeros[t],
+                             edges[t]);
+        uint64_t values[type_size];
+        for (std::size_t i = begin; i < end; i += type_size) {
+          std::size_t count = std::min(type_size, end - i);
+          order.decode(i, count, values);
+          uint64_t word = layer_bits[i / type_size];
+          for (std::size_t j = 0; j < count; ++j) {
+            if (word & bit_set[j])
+              ones_out.push_back(values[j]);
+            else
+              zeros_out.push_back(values[j]);
+          }
+        }
+      });
+      for (auto& thread_edges : edges) {
+        for (auto [pos, value] : thread_edges) next.encode(pos, &value, 1);
+        thread_edges.clear();
+      }
+      std::swap(order, next);
+    }
+    levels_.emplace_back(std::move(bits), n);
   }
-
-  initHelper();
-
-  level_offsets_.resize(matrix_depth_);
-  for (std::size_t l = 0; l < matrix_depth_; ++l)
-    level_offsets_[l] = l * string_size_;
+  initHelpers(num_threads);
 }
 
-void WaveletMatrix::initHelper() {
-  // Skip RankHelper construction for moved-from or empty bitvectors
+template <typename RankSupport>
+void BasicWaveletMatrix<RankSupport>::initHelpers(std::size_t num_threads) {
+  helpers_.clear();
+  // Skip RankHelper construction for empty strings
   // (RankHelper's constructor uses log(size) which is undefined for size=0)
-  if (matrix_.size() == 0) return;
-  helper_ = utils::RankHelper(
-      std::shared_ptr<utils::Bitvector>(&matrix_, [](utils::Bitvector*) {}));
+  if (string_size_ == 0) return;
+  helpers_.reserve(levels_.size());
+  std::pmr::memory_resource* resource = helpers_.get_allocator().resource();
+  for (auto& level : levels_) {
+    // the control block of the (non owning) pointer to the level lives as
+    // long as the level bits, on their resource; helpers go on the matrix's
+    std::shared_ptr<utils::Bitvector> bits(
+        &level, [](utils::Bitvector*) {},
+        std::pmr::polymorphic_allocator<utils::Bitvector>(
+            level.getResource()));
+    helpers_.emplace_back(bits, num_threads, resource);
+    // helpers keeping their own copy of the bits make the level redundant
+    if constexpr (RankSupport::stores_bits) level = utils::Bitvector();
+  }
 }
 
-WaveletMatrix::WaveletMatrix(const WaveletMatrix& other)
-    : string_size_(other.string_size_),
-      matrix_depth_(other.matrix_depth_),
-      matrix_(other.matrix_),
-      Zs_(other.Zs_),
-      level_offsets_(other.level_offsets_) {
-  initHelper();
+template <typename RankSupport>
+void BasicWaveletMatrix<RankSupport>::initHelpers(
+    const BasicWaveletMatrix& other) {
+  if constexpr (RankSupport::stores_bits)
+    helpers_ = other.helpers_;
+  else
+    initHelpers();
 }
 
-WaveletMatrix::WaveletMatrix(WaveletMatrix&& other) noexcept
+template <typename RankSupport>
+BasicWaveletMatrix<RankSupport>::BasicWaveletMatrix(
+    const BasicWaveletMatrix& other)
     : string_size_(other.string_size_),
       matrix_depth_(other.matrix_depth_),
-      matrix_(std::move(other.matrix_)),
-      Zs_(std::move(other.Zs_)),
-      level_offsets_(std::move(other.level_offsets_)) {
-  initHelper();
+      levels_(other.levels_),
+      Zs_(other.Zs_) {
+  initHelpers(other);
 }
 
-WaveletMatrix& WaveletMatrix::operator=(const WaveletMatrix& other) {
+template <typename RankSupport>
+BasicWaveletMatrix<RankSupport>& BasicWaveletMatrix<RankSupport>::operator=(
+    const BasicWaveletMatrix& other) {
   if (this != &other) {
     string_size_ = other.string_size_;
     matrix_depth_ = other.matrix_depth_;
-    matrix_ = other.matrix_;
+    levels_ = other.levels_;
     Zs_ = other.Zs_;
-    level_offsets_ = other.level_offsets_;
-    initHelper();
+    initHelpers(other);
   }
   return *this;
 }
 
-WaveletMatrix& WaveletMatrix::operator=(WaveletMatrix&& other) noexcept {
+template <typename RankSupport>
+BasicWaveletMatrix<RankSupport>& BasicWaveletMatrix<RankSupport>::operator=(
+    BasicWaveletMatrix&& other) {
   if (this != &other) {
+    // levels on another resource are moved one by one: the helpers pointing
+    // to other's levels have to be rebuilt
+    bool rebuild = !RankSupport::stores_bits &&
+                   levels_.get_allocator() != other.levels_.get_allocator();
     string_size_ = other.string_size_;
     matrix_depth_ = other.matrix_depth_;
-    matrix_ = std::move(other.matrix_);
+    levels_ = std::move(other.levels_);
     Zs_ = std::move(other.Zs_);
-    level_offsets_ = std::move(other.level_offsets_);
-    initHelper();
+    if (rebuild) {
+      initHelpers();
+      other.helpers_.clear();
+    } else {
+      helpers_ = std::move(other.helpers_);
+    }
   }
   return *this;
 }
 
-std::size_t WaveletMatrix::getMatrixDepth() const { return matrix_depth_; }
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::getMatrixDepth() const {
+  return matrix_depth_;
+}
 
-std::size_t WaveletMatrix::getStringSize() const { return string_size_; }
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::getStringSize() const {
+  return string_size_;
+}
+
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::GetSizeInBits() const
+  requires requires(const RankSupport& helper) { helper.GetSizeInBits(); }
+{
+  std::size_t res = Zs_.getNumBits();
+  for (const auto& helper : helpers_) res += helper.GetSizeInBits();
+  return res;
+}
 
-uint64_t WaveletMatrix::acces(std::size_t indx) const {
+template <typename RankSupport>
+uint64_t BasicWaveletMatrix<RankSupport>::acces(std::size_t indx) const {
   uint64_t res = 0;
-  uint64_t bit_to_set = 1 << (matrix_depth_ - 1);
+  uint64_t bit_to_set = uint64_t{1} << (matrix_depth_ - 1);
   std::size_t pos = indx;  // this is relative to layers and not bv
 
   for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
-    std::size_t lo = level_offsets_[layer];
-    bool value = matrix_[pos + lo].getValue();
+    const RankSupport& helper = helpers_[layer];
+    bool value = helper.GetBit(pos);
 
     // conditionaly set or clear bit (bit hacks)
     res ^= (-value ^ res) & bit_to_set;
     // if value = 1 need to add to position count of 0s in layer
     // to get position of 1 in next layer need to skip all the 0s
-    pos = helper_.rank(lo, pos + lo, value) + Zs_[layer] * value - 1;
+    pos = helper.rank(pos, value) + Zs_[layer] * value - 1;
     bit_to_set = bit_to_set >> 1;
   }
   return res;
 }
 
-std::size_t WaveletMatrix::rank(const uint64_t character, std::size_t i) const {
-  uint64_t bit_to_set = 1 << (matrix_depth_ - 1);
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::rank(const uint64_t character,
+                                                  std::size_t i) const {
+  uint64_t bit_to_set = uint64_t{1} << (matrix_depth_ - 1);
   std::size_t p = 0;
-  std::size_t layer_start;
   for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
     bool bit_value = character & bit_to_set;  // bit value of char at level
-    layer_start = level_offsets_[layer];  // position in bv of first bit in layer
+    const RankSupport& helper = helpers_[layer];
     // if p == 0 can't do p - 1
-    if (p > 0) p = helper_.rank(layer_start, p - 1 + layer_start, bit_value);
+    if (p > 0) p = helper.rank(p - 1, bit_value);
     p += (Zs_[layer] * bit_value);
-    i = helper_.rank(layer_start, i + layer_start, bit_value) +
-        (Zs_[layer] * bit_value) - 1;
+    i = helper.rank(i, bit_value) + (Zs_[layer] * bit_value) - 1;
     if (i + 1 - p == 0) return 0;  // check for overflow of i
     bit_to_set = bit_to_set >> 1;
   }
   return i - p + 1;
 }
 
-std::size_t WaveletMatrix::rank(
+template <typename RankSupport>
+void BasicWaveletMatrix<RankSupport>::prefetch(std::size_t layer,
+                                               std::size_t indx) const {
+  if constexpr (requires(const RankSupport& helper, std::size_t i) {
+                  helper.prefetch(i);
+                })
+    helpers_[layer].prefetch(indx);
+}
+
+template <typename RankSupport>
+void BasicWaveletMatrix<RankSupport>::access_batch(const std::size_t* pos,
+                                                   std::size_t n,
+                                                   uint64_t* out) const {
+  std::size_t current[batch_size];  // position of the queries in the layer
+  for (std::size_t b = 0; b < n; b += batch_size) {
+    std::size_t m = std::min(batch_size, n - b);
+    std::copy_n(pos + b, m, current);
+    std::fill_n(out + b, m, 0);
+    uint64_t bit_to_set = uint64_t{1} << (matrix_depth_ - 1);
+    for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+      const RankSupport& helper = helpers_[layer];
+      std::size_t zeros = Zs_[layer];
+      // every query of the batch starts loading before any is answered
+      for (std::size_t q = 0; q < m; ++q) prefetch(layer, current[q]);
+      for (std::size_t q = 0; q < m; ++q) {
+        bool value = helper.GetBit(current[q]);
+        out[b + q] |= bit_to_set * value;
+        current[q] = helper.rank(current[q], value) + zeros * value - 1;
+      }
+      bit_to_set = bit_to_set >> 1;
+    }
+  }
+}
+
+template <typename RankSupport>
+void BasicWaveletMatrix<RankSupport>::rank_batch(const uint64_t* chars,
+                                                 const std::size_t* pos,
+                                                 std::size_t n,
+                                                 std::size_t* out) const {
+  // same steps of rank, p and i of every query of the batch
+  std::size_t p[batch_size];
+  std::size_t i[batch_size];
+  bool done[batch_size];  // query with no occurrences (answer 0)
+  for (std::size_t b = 0; b < n; b += batch_size) {
+    std::size_t m = std::min(batch_size, n - b);
+    std::fill_n(p, m, 0);
+    std::copy_n(pos + b, m, i);
+    std::fill_n(done, m, false);
+    uint64_t bit_to_set = uint64_t{1} << (matrix_depth_ - 1);
+    for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+      const RankSupport& helper = helpers_[layer];
+      std::size_t zeros = Zs_[layer];
+      for (std::size_t q = 0; q < m; ++q) {
+        if (done[q]) continue;
+        if (p[q] > 0) prefetch(layer, p[q] - 1);
+        prefetch(layer, i[q]);
+      }
+      for (std::size_t q = 0; q < m; ++q) {
+        if (done[q]) continue;
+        bool bit_value = chars[b + q] & bit_to_set;
+        if (p[q] > 0) p[q] = helper.rank(p[q] - 1, bit_value);
+        p[q] += zeros * bit_value;
+        i[q] = helper.rank(i[q], bit_value) + zeros * bit_value - 1;
+        done[q] = i[q] + 1 - p[q] == 0;
+      }
+      bit_to_set = bit_to_set >> 1;
+    }
+    for (std::size_t q = 0; q < m; ++q)
+      out[b + q] = done[q] ? 0 : i[q] - p[q] + 1;
+  }
+}
+
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::rankZeros(std::size_t layer,
+                                                       std::size_t pos) const {
+  if (pos == 0) return 0;
+  return helpers_[layer].rank(pos - 1, false);
+}
+
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::select(const uint64_t character,
+                                                    std::size_t count) const {
+  if (string_size_ == 0 || count == 0) return -1;
+  if (matrix_depth_ < 64 && (character >> matrix_depth_)) return -1;
+
+  // [start, end) = positions of the values equal to character below layer
+  std::size_t start = 0;
+  std::size_t end = string_size_;
+  for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+    bool bit = (character >> (matrix_depth_ - 1 - layer)) & 1;
+    std::size_t zeros_start = rankZeros(layer, start);
+    std::size_t zeros_end = rankZeros(layer, end);
+    std::size_t zeros = Zs_[layer];
+    start = bit ? zeros + start - zeros_start : zeros_start;
+    end = bit ? zeros + end - zeros_end : zeros_end;
+  }
+  if (end - start < count) return -1;
+
+  // back up: the position in a layer is the select of the bit that moved it
+  std::size_t pos = start + count - 1;
+  for (std::size_t layer = matrix_depth_; layer-- > 0;) {
+    bool bit = (character >> (matrix_depth_ - 1 - layer)) & 1;
+    std::size_t nth = bit ? pos - Zs_[layer] : pos;  // among bits of layer
+    pos = helpers_[layer].select(nth + 1, bit);
+  }
+  return pos;
+}
+
+template <typename RankSupport>
+uint64_t BasicWaveletMatrix<RankSupport>::quantile(std::size_t start,
+                                                   std::size_t end,
+                                                   std::size_t k) const {
+  assert(start <= end && end < string_size_ && k <= end - start &&
+         "quantile out of range");
+  std::size_t s = start;
+  std::size_t e = end + 1;
+  uint64_t res = 0;
+  for (std::size_t layer = 0; layer < matrix_depth_; ++layer) {
+    std::size_t zeros_start = rankZeros(layer, s);
+    std::size_t zeros_end = rankZeros(layer, e);
+    std::size_t zeros = zeros_end - zeros_start;
+    if (k < zeros) {
+      s = zeros_start;
+      e = zeros_end;
+    } else {
+      // the value is among the 1s: skip the smaller values of the 0s
+      k -= zeros;
+      res |= uint64_t{1} << (matrix_depth_ - 1 - layer);
+      std::size_t layer_zeros = Zs_[layer];
+      s = layer_zeros + s - zeros_start;
+      e = layer_zeros + e - zeros_end;
+    }
+  }
+  return res;
+}
+
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::countLess(std::size_t start,
+                                                       std::size_t end,
+                                                       uint64_t value) const {
+  if (matrix_depth_ < 64 && (value >> matrix_depth_)) return end - start;
+  std::size_t res = 0;
+  for (std::size_t layer = 0; layer < matrix_depth_ && start < end; ++layer) {
+    bool bit = (value >> (matrix_depth_ - 1 - layer)) & 1;
+    std::size_t zeros_start = rankZeros(layer, start);
+    std::size_t zeros_end = rankZeros(layer, end);
+    if (bit) {
+      // values with a 0 here are smaller
+      res += zeros_end - zeros_start;
+      std::size_t zeros = Zs_[layer];
+      start = zeros + start - zeros_start;
+      end = zeros + end - zeros_end;
+    } else {
+      start = zeros_start;
+      end = zeros_end;
+    }
+  }
+  return res;
+}
+
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::range_freq(std::size_t start,
+                                                        std::size_t end,
+                                                        uint64_t low,
+                                                        uint64_t high) const {
+  if (start > end || low > high) return 0;
+  std::size_t up_to_high = high + 1 == 0 ? end + 1 - start
+                                         : countLess(start, end + 1, high + 1);
+  return up_to_high - countLess(start, end + 1, low);
+}
+
+template <typename RankSupport>
+std::vector<typename BasicWaveletMatrix<RankSupport>::ValueCount>
+BasicWaveletMatrix<RankSupport>::top_k(std::size_t start, std::size_t end,
+                                       std::size_t k) const {
+  std::vector<ValueCount> res;
+  if (start > end || k == 0) return res;
+
+  // node of the levels: positions [start, end) below layer - 1, value has
+  // the bits of the first layer levels set
+  struct Node {
+    std::size_t count;
+    std::size_t layer;
+    std::size_t start;
+    std::size_t end;
+    uint64_t value;
+  };
+  auto less = [](const Node& a, const Node& b) {
+    return a.count != b.count ? a.count < b.count : a.value > b.value;
+  };
+  std::priority_queue<Node, std::vector<Node>, decltype(less)> queue(less);
+  queue.push({end + 1 - start, 0, start, end + 1, 0});
+  while (!queue.empty() && res.size() < k) {
+    Node node = queue.top();
+    queue.pop();
+    if (node.layer == matrix_depth_) {
+      res.emplace_back(node.value, node.count);
+      continue;
+    }
+    std::size_t zeros_start = rankZeros(node.layer, node.start);
+    std::size_t zeros_end = rankZeros(node.layer, node.end);
+    std::size_t zeros = zeros_end - zeros_start;
+    std::size_t layer_zeros = Zs_[node.layer];
+    if (zeros)
+      queue.push({zeros, node.layer + 1, zeros_start, zeros_end, node.value});
+    if (node.count > zeros)
+      queue.push({node.count - zeros, node.layer + 1,
+                  layer_zeros + node.start - zeros_start,
+                  layer_zeros + node.end - zeros_end,
+                  node.value |
+                      uint64_t{1} << (matrix_depth_ - 1 - node.layer)});
+  }
+  return res;
+}
+
+template <typename RankSupport>
+void BasicWaveletMatrix<RankSupport>::rangeList(
+    std::size_t layer, std::size_t start, std::size_t end, uint64_t value,
+    uint64_t low, uint64_t high, std::vector<ValueCount>& out) const {
+  if (start == end) return;
+  if (layer == matrix_depth_) {
+    out.emplace_back(value, end - start);
+    return;
+  }
+  // the 0s hold [value, value | bit), the 1s hold values from value | bit
+  uint64_t bit = uint64_t{1} << (matrix_depth_ - 1 - layer);
+  std::size_t zeros_start = rankZeros(layer, start);
+  std::size_t zeros_end = rankZeros(layer, end);
+  if (low < (value | bit))
+    rangeList(layer + 1, zeros_start, zeros_end, value, low, high, out);
+  if (high >= (value | bit)) {
+    std::size_t zeros = Zs_[layer];
+    rangeList(layer + 1, zeros + start - zeros_start, zeros + end - zeros_end,
+              value | bit, low, high, out);
+  }
+}
+
+template <typename RankSupport>
+std::vector<typename BasicWaveletMatrix<RankSupport>::ValueCount>
+BasicWaveletMatrix<RankSupport>::range_list(std::size_t start,
+                                            std::size_t end, uint64_t low,
+                                            uint64_t high) const {
+  std::vector<ValueCount> res;
+  if (start > end || low > high) return res;
+  if (matrix_depth_ < 64 && (low >> matrix_depth_)) return res;
+  rangeList(0, start, end + 1, 0, low, high, res);
+  return res;
+}
+
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::rank(
     const unialgo::utils::WordVectorConstReference character,
     std::size_t pos) const {
   return rank(character.getValue(), pos);
 }
 
-std::size_t WaveletMatrix::rank(
+template <typename RankSupport>
+std::size_t BasicWaveletMatrix<RankSupport>::rank(
     const unialgo::utils::WordVectorReference character,
     std::size_t pos) const {
   return rank(character.getValue(), pos);
 }
 
+// instantiations for the available rank helpers
+template class BasicWaveletMatrix<utils::RankHelper>;
+template class BasicWaveletMatrix<utils::InterleavedRankHelper>;
+template class BasicWaveletMatrix<utils::RRRBitvector>;
+template class BasicWaveletMatrix<utils::EliasFanoBitvector>;
+template class BasicWaveletMatrix<utils::HybridBitvector>;
+
 }  // namespace utils
 }  // namespace unialgo
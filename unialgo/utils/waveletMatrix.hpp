@@ -1,27 +1,81 @@
 #ifndef UNIALGO_UTILS_WAVELET_MATRIX_
 #define UNIALGO_UTILS_WAVELET_MATRIX_
 
-#include <vector>  // std::vector
+#include <memory>           // std::shared_ptr
+#include <memory_resource>  // std::pmr::memory_resource
+#include <type_traits>      // std::is_constructible_v
+#include <utility>          // std::pair
+#include <vector>           // std::vector, std::pmr::vector
 
 #include "unialgo/utils/bitvector/bitvector.hpp"
+#include "unialgo/utils/bitvector/eliasFano.hpp"
+#include "unialgo/utils/bitvector/hybridBitvector.hpp"
 #include "unialgo/utils/bitvector/rankHelper.hpp"
+#include "unialgo/utils/bitvector/rankInterleaved.hpp"
+#include "unialgo/utils/bitvector/rrrBitvector.hpp"
 #include "unialgo/utils/bitvector/wordVector.hpp"
 
 namespace unialgo {
 namespace utils {
 
-class WaveletMatrix {
+/**
+ * @brief Wavelet matrix over a WordVector
+ *
+ * Every level is a bitvector of its own with its rank support, so a
+ * compressed support encodes every level on its own statistics
+ *
+ * @tparam RankSupport rank/select structure built on the bits of a level
+ * (utils::RankHelper, utils::InterleavedRankHelper, utils::RRRBitvector,
+ * utils::EliasFanoBitvector, utils::HybridBitvector). It has to be
+ * constructible from (std::shared_ptr<Bitvector>, # of threads, memory
+ * resource) and expose rank, GetBit and the constant stores_bits (true if it
+ * keeps its own copy of the bits)
+ */
+template <typename RankSupport>
+class BasicWaveletMatrix {
+  // the rank support goes on the resource of the matrix, never on the heap
+  static_assert(std::is_constructible_v<RankSupport,
+                                        std::shared_ptr<utils::Bitvector>,
+                                        std::size_t,
+                                        std::pmr::memory_resource*>,
+                "RankSupport must take the memory resource of the levels");
+
  public:
-  WaveletMatrix() = default;
-  WaveletMatrix(const unialgo::utils::WordVector& string);
+  static constexpr std::size_t batch_size = 64;  // queries in flight in batches
+  static constexpr std::size_t min_per_thread =
+      1 << 16;  // values for a construction thread
+
+  BasicWaveletMatrix() : string_size_(0), matrix_depth_(0) {}
+
+  /**
+   * @brief Construct a new Basic Wavelet Matrix object
+   *
+   * Every level is a stable partition of the values by their bit (0s then
+   * 1s) from one buffer to the other, both packed with the word size of the
+   * string and decoded a block at a time, the bits of a level are packed a
+   * word at a time. With num_threads > 1 a level is split in
+   * chunks: every thread packs the bits of its chunk and counts its 0s,
+   * the prefix sums of the counts give where each chunk writes its values
+   *
+   * @param string string to index
+   * @param resource memory resource of the matrix bits and rank support
+   * (e.g. an utils::Arena backing many small indexes)
+   * @param num_threads max number of threads used to build the levels and
+   * the rank support
+   */
+  BasicWaveletMatrix(
+      const unialgo::utils::WordVector& string,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+      std::size_t num_threads = 1);
 
-  ~WaveletMatrix() = default;
+  ~BasicWaveletMatrix() = default;
 
-  WaveletMatrix(const WaveletMatrix& other);
-  WaveletMatrix(WaveletMatrix&& other) noexcept;
+  BasicWaveletMatrix(const BasicWaveletMatrix& other);
+  // the levels keep their address, so do the helpers pointing to them
+  BasicWaveletMatrix(BasicWaveletMatrix&& other) noexcept = default;
 
-  WaveletMatrix& operator=(const WaveletMatrix& other);
-  WaveletMatrix& operator=(WaveletMatrix&& other) noexcept;
+  BasicWaveletMatrix& operator=(const BasicWaveletMatrix& other);
+  BasicWaveletMatrix& operator=(BasicWaveletMatrix&& other);
 
   /**
    * @brief Access value in string
@@ -50,19 +104,147 @@ class WaveletMatrix {
   std::size_t rank(const unialgo::utils::WordVectorReference character,
                    std::size_t pos) const;
 
+  /**
+   * @brief Access many values, out[i] = acces(pos[i])
+   *
+   * Queries go down the matrix batch_size at a time and level by level: the
+   * bits and rank entries of every query of a level are prefetched before
+   * the first of them is answered, so batch_size independent cache misses
+   * are in flight instead of one
+   *
+   * @param pos indexes to access
+   * @param n number of queries
+   * @param out values at pos[i]
+   */
+  void access_batch(const std::size_t* pos, std::size_t n,
+                    uint64_t* out) const;
+
+  /**
+   * @brief Rank of many characters, out[i] = rank(chars[i], pos[i])
+   *
+   * Same level by level interleaving of access_batch
+   *
+   * @param chars characters to count occurrences
+   * @param pos positions to end count (included)
+   * @param n number of queries
+   * @param out # of occ of chars[i] in [0, pos[i]]
+   */
+  void rank_batch(const uint64_t* chars, const std::size_t* pos,
+                  std::size_t n, std::size_t* out) const;
+
+  /**
+   * @brief Position of the count-th occurrence of character
+   *
+   * Goes down the levels to the start of the values equal to character,
+   * then back up with a select per level. O(matrix_depth) selects
+   *
+   * @param character character to search
+   * @param count i-th occurrence searched (starting from 1)
+   * @return std::size_t position of the occurrence, -1 if not present
+   */
+  std::size_t select(const uint64_t character, std::size_t count) const;
+
+  /**
+   * @brief k-th smallest value in string[start, end]
+   *
+   * @param start first position of the range
+   * @param end last position of the range (included)
+   * @param k rank of the value (0 = minimum, must be <= end - start)
+   * @return uint64_t k-th smallest value
+   */
+  uint64_t quantile(std::size_t start, std::size_t end, std::size_t k) const;
+
+  /**
+   * @brief Number of values in [low, high] in string[start, end]
+   *
+   * @param start first position of the range
+   * @param end last position of the range (included)
+   * @param low smallest value counted
+   * @param high biggest value counted
+   * @return std::size_t # of positions i in [start, end] with
+   * low <= string[i] <= high
+   */
+  std::size_t range_freq(std::size_t start, std::size_t end, uint64_t low,
+                         uint64_t high) const;
+
+  using ValueCount = std::pair<uint64_t, std::size_t>;  // value, occurrences
+
+  /**
+   * @brief The k most frequent values in string[start, end]
+   *
+   * Best-first visit of the levels: the node with most values is split
+   * first, so the leaves come out by decreasing frequency
+   *
+   * @param start first position of the range
+   * @param end last position of the range (included)
+   * @param k number of values
+   * @return std::vector<ValueCount> (value, occurrences) by decreasing
+   * occurrences (smaller value first on ties), at most k
+   */
+  std::vector<ValueCount> top_k(std::size_t start, std::size_t end,
+                                std::size_t k) const;
+
+  /**
+   * @brief Distinct values in [low, high] of string[start, end] with their
+   * occurrences
+   *
+   * Visits only the nodes with values in the range, O(matrix_depth) per
+   * value reported
+   *
+   * @param start first position of the range
+   * @param end last position of the range (included)
+   * @param low smallest value reported
+   * @param high biggest value reported
+   * @return std::vector<ValueCount> (value, occurrences) by increasing value
+   */
+  std::vector<ValueCount> range_list(
+      std::size_t start, std::size_t end, uint64_t low = 0,
+      uint64_t high = static_cast<uint64_t>(-1)) const;
+
   std::size_t getStringSize() const;
   std::size_t getMatrixDepth() const;
 
+  /**
+   * @brief Memory used by the levels and their rank support (supports
+   * reporting their own size: compressed and interleaved ones)
+   *
+   * @return std::size_t # of bits used (compare with string size * depth)
+   */
+  std::size_t GetSizeInBits() const
+    requires requires(const RankSupport& helper) { helper.GetSizeInBits(); };
+
  private:
-  void initHelper();  // builds helper_ from matrix_
-
-  std::size_t string_size_;                 // size of the string
-  std::size_t matrix_depth_;                // depth of the matrix
-  unialgo::utils::Bitvector matrix_;        // bitvector for matrix_
-  unialgo::utils::RankHelper helper_;       // helper for constant rank on bv
-  unialgo::utils::WordVector Zs_;           // #0s in layerss
-  std::vector<std::size_t> level_offsets_;  // precomputed layer * string_size_
-};  // class WaveletMatrix
+  // builds helpers_ from levels_ (or copies other's)
+  void initHelpers(std::size_t num_threads = 1);
+  void initHelpers(const BasicWaveletMatrix& other);
+  // prefetch of the rank support of layer (if any)
+  void prefetch(std::size_t layer, std::size_t indx) const;
+  // # of 0s in the first pos bits of layer
+  std::size_t rankZeros(std::size_t layer, std::size_t pos) const;
+  // values < value in the positions [start, end) of the first layer
+  std::size_t countLess(std::size_t start, std::size_t end,
+                        uint64_t value) const;
+  void rangeList(std::size_t layer, std::size_t start, std::size_t end,
+                 uint64_t value, uint64_t low, uint64_t high,
+                 std::vector<ValueCount>& out) const;
+
+  std::size_t string_size_;                             // size of the string
+  std::size_t matrix_depth_;                            // depth of the matrix
+  std::pmr::vector<unialgo::utils::Bitvector> levels_;  // bits of the levels
+  std::pmr::vector<RankSupport> helpers_;               // their rank support
+  unialgo::utils::WordVector Zs_;                       // #0s in layerss
+};  // class BasicWaveletMatrix
+
+using WaveletMatrix = BasicWaveletMatrix<unialgo::utils::RankHelper>;
+using InterleavedWaveletMatrix =
+    BasicWaveletMatrix<unialgo::utils::InterleavedRankHelper>;
+// compressed matrix bits, for skewed strings (mostly 0s or 1s per level)
+using RRRWaveletMatrix = BasicWaveletMatrix<unialgo::utils::RRRBitvector>;
+using EliasFanoWaveletMatrix =
+    BasicWaveletMatrix<unialgo::utils::EliasFanoBitvector>;
+// every level in the smallest of plain, RRR and Elias-Fano
+using HybridWaveletMatrix =
+    BasicWaveletMatrix<unialgo::utils::HybridBitvector>;
 
 }  // namespace utils
 